@@ -0,0 +1,104 @@
+﻿#pragma once
+#ifndef JSONWRITERBENCH_H
+#define JSONWRITERBENCH_H
+
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Fichier : JsonWriterBench.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/07
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe JsonWriterBench
+//
+// Petit écrivain JSON utilisé par les bancs d'essai. Il ne gère que ce dont
+// on a besoin : objets, tableaux, chaînes, nombres et booléens. Les virgules
+// sont insérées automatiquement.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class JsonWriterBench
+{
+public:
+	explicit JsonWriterBench(std::ostream& out) : mOut{ out } {}
+
+	JsonWriterBench& beginObject() { separate(); mOut << '{'; mFirst.push_back(true); return *this; }
+	JsonWriterBench& endObject() { mFirst.pop_back(); mOut << '}'; return *this; }
+	JsonWriterBench& beginArray() { separate(); mOut << '['; mFirst.push_back(true); return *this; }
+	JsonWriterBench& endArray() { mFirst.pop_back(); mOut << ']'; return *this; }
+
+	JsonWriterBench& key(std::string const& name)
+	{
+		separate();
+		writeString(name);
+		mOut << ':';
+		mAfterKey = true;
+		return *this;
+	}
+
+	JsonWriterBench& value(std::string const& text) { separate(); writeString(text); return *this; }
+	JsonWriterBench& value(const char* text) { return value(std::string(text)); }
+	JsonWriterBench& value(bool flag) { separate(); mOut << (flag ? "true" : "false"); return *this; }
+	JsonWriterBench& value(double number)
+	{
+		separate();
+		if (std::isfinite(number))
+			mOut << number;
+		else
+			mOut << "null";
+		return *this;
+	}
+	JsonWriterBench& value(uint64_t number) { separate(); mOut << number; return *this; }
+	JsonWriterBench& value(int64_t number) { separate(); mOut << number; return *this; }
+	JsonWriterBench& value(uint32_t number) { return value(static_cast<uint64_t>(number)); }
+	JsonWriterBench& value(int number) { return value(static_cast<int64_t>(number)); }
+
+	template <typename T>
+	JsonWriterBench& field(std::string const& name, T const& v) { key(name); return value(v); }
+
+private:
+	std::ostream& mOut;
+	std::vector<bool> mFirst;
+	bool mAfterKey{};
+
+	// Virgule entre deux éléments, sauf juste après une clé.
+	void separate()
+	{
+		if (mAfterKey) {
+			mAfterKey = false;
+			return;
+		}
+		if (!mFirst.empty()) {
+			if (!mFirst.back())
+				mOut << ',';
+			mFirst.back() = false;
+		}
+	}
+
+	void writeString(std::string const& text)
+	{
+		mOut << '"';
+		for (char c : text) {
+			switch (c) {
+			case '"': mOut << "\\\""; break;
+			case '\\': mOut << "\\\\"; break;
+			case '\n': mOut << "\\n"; break;
+			case '\t': mOut << "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					const char* hex{ "0123456789abcdef" };
+					mOut << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+				}
+				else
+					mOut << c;
+			}
+		}
+		mOut << '"';
+	}
+};
+
+#endif // JSONWRITERBENCH_H
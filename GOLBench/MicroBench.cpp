@@ -0,0 +1,293 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "GOLTeamH.h"
+#include "GridTeamH.h"
+#include "JsonWriterBench.h"
+#include "PatternsBench.h"
+#include "PerfCountersTeamH.h"
+
+// Fichier : MicroBench.cpp (GOLMicroBench)
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/08
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Microbancs d'essai des fonctions critiques de GOLTeamH.
+//
+// Chaque noyau est mesuré isolément sur des entrées fixes : il est appelé en
+// boucle assez longtemps pour un échantillon (~5 ms), puis l'échantillon est
+// répété. On rapporte le min, la médiane, la moyenne, l'écart type et le
+// 90e centile du temps par appel, ainsi que les compteurs matériels par
+// appel lorsqu'ils sont disponibles.
+//
+// Exemple :
+//   GOLMicroBench --size 1024 --repetitions 20 --filter border --output micro.json
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+// Accès aux membres privés de GOLTeamH (déclaré ami dans GOLTeamH.h).
+struct KernelAccessTeamH
+{
+	static GridTeamH& grid(GOLTeamH& gol) { return gol.mData; }
+	static size_t processRows(GOLTeamH& gol, size_t begin, size_t end) { return gol.processRows(begin, end).aliveCount; }
+	static void modifyBorderIfNecessary(GOLTeamH& gol) { gol.modifyBorderIfNecessary(); }
+	static size_t countNeighbors(GOLTeamH& gol, size_t column, size_t row) { return gol.countNeighbors(column, row); }
+	static void countLifeStatusCells(GOLTeamH& gol) { gol.countLifeStatusCells(); }
+	static bool parsePattern(GOLTeamH& gol, std::string const& pattern) { return gol.parsePattern(pattern).has_value(); }
+};
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct Options {
+		size_t size{ 1024 };
+		size_t repetitions{ 15 };
+		double sampleSeconds{ 0.005 };
+		std::string filter;
+		std::string output;
+	};
+
+	struct Kernel {
+		std::string name;
+		size_t cellsPerCall;	// 0 si la notion de cellule ne s'applique pas
+		std::function<void()> call;
+	};
+
+	struct Summary {
+		double minNs, medianNs, meanNs, stddevNs, p90Ns, maxNs;
+		size_t callsPerSample;
+		PerfCountersTeamH::Sample counters; // Total sur tous les échantillons
+	};
+
+	double percentile(std::vector<double> sorted, double p)
+	{
+		if (sorted.empty())
+			return 0.0;
+		double const rank{ p * (sorted.size() - 1) };
+		size_t const low{ static_cast<size_t>(rank) };
+		size_t const high{ std::min(low + 1, sorted.size() - 1) };
+		return sorted[low] + (sorted[high] - sorted[low]) * (rank - low);
+	}
+
+	Summary measure(Kernel const& kernel, Options const& options, PerfCountersTeamH const& counters)
+	{
+		// Calibration : nombre d'appels pour remplir un échantillon.
+		size_t calls{ 1 };
+		while (true) {
+			auto const start{ Clock::now() };
+			for (size_t i{}; i < calls; ++i)
+				kernel.call();
+			std::chrono::duration<double> elapsed{ Clock::now() - start };
+			if (elapsed.count() >= options.sampleSeconds || calls >= (size_t(1) << 30))
+				break;
+			calls *= 2;
+		}
+
+		std::vector<double> perCallNs;
+		Summary summary{};
+		summary.callsPerSample = calls;
+
+		for (size_t r{}; r < options.repetitions; ++r) {
+			auto const before{ counters.read() };
+			auto const start{ Clock::now() };
+			for (size_t i{}; i < calls; ++i)
+				kernel.call();
+			std::chrono::duration<double, std::nano> elapsed{ Clock::now() - start };
+			summary.counters += counters.read() - before;
+			perCallNs.push_back(elapsed.count() / calls);
+		}
+
+		std::sort(perCallNs.begin(), perCallNs.end());
+
+		double sum{}, sumSquares{};
+		for (double v : perCallNs) {
+			sum += v;
+			sumSquares += v * v;
+		}
+		double const n{ static_cast<double>(perCallNs.size()) };
+
+		summary.minNs = perCallNs.front();
+		summary.maxNs = perCallNs.back();
+		summary.medianNs = percentile(perCallNs, 0.5);
+		summary.p90Ns = percentile(perCallNs, 0.9);
+		summary.meanNs = sum / n;
+		summary.stddevNs = std::sqrt(std::max(0.0, sumSquares / n - summary.meanNs * summary.meanNs));
+		return summary;
+	}
+
+	bool parseOptions(int argc, char* argv[], Options& options)
+	{
+		for (int i{ 1 }; i < argc; ++i) {
+			std::string arg(argv[i]);
+			auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : std::string(); };
+
+			if (arg == "--size")
+				options.size = std::max<size_t>(8, std::stoull(next()));
+			else if (arg == "--repetitions")
+				options.repetitions = std::max<size_t>(1, std::stoull(next()));
+			else if (arg == "--sample-time")
+				options.sampleSeconds = std::stod(next());
+			else if (arg == "--filter")
+				options.filter = next();
+			else if (arg == "--output")
+				options.output = next();
+			else {
+				std::cerr <<
+					"GOLMicroBench [options]\n"
+					"  --size N            taille de la grille carree (defaut: 1024)\n"
+					"  --repetitions N     nombre d'echantillons par noyau (defaut: 15)\n"
+					"  --sample-time S     duree d'un echantillon en secondes (defaut: 0.005)\n"
+					"  --filter TEXTE      ne mesure que les noyaux dont le nom contient TEXTE\n"
+					"  --output FICHIER    ecrit le JSON dans un fichier (defaut: stdout)\n";
+				return false;
+			}
+		}
+		return true;
+	}
+
+	struct Border {
+		const char* name;
+		GOL::BorderManagement value;
+	};
+
+	Border const borders[]{
+		{ "immutable", GOL::BorderManagement::immutableAsIs },
+		{ "dead", GOL::BorderManagement::foreverDead },
+		{ "alive", GOL::BorderManagement::foreverAlive },
+		{ "warping", GOL::BorderManagement::warping },
+		{ "mirror", GOL::BorderManagement::mirror },
+	};
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+		return 1;
+
+	size_t const size{ options.size };
+
+	// Entrées fixes : une soupe à 35 % sous B3/S23. Les noyaux mesurés
+	// n'échangent pas les tableaux, l'entrée reste donc identique d'un appel
+	// à l'autre.
+	auto makeEngine = [size](GOL::BorderManagement border) {
+		auto gol{ std::make_unique<GOLTeamH>() };
+		gol->resize(size, size, GOL::State::dead);
+		gol->setRule("B3/S23");
+		gol->setBorderManagement(border);
+		gol->randomize(0.35);
+		return gol;
+		};
+
+	auto gol{ makeEngine(GOL::BorderManagement::foreverDead) };
+	std::vector<uint32_t> image(size * size);
+	GridTeamH grid(size, size, GOL::State::dead);
+	std::string const gun{ PatternsBench::canonical().back().encoded };
+
+	std::vector<Kernel> kernels{
+		{ "processOneStep.interior", (size - 2) * (size - 2),
+			[&] { KernelAccessTeamH::processRows(*gol, 1, size - 1); } },
+		{ "updateImage", size * size,
+			[&] { gol->updateImage(image.data(), image.size()); } },
+		{ "countLifeStatusCells", size * size,
+			[&] { KernelAccessTeamH::countLifeStatusCells(*gol); } },
+		{ "GridTeamH::fill", size * size,
+			[&] { grid.fill(GOL::State::alive, true); } },
+		{ "GridTeamH::fillAlternately", size * size,
+			[&] { grid.fillAlternately(GOL::State::alive, true); } },
+		{ "GridTeamH::randomize", size * size,
+			[&] { grid.randomize(0.35, true); } },
+		{ "setRule", 0,
+			[&] { gol->setRule("B36/S23"); } },
+		{ "parsePattern.gosper-gun", 0,
+			[&] { KernelAccessTeamH::parsePattern(*gol, gun); } },
+	};
+
+	// Bordure : une instance par stratégie.
+	std::vector<std::unique_ptr<GOLTeamH>> borderEngines;
+	for (auto& border : borders) {
+		auto& engine{ borderEngines.emplace_back(makeEngine(border.value)) };
+		GOLTeamH* ptr{ engine.get() };
+
+		kernels.push_back({ std::string("modifyBorderIfNecessary.") + border.name, 4 * (size - 1),
+			[ptr] { KernelAccessTeamH::modifyBorderIfNecessary(*ptr); } });
+
+		// countNeighbors sur toutes les cellules du contour.
+		kernels.push_back({ std::string("countNeighbors.") + border.name, 4 * (size - 1),
+			[ptr, size] {
+				size_t volatile sink{};
+				size_t total{};
+				for (size_t i{}; i < size; ++i) {
+					total += KernelAccessTeamH::countNeighbors(*ptr, i, 0);
+					total += KernelAccessTeamH::countNeighbors(*ptr, i, size - 1);
+				}
+				for (size_t j{ 1 }; j + 1 < size; ++j) {
+					total += KernelAccessTeamH::countNeighbors(*ptr, 0, j);
+					total += KernelAccessTeamH::countNeighbors(*ptr, size - 1, j);
+				}
+				sink = total;
+				(void)sink;
+			} });
+	}
+
+	PerfCountersTeamH counters;
+	bool const hasCounters{ counters.open() };
+	if (!hasCounters)
+		std::cerr << "Compteurs materiels indisponibles : seules les durees sont rapportees.\n";
+
+	std::ofstream file;
+	if (!options.output.empty())
+		file.open(options.output);
+	std::ostream& out{ options.output.empty() ? std::cout : file };
+
+	JsonWriterBench json(out);
+	json.beginObject()
+		.field("size", static_cast<uint64_t>(size))
+		.field("repetitions", static_cast<uint64_t>(options.repetitions))
+		.field("hardwareCounters", hasCounters)
+		.key("kernels").beginArray();
+
+	for (auto& kernel : kernels) {
+		if (!options.filter.empty() && kernel.name.find(options.filter) == std::string::npos)
+			continue;
+
+		auto const summary{ measure(kernel, options, counters) };
+		double const calls{ static_cast<double>(summary.callsPerSample * options.repetitions) };
+
+		std::cerr << kernel.name << " : mediane " << summary.medianNs << " ns/appel\n";
+
+		json.beginObject()
+			.field("name", kernel.name)
+			.field("callsPerSample", static_cast<uint64_t>(summary.callsPerSample))
+			.field("minNs", summary.minNs)
+			.field("medianNs", summary.medianNs)
+			.field("meanNs", summary.meanNs)
+			.field("stddevNs", summary.stddevNs)
+			.field("p90Ns", summary.p90Ns)
+			.field("maxNs", summary.maxNs);
+		if (kernel.cellsPerCall)
+			json.field("medianNsPerCell", summary.medianNs / kernel.cellsPerCall);
+
+		if (hasCounters) {
+			json.key("countersPerCall").beginObject();
+			for (size_t i{}; i < static_cast<size_t>(PerfCountersTeamH::Counter::count); ++i) {
+				auto const counter{ static_cast<PerfCountersTeamH::Counter>(i) };
+				if (auto value{ summary.counters[counter] })
+					json.field(PerfCountersTeamH::name(counter), static_cast<double>(*value) / calls);
+			}
+			json.endObject();
+		}
+		json.endObject();
+	}
+
+	json.endArray().endObject();
+	out << '\n';
+	return 0;
+}
@@ -0,0 +1,69 @@
+﻿#pragma once
+#ifndef PATTERNSBENCH_H
+#define PATTERNSBENCH_H
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Fichier : PatternsBench.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/07
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Patrons canoniques utilisés par les bancs d'essai.
+//
+// Les patrons sont écrits lisiblement ('O' vivant, '.' mort) puis convertis
+// au format attendu par GOL::setFromPattern : "[LxH]0101...".
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+namespace PatternsBench
+{
+	struct Pattern {
+		std::string name;
+		std::string encoded;
+	};
+
+	inline std::string encode(std::initializer_list<const char*> rows)
+	{
+		std::string cells;
+		size_t width{}, height{};
+
+		for (auto* row : rows) {
+			std::string line(row);
+			width = line.size();
+			height++;
+			for (char c : line)
+				cells += (c == 'O') ? '1' : '0';
+		}
+
+		return "[" + std::to_string(width) + "x" + std::to_string(height) + "]" + cells;
+	}
+
+	inline std::vector<Pattern> canonical()
+	{
+		return {
+			{ "r-pentomino", encode({
+				".OO",
+				"OO.",
+				".O." }) },
+			{ "acorn", encode({
+				".O.....",
+				"...O...",
+				"OO..OOO" }) },
+			{ "gosper-gun", encode({
+				"........................O...........",
+				"......................O.O...........",
+				"............OO......OO............OO",
+				"...........O...O....OO............OO",
+				"OO........O.....O...OO..............",
+				"OO........O...O.OO....O.O...........",
+				"..........O.....O.......O...........",
+				"...........O...O....................",
+				"............OO......................" }) },
+		};
+	}
+}
+
+#endif // PATTERNSBENCH_H
@@ -0,0 +1,564 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GOL.h"
+#include "FixedGridTeamH.h"
+#include "GOLTeamH.h"
+#include "InfiniteGOLTeamH.h"
+#include "LargerThanLifeTeamH.h"
+#include "JsonWriterBench.h"
+#include "PatternsBench.h"
+
+// Fichier : main.cpp (GOLBench)
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/07
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Banc d'essai sans interface.
+//
+// Fait évoluer n'importe quel moteur GOL sur une matrice de tailles, de
+// règles, de gestions de bord et de conditions initiales (patrons canoniques
+// et soupes aléatoires). Les résultats (cellules/s, ns/cellule, mémoire) sont
+// écrits en JSON pour pouvoir comparer les commits entre eux.
+//
+// Exemple :
+//   GOLBench --quick --label $(git rev-parse --short HEAD) --output bench.json
+//
+// --check ne mesure rien : il vérifie que GOLTeamH réparti sur plusieurs
+// processus produit les mêmes grilles que le calcul local (voir ctest).
+// --check-memory vérifie que les fils créés puis arrêtés à répétition ne
+// font pas croître la mémoire résidente.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+namespace
+{
+	using EngineFactory = std::function<std::unique_ptr<GOL>(size_t width, size_t height)>;
+
+	struct Engine {
+		std::string name;
+		EngineFactory create; // Retourne nullptr si la taille n'est pas supportée.
+	};
+
+	// Tous les moteurs connus du banc d'essai.
+	std::vector<Engine> engines()
+	{
+		return {
+			{ "GOLTeamH", [](size_t, size_t) { return std::make_unique<GOLTeamH>(); } },
+			{ "InfiniteGOLTeamH", [](size_t, size_t) { return std::make_unique<InfiniteGOLTeamH>(); } },
+			{ "LargerThanLifeTeamH", [](size_t, size_t) { return std::make_unique<LargerThanLifeTeamH>(); } },
+			{ "FixedGridTeamH", createFixedGridTeamH },
+		};
+	}
+
+	struct Border {
+		std::string name;
+		GOL::BorderManagement value;
+	};
+
+	std::vector<Border> const allBorders{
+		{ "immutable", GOL::BorderManagement::immutableAsIs },
+		{ "dead", GOL::BorderManagement::foreverDead },
+		{ "alive", GOL::BorderManagement::foreverAlive },
+		{ "warping", GOL::BorderManagement::warping },
+		{ "mirror", GOL::BorderManagement::mirror },
+	};
+
+	// Condition initiale : un patron ou une soupe aléatoire.
+	struct Seed {
+		std::string name;
+		std::string pattern;	// Vide pour une soupe
+		double density;
+	};
+
+	struct Options {
+		std::vector<std::string> engines{ "GOLTeamH" };
+		std::vector<size_t> sizes{ 64, 256, 1024, 4096 };
+		std::vector<std::string> rules{ "B3/S23", "B36/S23", "B3678/S34678" };
+		std::vector<std::string> borders{ "immutable", "dead", "alive", "warping", "mirror" };
+		std::vector<std::string> patterns{ "r-pentomino", "acorn", "gosper-gun" };
+		std::vector<double> densities{ 0.1, 0.35, 0.5 };
+		size_t minGenerations{ 20 };
+		double minSeconds{ 0.2 };
+		size_t processes{ 1 };
+		size_t threads{ 1 };
+		size_t batch{ 1 };
+		bool tiled{};
+		bool counters{};
+		bool cycleSkipping{};
+		bool check{};
+		bool checkMemory{};
+		std::string label;
+		std::string output;
+		std::string trace;
+	};
+
+	std::vector<std::string> split(std::string const& text, char separator)
+	{
+		std::vector<std::string> parts;
+		std::stringstream stream(text);
+		std::string part;
+		while (std::getline(stream, part, separator))
+			if (!part.empty())
+				parts.push_back(part);
+		return parts;
+	}
+
+	void usage()
+	{
+		std::cerr <<
+			"GOLBench [options]\n"
+			"  --engines a,b        moteurs (defaut: GOLTeamH)\n"
+			"  --sizes 64,256       tailles des grilles carrees\n"
+			"  --rules 'B3/S23;...' regles separees par ';'\n"
+			"  --borders a,b        immutable, dead, alive, warping, mirror\n"
+			"  --patterns a,b       r-pentomino, acorn, gosper-gun (ou 'none')\n"
+			"  --densities a,b      densites des soupes aleatoires (ou 'none')\n"
+			"  --generations N      nombre minimal de generations par cas\n"
+			"  --min-time S         duree minimale d'un cas en secondes\n"
+			"  --processes N        GOLTeamH reparti sur N processus (Linux)\n"
+			"  --threads N          GOLTeamH calcule sur N fils epingles (NUMA)\n"
+			"  --batch K            generations par appel a processSteps (GOLTeamH)\n"
+			"  --layout row|tiled   disposition memoire de la grille (GOLTeamH)\n"
+			"  --counters           compteurs materiels par cellule du noyau (GOLTeamH,\n"
+			"                       GOLTEAMH_INSTRUMENTATION et perf_event requis)\n"
+			"  --cycle-skipping     laisse GOLTeamH sauter les generations d'un cycle\n"
+			"                       detecte (desactive par defaut: toutes les\n"
+			"                       generations mesurees sont calculees)\n"
+			"  --quick              petite matrice pour un essai rapide\n"
+			"  --check              compare GOLTeamH reparti (--processes, defaut 3) au\n"
+			"                       calcul local pour chaque gestion de bord; code 1 si\n"
+			"                       une cellule differe\n"
+			"  --check-memory       cree et arrete des fils a repetition (enregistrements,\n"
+			"                       pools de GOLTeamH; trace desactivee); code 1 si la\n"
+			"                       memoire croit\n"
+			"  --label TEXTE        etiquette (ex. commit) ajoutee au JSON\n"
+			"  --output FICHIER     ecrit le JSON dans un fichier (defaut: stdout)\n"
+			"  --trace FICHIER      ecrit une trace Chrome/Perfetto de l'execution\n";
+	}
+
+	bool parseOptions(int argc, char* argv[], Options& options)
+	{
+		for (int i{ 1 }; i < argc; ++i) {
+			std::string arg(argv[i]);
+			auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : std::string(); };
+
+			if (arg == "--engines")
+				options.engines = split(next(), ',');
+			else if (arg == "--sizes") {
+				options.sizes.clear();
+				for (auto& s : split(next(), ','))
+					options.sizes.push_back(std::stoull(s));
+			}
+			else if (arg == "--rules")
+				options.rules = split(next(), ';');
+			else if (arg == "--borders")
+				options.borders = split(next(), ',');
+			else if (arg == "--patterns") {
+				options.patterns = split(next(), ',');
+				if (options.patterns.size() == 1 && options.patterns.front() == "none")
+					options.patterns.clear();
+			}
+			else if (arg == "--densities") {
+				options.densities.clear();
+				for (auto& s : split(next(), ','))
+					if (s != "none")
+						options.densities.push_back(std::stod(s));
+			}
+			else if (arg == "--generations")
+				options.minGenerations = std::stoull(next());
+			else if (arg == "--min-time")
+				options.minSeconds = std::stod(next());
+			else if (arg == "--processes")
+				options.processes = std::stoull(next());
+			else if (arg == "--threads")
+				options.threads = std::stoull(next());
+			else if (arg == "--batch")
+				options.batch = std::max<size_t>(std::stoull(next()), 1);
+			else if (arg == "--layout")
+				options.tiled = next() == "tiled";
+			else if (arg == "--counters")
+				options.counters = true;
+			else if (arg == "--cycle-skipping")
+				options.cycleSkipping = true;
+			else if (arg == "--check")
+				options.check = true;
+			else if (arg == "--check-memory")
+				options.checkMemory = true;
+			else if (arg == "--quick") {
+				options.sizes = { 64, 256 };
+				options.rules = { "B3/S23" };
+				options.densities = { 0.35 };
+				options.minSeconds = 0.02;
+			}
+			else if (arg == "--label")
+				options.label = next();
+			else if (arg == "--output")
+				options.output = next();
+			else if (arg == "--trace")
+				options.trace = next();
+			else {
+				usage();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Lecture d'un champ (en ko) de /proc/self/status. 0 si indisponible.
+	uint64_t readStatusKB(std::string const& field)
+	{
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line))
+			if (line.rfind(field + ":", 0) == 0)
+				return std::strtoull(line.c_str() + field.size() + 1, nullptr, 10);
+		return 0;
+	}
+
+	// Remet à zéro le pic de mémoire résidente (Linux >= 4.0) pour mesurer
+	// chaque cas indépendamment. Sans effet ailleurs.
+	void resetPeakRss()
+	{
+		std::ofstream clearRefs("/proc/self/clear_refs");
+		if (clearRefs)
+			clearRefs << "5";
+	}
+
+	struct Result {
+		size_t generations;
+		double seconds;
+		uint64_t rssKB, peakRssKB;
+		std::optional<size_t> finalAlive;
+		size_t processes, threads;
+		std::string layout;
+		std::optional<InstrumentationTeamH::Counters> counters;	// Noyau intérieur, par cellule
+	};
+
+	Result run(GOL& gol, Options const& options, size_t size, std::string const& rule,
+		GOL::BorderManagement border, Seed const& seed)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		resetPeakRss();
+
+		// Options propres à GOLTeamH. Les fils sont créés avant resize() pour
+		// que chacun touche en premier sa bande de la grille.
+		auto* team{ dynamic_cast<GOLTeamH*>(&gol) };
+		if (team && options.threads > 1)
+			team->setThreadCount(options.threads);
+		if (team && options.processes > 1)
+			team->setProcessCount(options.processes);
+		if (team && options.tiled)
+			team->setLayout(GridTeamH::Layout::tiled);
+		// Sans calcul, une génération sautée fausserait le débit mesuré.
+		if (team)
+			team->setCycleSkipping(options.cycleSkipping);
+
+		gol.resize(size, size, GOL::State::dead);
+		gol.setRule(rule);
+		gol.setBorderManagement(border);
+		if (seed.pattern.empty())
+			gol.randomize(seed.density);
+		else
+			gol.setFromPattern(seed.pattern);
+
+		auto const batch{ team ? options.batch : 1 };
+		auto step = [&] {
+			if (batch > 1)
+				team->processSteps(batch);
+			else
+				gol.processOneStep();
+			};
+
+		// Réchauffement (caches, pages, création des processus)
+		for (int i{}; i < 2; ++i)
+			step();
+
+		if (team && options.counters && !team->setCountersEnabled(true))
+			std::cerr << "Compteurs materiels indisponibles\n";
+
+		Result result{};
+		auto const start{ Clock::now() };
+		std::chrono::duration<double> elapsed{};
+
+		do {
+			step();
+			result.generations += batch;
+			elapsed = Clock::now() - start;
+		} while (result.generations < options.minGenerations || elapsed.count() < options.minSeconds);
+
+		result.seconds = elapsed.count();
+		result.rssKB = readStatusKB("VmRSS");
+		result.peakRssKB = readStatusKB("VmHWM");
+		result.finalAlive = gol.statistics().totalAliveAbs;
+		result.processes = team ? team->extendedStatistics().processCount.value_or(1) : 1;
+		result.threads = team ? team->threadCount() : 1;
+		result.layout = team && team->layout() == GridTeamH::Layout::tiled ? "tiled" : "row";
+		if (team) {
+			result.counters = team->extendedStatistics().interiorCounters;
+			team->setCountersEnabled(false);
+		}
+
+		if (team)
+			team->setProcessCount(1);
+		return result;
+	}
+
+	// Condition initiale de --check : un patron ou 64 x 64 cellules.
+	struct CheckSeed {
+		std::string name;
+		std::string pattern;			// Vide pour des cellules
+		std::vector<GOL::State> cells;
+	};
+
+	// Prépare un GOLTeamH de 64 x 64 cellules. Le bord n'est assigné que
+	// s'il est fourni, pour vérifier aussi la gestion par défaut.
+	void prepareCheck(GOLTeamH& gol, std::optional<GOL::BorderManagement> border, CheckSeed const& seed)
+	{
+		gol.resize(64, 64, GOL::State::dead);
+		gol.setRule("B3/S23");
+		if (border)
+			gol.setBorderManagement(*border);
+		if (!seed.pattern.empty()) {
+			gol.setFromPattern(seed.pattern);
+			return;
+		}
+		// GOLTeamH compte les coordonnées à partir de 1.
+		for (int y{}; y < 64; ++y)
+			for (int x{}; x < 64; ++x)
+				gol.setState(x + 1, y + 1, seed.cells[y * 64 + x]);
+	}
+
+	// Compare, cellule par cellule et génération par génération, GOLTeamH
+	// réparti sur `processes` processus au calcul local. Chaque gestion de
+	// bord est vérifiée, y compris celle par défaut (jamais assignée), sur
+	// deux soupes (avec et sans cellules sur le bord) et sur des patrons
+	// canoniques.
+	bool checkDistributed(size_t processes)
+	{
+		std::vector<std::pair<std::string, std::optional<GOL::BorderManagement>>> borders{ { "default", std::nullopt } };
+		for (auto& border : allBorders)
+			borders.push_back({ border.name, border.value });
+
+		std::vector<GOL::State> soup(64 * 64), interior(64 * 64, GOL::State::dead);
+		std::mt19937 random(675);
+		std::bernoulli_distribution alive(0.35);
+		for (size_t i{}; i < soup.size(); ++i) {
+			soup[i] = alive(random) ? GOL::State::alive : GOL::State::dead;
+			if (i % 64 != 0 && i % 64 != 63 && i / 64 != 0 && i / 64 != 63)
+				interior[i] = soup[i];
+		}
+
+		std::vector<CheckSeed> seeds{ { "soup-0.35", {}, soup }, { "soup-0.35-interior", {}, interior } };
+		for (auto& pattern : PatternsBench::canonical())
+			seeds.push_back({ pattern.name, pattern.encoded, {} });
+
+		bool same{ true };
+		for (auto& [borderName, border] : borders) {
+			for (auto& seed : seeds) {
+				GOLTeamH local, distributed;
+				if (!distributed.setProcessCount(processes)) {
+					std::cerr << "Repartition indisponible : verification ignoree\n";
+					return true;
+				}
+				prepareCheck(local, border, seed);
+				prepareCheck(distributed, border, seed);
+
+				// Lots de tailles variées : la répartition ne rassemble la
+				// grille qu'à la fin de chaque lot.
+				size_t generation{};
+				for (size_t batch : { 1, 2, 5, 13, 40, 1, 64 }) {
+					for (size_t i{}; i < batch; ++i)
+						local.processOneStep();
+					distributed.processSteps(batch);
+					generation += batch;
+
+					size_t differences{};
+					for (int y{ 1 }; y <= 64; ++y)
+						for (int x{ 1 }; x <= 64; ++x)
+							differences += local.state(x, y) != distributed.state(x, y);
+					if (local.statistics().totalAliveAbs != distributed.statistics().totalAliveAbs)
+						++differences;
+
+					if (differences > 0) {
+						std::cerr << "ECHEC " << borderName << ' ' << seed.name << " generation "
+							<< generation << " : " << differences << " differences\n";
+						same = false;
+						break;
+					}
+				}
+				std::cerr << borderName << ' ' << seed.name << " : "
+					<< distributed.extendedStatistics().processCount.value_or(1) << " processus\n";
+				distributed.setProcessCount(1);
+			}
+		}
+		return same;
+	}
+
+	// Chaque fil nommé pour la trace ne doit rien garder une fois terminé,
+	// trace désactivée ou non. On répète la création de fils et on compare
+	// la mémoire résidente avant et après (une fuite d'un tampon de trace
+	// par fil dépasserait largement la marge).
+	bool checkThreadMemory()
+	{
+		constexpr uint64_t MARGIN_KB{ 32 * 1024 };
+
+		GOLTeamH gol;
+		gol.resize(64, 64, GOL::State::dead);
+		gol.randomize(0.35);
+
+		auto const path{ (std::filesystem::temp_directory_path() / "GOLBench-check-memory.golr").string() };
+		auto const before{ readStatusKB("VmRSS") };
+
+		// Un fil d'écriture par enregistrement.
+		for (int i{}; i < 200; ++i) {
+			if (!gol.startRecording(path)) {
+				std::cerr << "Impossible d'ecrire " << path << '\n';
+				return false;
+			}
+			gol.processOneStep();
+			gol.stopRecording();
+		}
+		std::filesystem::remove(path);
+
+		// Un nouveau pool de fils à chaque appel.
+		for (int i{}; i < 50; ++i) {
+			gol.setThreadCount(4);
+			gol.processOneStep();
+		}
+		gol.setThreadCount(1);
+
+		auto const after{ readStatusKB("VmRSS") };
+		std::cerr << "Memoire residente : " << before << " ko -> " << after << " ko\n";
+		if (after > before + MARGIN_KB) {
+			std::cerr << "ECHEC : la memoire croit avec le nombre de fils\n";
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+		return 1;
+
+	if (options.check)
+		return checkDistributed(options.processes > 1 ? options.processes : 3) ? 0 : 1;
+	if (options.checkMemory)
+		return checkThreadMemory() ? 0 : 1;
+
+	std::vector<Seed> seeds;
+	for (auto& pattern : PatternsBench::canonical())
+		for (auto& wanted : options.patterns)
+			if (pattern.name == wanted)
+				seeds.push_back({ pattern.name, pattern.encoded, 0.0 });
+	for (double density : options.densities)
+		seeds.push_back({ "soup-" + std::to_string(density).substr(0, 4), {}, density });
+
+	std::vector<Border> borders;
+	for (auto& border : allBorders)
+		for (auto& wanted : options.borders)
+			if (border.name == wanted)
+				borders.push_back(border);
+
+	std::ofstream file;
+	if (!options.output.empty()) {
+		file.open(options.output);
+		if (!file) {
+			std::cerr << "Impossible d'ouvrir " << options.output << '\n';
+			return 1;
+		}
+	}
+	std::ostream& out{ options.output.empty() ? std::cout : file };
+
+	if (!options.trace.empty()) {
+		TraceTeamH::setThreadName("simulation");
+		TraceTeamH::setEnabled(true);
+	}
+
+	JsonWriterBench json(out);
+	json.beginObject()
+		.field("label", options.label)
+		.field("timestamp", static_cast<int64_t>(std::time(nullptr)))
+		.field("hardwareConcurrency", std::thread::hardware_concurrency())
+		.key("results").beginArray();
+
+	for (auto& engine : engines()) {
+		if (std::find(options.engines.begin(), options.engines.end(), engine.name) == options.engines.end())
+			continue;
+
+		for (size_t size : options.sizes) {
+			for (auto& rule : options.rules) {
+				for (auto& border : borders) {
+					for (auto& seed : seeds) {
+						// Un moteur à taille fixe (FixedGridTeamH) ne peut pas être
+						// mesuré sur une autre taille que la sienne.
+						auto gol{ engine.create(size, size) };
+						if (!gol || gol->width() != size || gol->height() != size)
+							continue;
+
+						std::cerr << engine.name << ' ' << size << 'x' << size << ' ' << rule << ' '
+							<< border.name << ' ' << seed.name << '\n';
+
+						auto result{ run(*gol, options, size, rule, border.value, seed) };
+						double const cells{ static_cast<double>(size * size) * result.generations };
+
+						json.beginObject()
+							.field("engine", engine.name)
+							.field("width", static_cast<uint64_t>(size))
+							.field("height", static_cast<uint64_t>(size))
+							.field("rule", rule)
+							.field("border", border.name)
+							.field("seed", seed.name)
+							.field("generations", static_cast<uint64_t>(result.generations))
+							.field("seconds", result.seconds)
+							.field("cellsPerSecond", cells / result.seconds)
+							.field("nsPerCell", result.seconds * 1e9 / cells)
+							.field("rssKB", result.rssKB)
+							.field("peakRssKB", result.peakRssKB)
+							.field("processes", static_cast<uint64_t>(result.processes))
+							.field("threads", static_cast<uint64_t>(result.threads))
+							.field("layout", result.layout)
+							.field("cycleSkipping", options.cycleSkipping);
+						if (result.finalAlive)
+							json.field("finalAlive", static_cast<uint64_t>(*result.finalAlive));
+						if (result.counters) {
+							auto const& counters{ *result.counters };
+							for (auto const& [name, value] : { std::pair{ "cyclesPerCell", counters.cycles },
+								{ "instructionsPerCell", counters.instructions }, { "cacheMissesPerCell", counters.cacheMisses },
+								{ "branchMissesPerCell", counters.branchMisses }, { "ipc", counters.instructionsPerCycle } })
+								if (value)
+									json.field(name, *value);
+						}
+						json.endObject();
+					}
+				}
+			}
+		}
+	}
+
+	json.endArray().endObject();
+	out << '\n';
+
+	if (!options.trace.empty() && !TraceTeamH::dump(options.trace)) {
+		std::cerr << "Impossible d'ecrire la trace " << options.trace << '\n';
+		return 1;
+	}
+	return 0;
+}
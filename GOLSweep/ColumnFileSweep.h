@@ -0,0 +1,153 @@
+﻿#pragma once
+#ifndef COLUMNFILESWEEP_H
+#define COLUMNFILESWEEP_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Fichier : ColumnFileSweep.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/22
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classes ColumnWriterSweep et ColumnReaderSweep
+//
+// Fichier de résultats en colonnes, compact et lisible en continu :
+//
+//   "GOLSWEEP" | version (u32) | nombre de colonnes (u32)
+//   pour chaque colonne : type (u8) | longueur du nom (u8) | nom
+//   groupes : nombre de rangées (u32), puis, colonne par colonne, les
+//             valeurs du groupe (petit-boutiste, sans remplissage)
+//
+// Un groupe est écrit d'un bloc après chaque lot de simulations : un
+// balayage interrompu garde tous ses groupes complets. Les valeurs d'une
+// colonne sont contiguës dans un groupe, ce qui se compresse et se relit
+// bien (numpy.frombuffer, par exemple).
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+namespace ColumnFileSweep
+{
+	constexpr char MAGIC[8]{ 'G', 'O', 'L', 'S', 'W', 'E', 'E', 'P' };
+	constexpr uint32_t VERSION{ 1 };
+
+	enum class Type : uint8_t { u8, u16, u32, u64, f32 };
+
+	inline size_t sizeOf(Type type)
+	{
+		switch (type) {
+		case Type::u8: return 1;
+		case Type::u16: return 2;
+		case Type::u32: return 4;
+		case Type::u64: return 8;
+		case Type::f32: return 4;
+		}
+		return 0;
+	}
+
+	struct Column {
+		std::string name;
+		Type type;
+	};
+}
+
+class ColumnWriterSweep
+{
+public:
+	bool open(std::string const& path, std::vector<ColumnFileSweep::Column> const& columns)
+	{
+		mColumns = columns;
+		mOut.open(path, std::ios::binary | std::ios::trunc);
+		if (!mOut)
+			return false;
+
+		mOut.write(ColumnFileSweep::MAGIC, sizeof(ColumnFileSweep::MAGIC));
+		write(ColumnFileSweep::VERSION);
+		write(static_cast<uint32_t>(columns.size()));
+		for (auto const& column : columns) {
+			write(static_cast<uint8_t>(column.type));
+			write(static_cast<uint8_t>(column.name.size()));
+			mOut.write(column.name.data(), static_cast<std::streamsize>(column.name.size()));
+		}
+		return static_cast<bool>(mOut);
+	}
+
+	// `values[i]` pointe sur `rows` valeurs du type de la colonne i.
+	bool writeGroup(size_t rows, std::vector<const void*> const& values)
+	{
+		if (rows == 0)
+			return true;
+
+		write(static_cast<uint32_t>(rows));
+		for (size_t i{}; i < mColumns.size(); ++i)
+			mOut.write(static_cast<const char*>(values[i]),
+				static_cast<std::streamsize>(rows * ColumnFileSweep::sizeOf(mColumns[i].type)));
+		mOut.flush();
+		return static_cast<bool>(mOut);
+	}
+
+private:
+	std::ofstream mOut;
+	std::vector<ColumnFileSweep::Column> mColumns;
+
+	template <typename T>
+	void write(T value) { mOut.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+};
+
+class ColumnReaderSweep
+{
+public:
+	bool open(std::string const& path)
+	{
+		mIn.open(path, std::ios::binary);
+		char magic[sizeof(ColumnFileSweep::MAGIC)]{};
+		mIn.read(magic, sizeof(magic));
+		if (!mIn || std::memcmp(magic, ColumnFileSweep::MAGIC, sizeof(magic)) != 0 || read<uint32_t>() != ColumnFileSweep::VERSION)
+			return false;
+
+		auto const count{ read<uint32_t>() };
+		mColumns.clear();
+		for (uint32_t i{}; i < count && mIn; ++i) {
+			auto const type{ static_cast<ColumnFileSweep::Type>(read<uint8_t>()) };
+			std::string name(read<uint8_t>(), '\0');
+			mIn.read(name.data(), static_cast<std::streamsize>(name.size()));
+			mColumns.push_back({ name, type });
+		}
+		return static_cast<bool>(mIn);
+	}
+
+	std::vector<ColumnFileSweep::Column> const& columns() const { return mColumns; }
+
+	// Lit le prochain groupe complet : data[i] contient les octets de la
+	// colonne i. Retourne false à la fin du fichier.
+	bool nextGroup(size_t& rows, std::vector<std::vector<uint8_t>>& data)
+	{
+		rows = read<uint32_t>();
+		if (!mIn || rows == 0)
+			return false;
+
+		data.resize(mColumns.size());
+		for (size_t i{}; i < mColumns.size(); ++i) {
+			data[i].resize(rows * ColumnFileSweep::sizeOf(mColumns[i].type));
+			mIn.read(reinterpret_cast<char*>(data[i].data()), static_cast<std::streamsize>(data[i].size()));
+		}
+		return static_cast<bool>(mIn);
+	}
+
+private:
+	std::ifstream mIn;
+	std::vector<ColumnFileSweep::Column> mColumns;
+
+	template <typename T>
+	T read()
+	{
+		T value{};
+		mIn.read(reinterpret_cast<char*>(&value), sizeof(value));
+		return value;
+	}
+};
+
+#endif // COLUMNFILESWEEP_H
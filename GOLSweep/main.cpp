@@ -0,0 +1,428 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ColumnFileSweep.h"
+#include "EnsembleTeamH.h"
+#include "ParsingTeamH.h"
+#include "ThreadPoolTeamH.h"
+
+// Fichier : main.cpp (GOLSweep)
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/22
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Balayage sans interface de l'espace des règles B/S.
+//
+// Pour chaque règle choisie parmi les 2^18 règles totalistiques externes
+// (voisinage de Moore) et chaque graine, une soupe aléatoire évolue jusqu'à
+// ce qu'elle s'éteigne, explose (densité au-dessus d'un seuil) ou entre
+// dans un cycle de période au plus --max-period, ou jusqu'à --generations.
+// Les simulations sont groupées par 64 dans un EnsembleTeamH (une voie par
+// graine) et les ensembles sont répartis entre les fils d'un
+// ThreadPoolTeamH.
+//
+// Une règle est codée sur 18 bits : bit n = naissance avec n voisins, bit
+// 9 + n = survie avec n voisins. Les résultats sont écrits en colonnes
+// (voir ColumnFileSweep.h), un groupe par lot d'ensembles.
+//
+// Exemples :
+//   GOLSweep --all --seeds 64 --output tout.gols
+//   GOLSweep --rules 'B3/S23;B36/S23' --seeds 256 --output vie.gols
+//   GOLSweep --dump vie.gols > vie.csv
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+namespace
+{
+	constexpr uint32_t RULE_COUNT{ 1u << 18 };
+	// Ensembles par groupe du fichier de résultats, quel que soit le nombre de
+	// fils.
+	constexpr size_t BATCH_SIZE{ 64 };
+
+	enum class Outcome : uint8_t { running, extinct, exploded, cycle };
+
+	char const* outcomeName(uint8_t outcome)
+	{
+		switch (static_cast<Outcome>(outcome)) {
+		case Outcome::extinct: return "extinct";
+		case Outcome::exploded: return "exploded";
+		case Outcome::cycle: return "cycle";
+		default: return "running";
+		}
+	}
+
+	// Une simulation : une règle, une graine.
+	struct Run {
+		uint32_t rule;
+		uint64_t seed;
+		uint8_t outcome;
+		uint32_t stableAt;		// Génération de l'arrêt (début du cycle)
+		uint16_t period;		// 0 si aucun cycle
+		uint32_t alive;			// Cellules vivantes à l'arrêt
+		float density;
+	};
+
+	std::vector<ColumnFileSweep::Column> const columns{
+		{ "rule", ColumnFileSweep::Type::u32 },
+		{ "seed", ColumnFileSweep::Type::u64 },
+		{ "outcome", ColumnFileSweep::Type::u8 },
+		{ "stableAt", ColumnFileSweep::Type::u32 },
+		{ "period", ColumnFileSweep::Type::u16 },
+		{ "alive", ColumnFileSweep::Type::u32 },
+		{ "density", ColumnFileSweep::Type::f32 },
+	};
+
+	std::string ruleName(uint32_t rule)
+	{
+		std::string name{ "B" };
+		for (unsigned n{}; n <= 8; ++n)
+			if (rule & (1u << n))
+				name += static_cast<char>('0' + n);
+		name += "/S";
+		for (unsigned n{}; n <= 8; ++n)
+			if (rule & (1u << (9 + n)))
+				name += static_cast<char>('0' + n);
+		return name;
+	}
+
+	std::optional<uint32_t> ruleCode(std::string const& rule)
+	{
+		auto const parsed{ ParsingTeamH::parseRule(rule) };
+		if (!parsed)
+			return std::nullopt;
+		return (*parsed & 0x1FF) | ((*parsed >> ParsingTeamH::SURVIVAL_SHIFT) & 0x1FF) << 9;
+	}
+
+	struct Border {
+		std::string name;
+		GOL::BorderManagement value;
+	};
+
+	std::vector<Border> const allBorders{
+		{ "immutable", GOL::BorderManagement::immutableAsIs },
+		{ "dead", GOL::BorderManagement::foreverDead },
+		{ "alive", GOL::BorderManagement::foreverAlive },
+		{ "warping", GOL::BorderManagement::warping },
+		{ "mirror", GOL::BorderManagement::mirror },
+	};
+
+	struct Options {
+		std::vector<uint32_t> rules;
+		size_t seeds{ 64 };
+		uint64_t seedBase{ 1 };
+		size_t size{ 256 };
+		double density{ 0.35 };
+		size_t generations{ 1000 };
+		size_t maxPeriod{ 8 };
+		double explode{ 0.7 };
+		GOL::BorderManagement border{ GOL::BorderManagement::warping };
+		size_t threads{ std::max<size_t>(std::thread::hardware_concurrency(), 1) };
+		std::string output{ "sweep.gols" };
+		std::string dump;
+	};
+
+	std::vector<std::string> split(std::string const& text, char separator)
+	{
+		std::vector<std::string> parts;
+		std::stringstream stream(text);
+		std::string part;
+		while (std::getline(stream, part, separator))
+			if (!part.empty())
+				parts.push_back(part);
+		return parts;
+	}
+
+	void usage()
+	{
+		std::cerr <<
+			"GOLSweep [options]\n"
+			"  --rules 'B3/S23;...'  regles separees par ';'\n"
+			"  --all                 les 2^18 regles B/S\n"
+			"  --range FIRST:COUNT   regles dont le code (18 bits) est dans l'intervalle\n"
+			"  --sample N[:GRAINE]   N regles tirees au hasard\n"
+			"  --seeds N             graines par regle (defaut: 64)\n"
+			"  --seed-base S         premiere graine (defaut: 1)\n"
+			"  --size N              grilles N x N (defaut: 256)\n"
+			"  --density D           densite des soupes (defaut: 0.35)\n"
+			"  --generations N       limite par simulation (defaut: 1000)\n"
+			"  --max-period P        plus longue periode detectee (defaut: 8)\n"
+			"  --explode D           densite consideree comme une explosion (defaut: 0.7)\n"
+			"  --border NOM          immutable, dead, alive, warping (defaut), mirror\n"
+			"  --threads N           fils de calcul (defaut: tous les coeurs)\n"
+			"  --output FICHIER      fichier de resultats (defaut: sweep.gols)\n"
+			"  --dump FICHIER        ecrit un fichier de resultats en CSV et quitte\n";
+	}
+
+	bool parseOptions(int argc, char* argv[], Options& options)
+	{
+		for (int i{ 1 }; i < argc; ++i) {
+			std::string arg(argv[i]);
+			auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : std::string(); };
+
+			if (arg == "--rules") {
+				for (auto& rule : split(next(), ';')) {
+					auto const code{ ruleCode(rule) };
+					if (!code) {
+						std::cerr << "Regle invalide : " << rule << '\n';
+						return false;
+					}
+					options.rules.push_back(*code);
+				}
+			}
+			else if (arg == "--all")
+				for (uint32_t rule{}; rule < RULE_COUNT; ++rule)
+					options.rules.push_back(rule);
+			else if (arg == "--range") {
+				auto const parts{ split(next(), ':') };
+				if (parts.size() != 2)
+					return usage(), false;
+				auto const first{ std::stoul(parts[0]) }, count{ std::stoul(parts[1]) };
+				for (auto rule{ first }; rule < first + count && rule < RULE_COUNT; ++rule)
+					options.rules.push_back(static_cast<uint32_t>(rule));
+			}
+			else if (arg == "--sample") {
+				auto const parts{ split(next(), ':') };
+				if (parts.empty())
+					return usage(), false;
+				std::mt19937_64 engine(parts.size() > 1 ? std::stoull(parts[1]) : 1);
+				std::uniform_int_distribution<uint32_t> distribution(0, RULE_COUNT - 1);
+				for (size_t n{ std::stoull(parts[0]) }; n > 0; --n)
+					options.rules.push_back(distribution(engine));
+			}
+			else if (arg == "--seeds")
+				options.seeds = std::max<size_t>(std::stoull(next()), 1);
+			else if (arg == "--seed-base")
+				options.seedBase = std::stoull(next());
+			else if (arg == "--size")
+				options.size = std::max<size_t>(std::stoull(next()), 1);
+			else if (arg == "--density")
+				options.density = std::stod(next());
+			else if (arg == "--generations")
+				options.generations = std::stoull(next());
+			else if (arg == "--max-period")
+				options.maxPeriod = std::max<size_t>(std::stoull(next()), 1);
+			else if (arg == "--explode")
+				options.explode = std::stod(next());
+			else if (arg == "--border") {
+				auto const name{ next() };
+				auto const border{ std::find_if(allBorders.begin(), allBorders.end(), [&](Border const& b) { return b.name == name; }) };
+				if (border == allBorders.end())
+					return usage(), false;
+				options.border = border->value;
+			}
+			else if (arg == "--threads")
+				options.threads = std::max<size_t>(std::stoull(next()), 1);
+			else if (arg == "--output")
+				options.output = next();
+			else if (arg == "--dump")
+				options.dump = next();
+			else {
+				usage();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Fait évoluer jusqu'à 64 graines d'une règle dans un même ensemble. Une
+	// voie s'arrête dès qu'elle s'éteint, explose ou répète une des
+	// maxPeriod générations précédentes ; les voies arrêtées continuent
+	// d'être calculées (gratuitement) mais ne sont plus examinées.
+	std::vector<Run> runEnsemble(uint32_t rule, std::vector<uint64_t> const& seeds, Options const& options)
+	{
+		using Word = EnsembleTeamH::Word;
+
+		auto const lanes{ seeds.size() };
+		auto const cells{ options.size * options.size };
+
+		EnsembleTeamH ensemble;
+		ensemble.resize(options.size, options.size);
+		ensemble.setRule(ruleName(rule));
+		ensemble.setBorderManagement(options.border);
+		ensemble.randomize(options.density, seeds);
+
+		std::vector<Run> runs(lanes);
+		for (size_t lane{}; lane < lanes; ++lane)
+			runs[lane] = Run{ .rule = rule, .seed = seeds[lane], .outcome = static_cast<uint8_t>(Outcome::running),
+				.stableAt = 0, .period = 0, .alive = 0, .density = 0.0f };
+
+		// Une voie arrêtée garde le compte de la génération courante (égal à
+		// celui du début du cycle).
+		auto active{ lanes == EnsembleTeamH::LANES ? ~Word{} : (Word{ 1 } << lanes) - 1 };
+		auto stop = [&](size_t lane, Outcome outcome, size_t generation, size_t period) {
+			auto const alive{ ensemble.aliveCount(lane) };
+			runs[lane].outcome = static_cast<uint8_t>(outcome);
+			runs[lane].stableAt = static_cast<uint32_t>(generation);
+			runs[lane].period = static_cast<uint16_t>(period);
+			runs[lane].alive = static_cast<uint32_t>(alive);
+			runs[lane].density = static_cast<float>(alive) / static_cast<float>(cells);
+			active &= ~(Word{ 1 } << lane);
+			};
+
+		// Générations t - 1 à t - maxPeriod (tampon circulaire).
+		auto const periods{ options.maxPeriod };
+		std::vector<std::vector<Word>> history(periods);
+		history[0] = ensemble.cells();
+
+		for (size_t t{ 1 }; t <= options.generations && active; ++t) {
+			ensemble.processOneStep();
+			auto const& counts{ ensemble.aliveCounts() };
+			auto const& current{ ensemble.cells() };
+
+			for (size_t lane{}; lane < lanes; ++lane) {
+				if (!(active & (Word{ 1 } << lane)))
+					continue;
+				if (counts[lane] == 0)
+					stop(lane, Outcome::extinct, t, 1);
+				else if (static_cast<double>(counts[lane]) >= options.explode * static_cast<double>(cells))
+					stop(lane, Outcome::exploded, t, 0);
+			}
+
+			// Voies identiques à la génération t - p : on arrête de comparer
+			// dès que toutes les voies actives diffèrent.
+			for (size_t p{ 1 }; p <= std::min(periods, t) && active; ++p) {
+				auto const& previous{ history[(t - p) % periods] };
+				Word different{};
+				for (size_t i{}; i < current.size() && (different & active) != active; ++i)
+					different |= current[i] ^ previous[i];
+
+				auto const same{ active & ~different };
+				for (size_t lane{}; lane < lanes; ++lane)
+					if (same & (Word{ 1 } << lane))
+						stop(lane, Outcome::cycle, t - p, p);
+			}
+
+			if (active)
+				history[t % periods] = current;
+		}
+
+		for (size_t lane{}; lane < lanes; ++lane)
+			if (active & (Word{ 1 } << lane))
+				stop(lane, Outcome::running, options.generations, 0);
+		return runs;
+	}
+
+	int dump(std::string const& path)
+	{
+		ColumnReaderSweep reader;
+		if (!reader.open(path)) {
+			std::cerr << "Fichier de resultats invalide : " << path << '\n';
+			return 1;
+		}
+
+		std::cout << "rule,seed,outcome,stableAt,period,alive,density\n";
+		size_t rows;
+		std::vector<std::vector<uint8_t>> data;
+		while (reader.nextGroup(rows, data)) {
+			auto column = [&data]<typename T>(size_t index, size_t row, T) {
+				T value;
+				std::memcpy(&value, data[index].data() + row * sizeof(T), sizeof(T));
+				return value;
+				};
+
+			for (size_t row{}; row < rows; ++row)
+				std::cout << ruleName(column(0, row, uint32_t{})) << ',' << column(1, row, uint64_t{}) << ','
+					<< outcomeName(column(2, row, uint8_t{})) << ',' << column(3, row, uint32_t{}) << ','
+					<< column(4, row, uint16_t{}) << ',' << column(5, row, uint32_t{}) << ','
+					<< column(6, row, float{}) << '\n';
+		}
+		return 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using Clock = std::chrono::steady_clock;
+
+	Options options;
+	if (!parseOptions(argc, argv, options))
+		return 1;
+
+	if (!options.dump.empty())
+		return dump(options.dump);
+
+	if (options.rules.empty()) {
+		usage();
+		return 1;
+	}
+
+	ColumnWriterSweep writer;
+	if (!writer.open(options.output, columns)) {
+		std::cerr << "Impossible d'ouvrir " << options.output << '\n';
+		return 1;
+	}
+
+	// Une tâche = une règle et au plus 64 graines consécutives.
+	struct Job {
+		uint32_t rule;
+		uint64_t firstSeed;
+		size_t seeds;
+	};
+
+	std::vector<Job> jobs;
+	for (auto rule : options.rules)
+		for (size_t first{}; first < options.seeds; first += EnsembleTeamH::LANES)
+			jobs.push_back({ rule, options.seedBase + first, std::min(EnsembleTeamH::LANES, options.seeds - first) });
+
+	ThreadPoolTeamH pool(options.threads, false);
+	size_t runCount{};
+	auto const start{ Clock::now() };
+
+	for (size_t batchBegin{}; batchBegin < jobs.size(); batchBegin += BATCH_SIZE) {
+		auto const batchEnd{ std::min(batchBegin + BATCH_SIZE, jobs.size()) };
+		std::vector<std::vector<Run>> results(batchEnd - batchBegin);
+		std::atomic<size_t> nextJob{ batchBegin };
+
+		pool.run([&](size_t) {
+			for (auto index{ nextJob++ }; index < batchEnd; index = nextJob++) {
+				auto const& job{ jobs[index] };
+				std::vector<uint64_t> seeds(job.seeds);
+				for (size_t lane{}; lane < job.seeds; ++lane)
+					seeds[lane] = job.firstSeed + lane;
+				results[index - batchBegin] = runEnsemble(job.rule, seeds, options);
+			}
+			});
+
+		// Un groupe par lot, dans l'ordre des tâches : le fichier ne dépend
+		// pas du nombre de fils.
+		std::vector<uint32_t> rules, stableAt, alive;
+		std::vector<uint64_t> seeds;
+		std::vector<uint8_t> outcomes;
+		std::vector<uint16_t> periods;
+		std::vector<float> densities;
+		for (auto const& runs : results) {
+			for (auto const& run : runs) {
+				rules.push_back(run.rule);
+				seeds.push_back(run.seed);
+				outcomes.push_back(run.outcome);
+				stableAt.push_back(run.stableAt);
+				periods.push_back(run.period);
+				alive.push_back(run.alive);
+				densities.push_back(run.density);
+			}
+		}
+
+		if (!writer.writeGroup(rules.size(), { rules.data(), seeds.data(), outcomes.data(), stableAt.data(),
+			periods.data(), alive.data(), densities.data() })) {
+			std::cerr << "Erreur d'ecriture dans " << options.output << '\n';
+			return 1;
+		}
+
+		runCount += rules.size();
+		std::chrono::duration<double> const elapsed{ Clock::now() - start };
+		std::cerr << runCount << " simulations, " << batchEnd << '/' << jobs.size() << " ensembles, "
+			<< static_cast<size_t>(runCount / std::max(elapsed.count(), 1e-9)) << " simulations/s\n";
+	}
+
+	return 0;
+}
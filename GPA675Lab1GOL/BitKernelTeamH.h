@@ -0,0 +1,114 @@
+﻿#pragma once
+#ifndef BITKERNELTEAMH_H
+#define BITKERNELTEAMH_H
+
+#include <cstdint>
+
+#include "ParsingTeamH.h"
+
+// Fichier : BitKernelTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/15
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Fonctions BitKernelTeamH
+//
+// Noyau de simulation sur des cellules compactées à 1 bit : un mot de 64 bits
+// contient 64 cellules voisines d'une même rangée (bit x = colonne x).
+//
+// Les 8 voisins de chaque bit sont additionnés « en tranches de bits » : le
+// compte (0 à 8) de chaque cellule est réparti sur 4 mots, un par bit du
+// compte. La règle est ensuite appliquée pour les 64 cellules à la fois.
+//
+// Fonctions inline : elles sont appelées dans les boucles les plus chaudes.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+namespace BitKernelTeamH
+{
+	// Compte des voisins : bit i du compte de la cellule x = bit x de planes[i].
+	struct Count {
+		uint64_t planes[4];
+	};
+
+	// Ajoute 1 au compte des cellules dont le bit est présent dans `neighbors`.
+	inline void add(Count& count, uint64_t neighbors)
+	{
+		auto carry{ neighbors };
+		for (auto& plane : count.planes) {
+			auto const next{ plane & carry };
+			plane ^= carry;
+			carry = next;
+		}
+	}
+
+	// Compte des 8 voisins par un arbre d'additionneurs complets : 19
+	// opérations au lieu des 32 de huit appels à add().
+	inline Count sum(uint64_t n0, uint64_t n1, uint64_t n2, uint64_t n3,
+		uint64_t n4, uint64_t n5, uint64_t n6, uint64_t n7)
+	{
+		// Additionneur complet : a + b + c = sum + 2 * carry.
+		auto const fullAdd = [](uint64_t a, uint64_t b, uint64_t c, uint64_t& carry) {
+			auto const t{ a ^ b };
+			carry = (a & b) | (t & c);
+			return t ^ c;
+			};
+
+		uint64_t c0, c1, c2, c3, d0, d1;
+		auto const s0{ fullAdd(n0, n1, n2, c0) };
+		auto const s1{ fullAdd(n3, n4, n5, c1) };
+		auto const s2{ n6 ^ n7 };
+		c2 = n6 & n7;
+
+		Count count;
+		count.planes[0] = fullAdd(s0, s1, s2, c3);		// Poids 1
+		auto const t0{ fullAdd(c0, c1, c2, d0) };		// Poids 2
+		count.planes[1] = t0 ^ c3;
+		d1 = t0 & c3;
+		count.planes[2] = d0 ^ d1;						// Poids 4
+		count.planes[3] = d0 & d1;						// Poids 8
+		return count;
+	}
+
+	// Cellules dont le compte vaut exactement `value`.
+	inline uint64_t equals(Count const& count, unsigned value)
+	{
+		uint64_t mask{ ~0ull };
+		for (unsigned i{}; i < 4; ++i)
+			mask &= (value >> i) & 1 ? count.planes[i] : ~count.planes[i];
+		return mask;
+	}
+
+	// Applique la règle encodée (voir ParsingTeamH) à 64 cellules.
+	inline uint64_t applyRule(Count const& count, uint64_t alive, uint32_t rule)
+	{
+		uint64_t next{};
+		for (unsigned n{}; n <= 8; ++n) {
+			auto const born{ (rule >> n) & 1u }, survives{ (rule >> (n + ParsingTeamH::SURVIVAL_SHIFT)) & 1u };
+			if (born | survives)
+				next |= equals(count, n) & ((born ? ~alive : 0) | (survives ? alive : 0));
+		}
+		return next;
+	}
+
+	// Génération suivante de la rangée `row`. `above` et `below` sont les
+	// rangées voisines ; les paramètres *West et *East contiennent le bit 63
+	// (resp. 0) du mot voisin à gauche (resp. à droite) de chaque rangée.
+	inline uint64_t evolve(uint64_t above, uint64_t row, uint64_t below,
+		uint64_t aboveWest, uint64_t rowWest, uint64_t belowWest,
+		uint64_t aboveEast, uint64_t rowEast, uint64_t belowEast,
+		uint32_t rule)
+	{
+		// Voisin de gauche de x = bit x - 1 ; voisin de droite = bit x + 1.
+		auto const left = [](uint64_t word, uint64_t west) { return (word << 1) | (west >> 63); };
+		auto const right = [](uint64_t word, uint64_t east) { return (word >> 1) | (east << 63); };
+
+		auto const count{ sum(left(above, aboveWest), above, right(above, aboveEast),
+			left(row, rowWest), right(row, rowEast),
+			left(below, belowWest), below, right(below, belowEast)) };
+
+		return applyRule(count, row, rule);
+	}
+}
+
+#endif // BITKERNELTEAMH_H
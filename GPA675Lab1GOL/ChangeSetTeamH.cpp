@@ -0,0 +1,41 @@
+﻿#include "ChangeSetTeamH.h"
+
+#include <algorithm>
+
+ChangeSetTeamH::ChangeSetTeamH()
+	: mWidth{}, mHeight{}, mWordsPerRow{}, mTilesY{}, mValid{}
+{
+}
+
+void ChangeSetTeamH::resize(size_t width, size_t height)
+{
+	mWidth = width;
+	mHeight = height;
+	mWordsPerRow = (width + 63) / 64;
+	mTilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+	mRows.assign(mWordsPerRow * height, 0);
+	mTiles.assign(mWordsPerRow * mTilesY, 0);
+	mValid = false;
+}
+
+void ChangeSetTeamH::clear()
+{
+	for (size_t tile{}; tile < mTiles.size(); ++tile) {
+		if (!mTiles[tile])
+			continue;
+
+		auto const word{ tile % mWordsPerRow }, firstRow{ tile / mWordsPerRow * TILE_SIZE };
+		auto const lastRow{ std::min(firstRow + TILE_SIZE, mHeight) };
+		for (size_t y{ firstRow }; y < lastRow; ++y)
+			mRows[y * mWordsPerRow + word] = 0;
+		mTiles[tile] = 0;
+	}
+	mValid = true;
+}
+
+size_t ChangeSetTeamH::count() const
+{
+	size_t total{};
+	forEachChange([&total](size_t, size_t) { ++total; });
+	return total;
+}
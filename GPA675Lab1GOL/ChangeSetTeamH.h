@@ -0,0 +1,139 @@
+﻿#pragma once
+#ifndef CHANGESETTEAMH_H
+#define CHANGESETTEAMH_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Fichier : ChangeSetTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/24
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe ChangeSetTeamH
+//
+// Cellules qui ont changé d'état à la dernière génération :
+// - un masque de bits par rangée (bit x % 64 du mot x / 64 = la cellule de
+//   la colonne x a changé) ;
+// - un indicateur par tuile de TILE_SIZE x TILE_SIZE cellules : au moins un
+//   bit de la tuile est présent. Une tuile couvre un mot de ses rangées.
+//
+// Le noyau de GOLTeamH remplit l'ensemble pendant le calcul, rangée par
+// rangée, pendant que les deux rangées sont en cache (record). Un
+// consommateur (rendu, enregistrement, miroir réseau) parcourt les tuiles
+// marquées puis leurs mots non nuls : son coût suit le nombre de
+// changements, pas la taille de la grille. clear() ne touche aussi que les
+// tuiles marquées.
+//
+// Un ensemble invalide (valid() == false) signifie que les changements ne
+// sont pas connus (grille modifiée directement, redimensionnée, calculée
+// par des processus...) : toute la grille doit être relue.
+//
+// record() et mark() peuvent être appelés en même temps par plusieurs fils
+// sur des cellules différentes : les mots partagés entre deux tuiles de
+// calcul sont mis à jour atomiquement.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class ChangeSetTeamH
+{
+public:
+	static constexpr size_t TILE_SIZE{ 64 };	// = bits par mot
+
+	ChangeSetTeamH();
+
+	// Ensemble vide et invalide de la taille donnée.
+	void resize(size_t width, size_t height);
+
+	size_t width() const { return mWidth; }
+	size_t height() const { return mHeight; }
+	size_t wordsPerRow() const { return mWordsPerRow; }
+	size_t tilesX() const { return mWordsPerRow; }
+	size_t tilesY() const { return mTilesY; }
+
+	bool valid() const { return mValid; }
+	void invalidate() { mValid = false; }
+	// Vide l'ensemble (tuiles marquées seulement) et le rend valide.
+	void clear();
+
+	// Compare `count` cellules de `before` et `after` (octets 0 ou 1) qui
+	// commencent à la colonne `column` de la rangée `row`.
+	void record(size_t row, size_t column, const uint8_t* before, const uint8_t* after, size_t count);
+	// Une seule cellule.
+	void mark(size_t column, size_t row);
+
+	const uint64_t* row(size_t y) const { return mRows.data() + y * mWordsPerRow; }
+	bool tileChanged(size_t tileX, size_t tileY) const { return mTiles[tileY * mWordsPerRow + tileX] != 0; }
+
+	// Appelle function(column, row) pour chaque cellule changée, tuile par
+	// tuile.
+	template <typename Function>
+	void forEachChange(Function function) const;
+
+	// Nombre de cellules changées.
+	size_t count() const;
+
+private:
+	size_t mWidth, mHeight, mWordsPerRow, mTilesY;
+	std::vector<uint64_t> mRows;
+	std::vector<uint8_t> mTiles;
+	bool mValid;
+
+	void setBits(size_t row, size_t word, uint64_t bits)
+	{
+		std::atomic_ref<uint64_t>(mRows[row * mWordsPerRow + word]).fetch_or(bits, std::memory_order_relaxed);
+		std::atomic_ref<uint8_t>(mTiles[row / TILE_SIZE * mWordsPerRow + word]).store(1, std::memory_order_relaxed);
+	}
+};
+
+inline void ChangeSetTeamH::record(size_t row, size_t column, const uint8_t* before, const uint8_t* after, size_t count)
+{
+	// Les bits 0 de 8 octets (0 ou 1) regroupés dans l'octet du haut.
+	constexpr uint64_t GATHER{ 0x0102040810204080ull };
+
+	size_t i{};
+	for (; i + 8 <= count; i += 8) {
+		uint64_t a, b;
+		memcpy(&a, before + i, sizeof(a));
+		memcpy(&b, after + i, sizeof(b));
+		if (a == b)
+			continue;
+
+		auto const bits{ ((a ^ b) * GATHER) >> 56 };
+		auto const x{ column + i }, shift{ x % 64 };
+		if (bits << shift)
+			setBits(row, x / 64, bits << shift);
+		if (shift > 56 && (bits >> (64 - shift)))
+			setBits(row, x / 64 + 1, bits >> (64 - shift));
+	}
+
+	for (; i < count; ++i)
+		if (before[i] != after[i])
+			mark(column + i, row);
+}
+
+inline void ChangeSetTeamH::mark(size_t column, size_t row)
+{
+	setBits(row, column / 64, uint64_t{ 1 } << (column % 64));
+}
+
+template <typename Function>
+void ChangeSetTeamH::forEachChange(Function function) const
+{
+	for (size_t tile{}; tile < mTiles.size(); ++tile) {
+		if (!mTiles[tile])
+			continue;
+
+		auto const word{ tile % mWordsPerRow }, firstRow{ tile / mWordsPerRow * TILE_SIZE };
+		auto const lastRow{ std::min(firstRow + TILE_SIZE, mHeight) };
+		for (size_t y{ firstRow }; y < lastRow; ++y)
+			for (auto bits{ mRows[y * mWordsPerRow + word] }; bits; bits &= bits - 1)
+				function(word * 64 + static_cast<size_t>(std::countr_zero(bits)), y);
+	}
+}
+
+#endif // CHANGESETTEAMH_H
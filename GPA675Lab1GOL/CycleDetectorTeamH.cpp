@@ -0,0 +1,56 @@
+﻿#include "CycleDetectorTeamH.h"
+
+#include <algorithm>
+
+CycleDetectorTeamH::CycleDetectorTeamH()
+	: mHistory{}, mNext{}, mCount{}, mCandidate{}, mConfirmations{}, mConfirmed{}
+{
+}
+
+void CycleDetectorTeamH::reset()
+{
+	mNext = 0;
+	mCount = 0;
+	mCandidate = 0;
+	mConfirmations = 0;
+	mConfirmed = false;
+}
+
+void CycleDetectorTeamH::push(uint64_t hash)
+{
+	if (mCandidate) {
+		// On vérifie que la génération répète celle d'il y a p générations.
+		if (hashAt(mCandidate) == hash) {
+			if (++mConfirmations >= std::max<size_t>(mCandidate, 2))
+				mConfirmed = true;
+		}
+		else {
+			mCandidate = 0;
+			mConfirmations = 0;
+			mConfirmed = false;
+		}
+	}
+
+	if (!mCandidate) {
+		// Plus petite période qui explique la génération courante.
+		for (size_t age{ 1 }; age <= mCount && age < HISTORY_SIZE; ++age) {
+			if (hashAt(age) == hash) {
+				mCandidate = age;
+				mConfirmations = 1;
+				mConfirmed = false;
+				break;
+			}
+		}
+	}
+
+	mHistory[mNext] = hash;
+	mNext = (mNext + 1) % HISTORY_SIZE;
+	mCount = std::min(mCount + 1, HISTORY_SIZE);
+}
+
+std::optional<size_t> CycleDetectorTeamH::period() const
+{
+	if (mConfirmed)
+		return mCandidate;
+	return std::nullopt;
+}
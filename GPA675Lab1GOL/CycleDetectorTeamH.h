@@ -0,0 +1,50 @@
+﻿#pragma once
+#ifndef CYCLEDETECTORTEAMH_H
+#define CYCLEDETECTORTEAMH_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+// Fichier : CycleDetectorTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/13
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe CycleDetectorTeamH
+//
+// Détection d'oscillateurs et de structures stables à partir de l'empreinte
+// (hash 64 bits) de chaque génération.
+//
+// Les HISTORY_SIZE dernières empreintes sont conservées dans un tampon
+// circulaire. Lorsqu'une empreinte réapparaît après p générations, la
+// période p devient candidate ; elle est confirmée si les max(p, 2)
+// générations suivantes répètent aussi celles d'il y a p générations. Une
+// collision d'empreintes ne peut donc pas, à elle seule, confirmer un cycle.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class CycleDetectorTeamH
+{
+public:
+	static constexpr size_t HISTORY_SIZE{ 256 };	// Période maximale détectable - 1
+
+	CycleDetectorTeamH();
+
+	void reset();
+	void push(uint64_t hash);
+
+	// Période confirmée (1 = structure stable), ou rien.
+	std::optional<size_t> period() const;
+
+private:
+	std::array<uint64_t, HISTORY_SIZE> mHistory;
+	size_t mNext, mCount;
+	size_t mCandidate, mConfirmations;
+	bool mConfirmed;
+
+	// Empreinte d'il y a `age` générations (1 = la précédente).
+	uint64_t hashAt(size_t age) const { return mHistory[(mNext + HISTORY_SIZE - age) % HISTORY_SIZE]; }
+};
+
+#endif // CYCLEDETECTORTEAMH_H
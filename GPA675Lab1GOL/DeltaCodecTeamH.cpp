@@ -0,0 +1,121 @@
+﻿#include "DeltaCodecTeamH.h"
+
+#include <cstring>
+
+namespace
+{
+	// Multiplicateur qui ramasse le bit 0 de chacun des 8 octets dans un seul
+	// octet (octet i -> bit i). Valide puisque GOL::State::alive = 1.
+	constexpr uint64_t PACK_MAGIC{ 0x0102040810204080ull };
+
+	void writeVarint(std::vector<uint8_t>& out, uint64_t value)
+	{
+		while (value >= 0x80) {
+			out.push_back(static_cast<uint8_t>(value) | 0x80);
+			value >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(value));
+	}
+
+	bool readVarint(const uint8_t*& ptr, const uint8_t* end, uint64_t& value)
+	{
+		value = 0;
+		for (int shift{}; shift < 64; shift += 7) {
+			if (ptr >= end)
+				return false;
+
+			uint8_t byte{ *ptr++ };
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+}
+
+void DeltaCodecTeamH::pack(const GOL::State* cells, size_t cellCount, std::vector<uint64_t>& words)
+{
+	words.assign(wordCount(cellCount), 0);
+
+	auto const* ptr{ reinterpret_cast<const uint8_t*>(cells) };
+	size_t i{};
+
+	// 64 cellules à la fois : 8 lectures de 8 octets.
+	for (; i + 64 <= cellCount; i += 64) {
+		uint64_t word{};
+		for (size_t b{}; b < 8; ++b) {
+			uint64_t chunk;
+			memcpy(&chunk, ptr + i + b * 8, sizeof(chunk));
+			word |= ((chunk * PACK_MAGIC) >> 56) << (b * 8);
+		}
+		words[i / 64] = word;
+	}
+
+	// Reste
+	for (; i < cellCount; ++i)
+		words[i / 64] |= static_cast<uint64_t>(ptr[i]) << (i % 64);
+}
+
+void DeltaCodecTeamH::unpack(std::vector<uint64_t> const& words, GOL::State* cells, size_t cellCount)
+{
+	auto* ptr{ reinterpret_cast<uint8_t*>(cells) };
+
+	for (size_t i{}; i < cellCount; ++i)
+		ptr[i] = (words[i / 64] >> (i % 64)) & 1;
+}
+
+void DeltaCodecTeamH::encodeXor(std::vector<uint64_t> const& current, std::vector<uint64_t> const& previous,
+	std::vector<uint8_t>& out)
+{
+	out.clear();
+
+	bool const isKey{ previous.size() != current.size() };
+	auto delta = [&](size_t i) { return isKey ? current[i] : current[i] ^ previous[i]; };
+
+	size_t i{}, n{ current.size() };
+	while (i < n) {
+		size_t zeros{};
+		while (i < n && delta(i) == 0) {
+			++zeros;
+			++i;
+		}
+
+		size_t literalStart{ i };
+		while (i < n && delta(i) != 0)
+			++i;
+
+		writeVarint(out, zeros);
+		writeVarint(out, i - literalStart);
+
+		for (size_t j{ literalStart }; j < i; ++j) {
+			uint64_t word{ delta(j) };
+			auto pos{ out.size() };
+			out.resize(pos + sizeof(word));
+			memcpy(out.data() + pos, &word, sizeof(word));
+		}
+	}
+}
+
+bool DeltaCodecTeamH::decodeXorInto(const uint8_t* data, size_t size, std::vector<uint64_t>& words)
+{
+	auto const* end{ data + size };
+	size_t i{};
+
+	while (data < end) {
+		uint64_t zeros, literals;
+		if (!readVarint(data, end, zeros) || !readVarint(data, end, literals))
+			return false;
+
+		i += zeros;
+		if (i + literals > words.size() || static_cast<size_t>(end - data) < literals * sizeof(uint64_t))
+			return false;
+
+		for (uint64_t j{}; j < literals; ++j, ++i, data += sizeof(uint64_t)) {
+			uint64_t word;
+			memcpy(&word, data, sizeof(word));
+			words[i] ^= word;
+		}
+	}
+
+	return i <= words.size();
+}
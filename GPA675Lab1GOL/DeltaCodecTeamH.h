@@ -0,0 +1,48 @@
+﻿#pragma once
+#ifndef DELTACODECTEAMH_H
+#define DELTACODECTEAMH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "GOL.h"
+
+// Fichier : DeltaCodecTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/05
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Fonctions DeltaCodecTeamH
+//
+// Petites fonctions de compression utilisées pour archiver des générations.
+// Une génération est d'abord compactée à 1 bit par cellule (mots de 64 bits),
+// puis on encode le XOR avec la génération précédente par plages :
+//
+//   [nb. de mots nuls (varint)][nb. de mots littéraux (varint)][mots...]
+//
+// Une image clé est simplement le XOR avec une génération entièrement morte.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+namespace DeltaCodecTeamH
+{
+	// Nombre de mots de 64 bits nécessaires pour compacter `cellCount` cellules.
+	inline size_t wordCount(size_t cellCount) { return (cellCount + 63) / 64; }
+
+	// Compacte les cellules (1 octet par cellule) à 1 bit par cellule.
+	void pack(const GOL::State* cells, size_t cellCount, std::vector<uint64_t>& words);
+
+	// Opération inverse de pack().
+	void unpack(std::vector<uint64_t> const& words, GOL::State* cells, size_t cellCount);
+
+	// Encode `current ^ previous` par plages. Si `previous` est vide, on encode
+	// `current` tel quel (image clé).
+	void encodeXor(std::vector<uint64_t> const& current, std::vector<uint64_t> const& previous,
+		std::vector<uint8_t>& out);
+
+	// Applique (XOR) la différence encodée sur `words`. Retourne false si les
+	// données sont corrompues ou ne correspondent pas à la taille de `words`.
+	bool decodeXorInto(const uint8_t* data, size_t size, std::vector<uint64_t>& words);
+}
+
+#endif // DELTACODECTEAMH_H
@@ -0,0 +1,139 @@
+﻿#include "DensityPyramidTeamH.h"
+#include "TraceTeamH.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+DensityPyramidTeamH::DensityPyramidTeamH()
+	: mWidth{}, mHeight{}, mValid{}
+{
+}
+
+void DensityPyramidTeamH::resize(size_t width, size_t height)
+{
+	mWidth = width;
+	mHeight = height;
+
+	// Assez de niveaux pour qu'un seul bloc couvre la grille.
+	auto const side{ std::max<size_t>(std::max(width, height), 2) };
+	mLevels.resize(static_cast<size_t>(std::bit_width(side - 1)));
+	for (size_t level{ 1 }; level <= mLevels.size(); ++level)
+		mLevels[level - 1].assign(levelWidth(level) * levelHeight(level), 0);
+	mValid = false;
+}
+
+void DensityPyramidTeamH::rebuild(GridTeamH const& grid)
+{
+	GOLTEAMH_TRACE_SCOPE("DensityPyramidTeamH::rebuild");
+
+	if (grid.width() != mWidth || grid.height() != mHeight)
+		resize(grid.width(), grid.height());
+
+	auto const tiles{ ChangeSetTeamH::TILE_SIZE };
+	for (size_t tileY{}; tileY * tiles < mHeight; ++tileY)
+		for (size_t tileX{}; tileX * tiles < mWidth; ++tileX)
+			rebuildTile(grid, tileX, tileY);
+
+	for (size_t level{ TILE_LEVEL + 1 }; level <= levelCount(); ++level)
+		sumChildren(level, 0, levelWidth(level), 0, levelHeight(level));
+	mValid = true;
+}
+
+void DensityPyramidTeamH::update(GridTeamH const& grid, ChangeSetTeamH const& changes)
+{
+	if (!mValid)
+		return;
+
+	GOLTEAMH_TRACE_SCOPE("DensityPyramidTeamH::update");
+
+	auto const topLevel{ std::min(TILE_LEVEL, levelCount()) };
+	for (size_t tileY{}; tileY < changes.tilesY(); ++tileY) {
+		for (size_t tileX{}; tileX < changes.tilesX(); ++tileX) {
+			if (!changes.tileChanged(tileX, tileY))
+				continue;
+
+			// Le bloc de la tuile au niveau TILE_LEVEL, avant et après.
+			auto const before{ topLevel == TILE_LEVEL ? count(TILE_LEVEL, tileX, tileY) : 0 };
+			rebuildTile(grid, tileX, tileY);
+			if (topLevel < TILE_LEVEL)
+				continue;
+
+			auto const delta{ count(TILE_LEVEL, tileX, tileY) - before };	// modulo 2^32
+			for (size_t level{ TILE_LEVEL + 1 }; level <= levelCount(); ++level) {
+				auto const shift{ level - TILE_LEVEL };
+				mLevels[level - 1][(tileY >> shift) * levelWidth(level) + (tileX >> shift)] += delta;
+			}
+		}
+	}
+}
+
+size_t DensityPyramidTeamH::cellCount(size_t level, size_t blockX, size_t blockY) const
+{
+	auto const side{ size_t{ 1 } << level };
+	auto const width{ std::min(side, mWidth - blockX * side) };
+	auto const height{ std::min(side, mHeight - blockY * side) };
+	return width * height;
+}
+
+size_t DensityPyramidTeamH::levelFor(double cellsPerPixel) const
+{
+	if (cellsPerPixel <= 1.0)
+		return 0;
+
+	return std::min(static_cast<size_t>(std::ceil(std::log2(cellsPerPixel))), levelCount());
+}
+
+// Niveaux 1 à TILE_LEVEL d'une tuile : le niveau 1 à partir des cellules
+// (une suite contiguë de TILE_SIZE cellules par rangée, dans les deux
+// dispositions de la grille), les suivants à partir du niveau précédent.
+void DensityPyramidTeamH::rebuildTile(GridTeamH const& grid, size_t tileX, size_t tileY)
+{
+	auto const tiles{ ChangeSetTeamH::TILE_SIZE };
+	auto const columnBegin{ tileX * tiles }, columnEnd{ std::min(columnBegin + tiles, mWidth) };
+	auto const rowBegin{ tileY * tiles }, rowEnd{ std::min(rowBegin + tiles, mHeight) };
+
+	auto& level1{ mLevels[0] };
+	auto const width1{ levelWidth(1) };
+	for (auto y{ rowBegin / 2 }; y < (rowEnd + 1) / 2; ++y)
+		std::fill_n(level1.begin() + y * width1 + columnBegin / 2, (columnEnd + 1) / 2 - columnBegin / 2, 0);
+
+	auto const* cells{ reinterpret_cast<const uint8_t*>(grid.data()) };
+	for (auto row{ rowBegin }; row < rowEnd; ++row) {
+		auto const* span{ cells + grid.offset(columnBegin, row) };
+		auto* blocks{ level1.data() + (row / 2) * width1 + columnBegin / 2 };
+		for (size_t i{}; i < columnEnd - columnBegin; ++i)
+			blocks[i / 2] += span[i];
+	}
+
+	for (size_t level{ 2 }; level <= std::min(TILE_LEVEL, levelCount()); ++level) {
+		auto const shift{ level };
+		sumChildren(level, columnBegin >> shift, std::min((columnEnd + (size_t{ 1 } << shift) - 1) >> shift, levelWidth(level)),
+			rowBegin >> shift, std::min((rowEnd + (size_t{ 1 } << shift) - 1) >> shift, levelHeight(level)));
+	}
+}
+
+// Blocs [xBegin, xEnd) x [yBegin, yEnd) du niveau `level` : somme de leurs
+// quatre enfants (moins au bord).
+void DensityPyramidTeamH::sumChildren(size_t level, size_t xBegin, size_t xEnd, size_t yBegin, size_t yEnd)
+{
+	auto const& children{ mLevels[level - 2] };
+	auto& blocks{ mLevels[level - 1] };
+	auto const childWidth{ levelWidth(level - 1) }, childHeight{ levelHeight(level - 1) };
+	auto const width{ levelWidth(level) };
+
+	for (auto y{ yBegin }; y < yEnd; ++y) {
+		for (auto x{ xBegin }; x < xEnd; ++x) {
+			auto const cx{ 2 * x }, cy{ 2 * y };
+			uint32_t total{ children[cy * childWidth + cx] };
+			if (cx + 1 < childWidth)
+				total += children[cy * childWidth + cx + 1];
+			if (cy + 1 < childHeight) {
+				total += children[(cy + 1) * childWidth + cx];
+				if (cx + 1 < childWidth)
+					total += children[(cy + 1) * childWidth + cx + 1];
+			}
+			blocks[y * width + x] = total;
+		}
+	}
+}
@@ -0,0 +1,76 @@
+﻿#pragma once
+#ifndef DENSITYPYRAMIDTEAMH_H
+#define DENSITYPYRAMIDTEAMH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "ChangeSetTeamH.h"
+#include "GridTeamH.h"
+
+// Fichier : DensityPyramidTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/27
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe DensityPyramidTeamH
+//
+// Pyramide (« mip-map ») du nombre de cellules vivantes d'une GridTeamH :
+// le niveau k (1 <= k <= levelCount()) compte les cellules vivantes de
+// chaque bloc de 2^k x 2^k cellules. Le dernier niveau n'a qu'un bloc. Un
+// rendu dézoomé lit le niveau dont les blocs couvrent environ un pixel :
+// son coût dépend du nombre de pixels, pas de la taille de la grille.
+//
+// Les blocs du niveau TILE_LEVEL sont les tuiles de ChangeSetTeamH. Après
+// une itération, update() recalcule les niveaux 1 à TILE_LEVEL des seules
+// tuiles changées, à partir de la grille, puis ajoute la différence de
+// chaque tuile à ses blocs parents des niveaux supérieurs.
+//
+// Les blocs du bord droit et du bas peuvent être incomplets (voir
+// cellCount).
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class DensityPyramidTeamH
+{
+public:
+	static constexpr size_t TILE_LEVEL{ 6 };	// 2^6 = ChangeSetTeamH::TILE_SIZE
+	static_assert(size_t{ 1 } << TILE_LEVEL == ChangeSetTeamH::TILE_SIZE);
+	static_assert(ChangeSetTeamH::TILE_SIZE == GridTeamH::BLOCK_SIZE);
+
+	DensityPyramidTeamH();
+
+	size_t width() const { return mWidth; }
+	size_t height() const { return mHeight; }
+	size_t levelCount() const { return mLevels.size(); }
+	size_t levelWidth(size_t level) const { return (mWidth + (size_t{ 1 } << level) - 1) >> level; }
+	size_t levelHeight(size_t level) const { return (mHeight + (size_t{ 1 } << level) - 1) >> level; }
+
+	bool valid() const { return mValid; }
+	void invalidate() { mValid = false; }
+
+	// Recalcule toute la pyramide (et l'adapte à la taille de la grille).
+	void rebuild(GridTeamH const& grid);
+	// Recalcule les tuiles marquées dans `changes`. Sans effet si la
+	// pyramide est invalide : elle sera reconstruite au besoin.
+	void update(GridTeamH const& grid, ChangeSetTeamH const& changes);
+
+	// Cellules vivantes du bloc (blockX, blockY) du niveau `level`.
+	uint32_t count(size_t level, size_t blockX, size_t blockY) const { return mLevels[level - 1][blockY * levelWidth(level) + blockX]; }
+	// Cellules de la grille couvertes par ce bloc.
+	size_t cellCount(size_t level, size_t blockX, size_t blockY) const;
+	// Plus petit niveau dont les blocs couvrent au moins `cellsPerPixel`
+	// cellules de côté (0 = les cellules elles-mêmes).
+	size_t levelFor(double cellsPerPixel) const;
+
+private:
+	size_t mWidth, mHeight;
+	std::vector<std::vector<uint32_t>> mLevels;	// mLevels[k - 1] = niveau k
+	bool mValid;
+
+	void resize(size_t width, size_t height);
+	void rebuildTile(GridTeamH const& grid, size_t tileX, size_t tileY);
+	void sumChildren(size_t level, size_t xBegin, size_t xEnd, size_t yBegin, size_t yEnd);
+};
+
+#endif // DENSITYPYRAMIDTEAMH_H
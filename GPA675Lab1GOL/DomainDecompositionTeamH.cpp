@@ -0,0 +1,293 @@
+﻿#include "DomainDecompositionTeamH.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "GOLTeamH.h"
+
+#ifdef __linux__
+
+namespace
+{
+	enum Command : uint32_t {
+		load = 0,
+		run,
+		gather,
+		quit
+	};
+}
+
+// En-tête de la mémoire partagée. Suivent, dans l'ordre :
+// - les rangées publiées : [travailleur][parité][haut, bas][width] ;
+// - les comptes : [travailleur][COUNT_HISTORY] ;
+// - la grille d'échange pour load() et gather() : [height][width].
+struct DomainDecompositionTeamH::Shared {
+	pthread_barrier_t control;	// Coordinateur + travailleurs
+	pthread_barrier_t step;		// Travailleurs seulement, une fois par génération
+	uint32_t command;
+	uint32_t parsedRule;
+	NeighborhoodTeamH::Mask neighborhood;
+	uint64_t steps;
+
+	uint8_t* halo(size_t width, size_t worker, size_t parity, size_t side)
+	{
+		return reinterpret_cast<uint8_t*>(this + 1) + (((worker * 2 + parity) * 2 + side) * width);
+	}
+
+	uint64_t* counts(size_t width, size_t workerCount, size_t worker)
+	{
+		auto* base{ reinterpret_cast<uint8_t*>(this + 1) + workerCount * 4 * width };
+		auto const aligned{ (reinterpret_cast<uintptr_t>(base) + 7) & ~uintptr_t{ 7 } };
+		return reinterpret_cast<uint64_t*>(aligned) + worker * COUNT_HISTORY;
+	}
+
+	uint8_t* grid(size_t width, size_t workerCount)
+	{
+		return reinterpret_cast<uint8_t*>(counts(width, workerCount, workerCount));
+	}
+};
+
+// Boucle d'un processus travailleur. Ne retourne jamais.
+//
+// La tranche possède `rows` rangées de la grille, de `rowBegin` à
+// `rowBegin + rows - 1` ; la rangée locale r correspond à la rangée
+// rowBegin + r - 1 de la grille (0 et rows + 1 sont les rangées fantômes).
+void DomainDecompositionTeamH::workerLoop(Shared* shared, size_t worker, size_t workerCount,
+	size_t width, size_t rowBegin, size_t rows)
+{
+	auto* counts{ shared->counts(width, workerCount, worker) };
+	auto const slabSize{ (rows + 2) * width };
+
+	// mmap plutôt que new : on évite l'allocateur après fork puisque le
+	// parent peut avoir d'autres fils d'exécution (enregistreur).
+	auto* memory{ static_cast<uint8_t*>(mmap(nullptr, slabSize * 2, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) };
+	if (memory == MAP_FAILED)
+		_exit(1);
+
+	uint8_t* current{ memory };
+	uint8_t* next{ memory + slabSize };
+	size_t parity{};
+
+	for (;;) {
+		pthread_barrier_wait(&shared->control);
+
+		switch (shared->command) {
+		case Command::load: {
+			auto const* grid{ shared->grid(width, workerCount) };
+			memcpy(current, grid + (rowBegin - 1) * width, slabSize);
+			memcpy(next, current, slabSize);
+			break;
+		}
+		case Command::run:
+			for (uint64_t generation{}; generation < shared->steps; ++generation) {
+				auto const result{ GOLTeamH::evolveRows(current, next, width, 1, rows + 1, shared->parsedRule, shared->neighborhood) };
+				counts[generation % DomainDecompositionTeamH::COUNT_HISTORY] = result.aliveCount;
+
+				memcpy(shared->halo(width, worker, parity, 0), next + width, width);
+				memcpy(shared->halo(width, worker, parity, 1), next + rows * width, width);
+
+				pthread_barrier_wait(&shared->step);
+
+				// Les rangées fantômes des extrémités (bordure de la grille) ne
+				// changent jamais.
+				if (worker > 0)
+					memcpy(next, shared->halo(width, worker - 1, parity, 1), width);
+				if (worker + 1 < workerCount)
+					memcpy(next + (rows + 1) * width, shared->halo(width, worker + 1, parity, 0), width);
+
+				std::swap(current, next);
+				parity ^= 1;
+			}
+			break;
+		case Command::gather:
+			memcpy(shared->grid(width, workerCount) + rowBegin * width, current + width, rows * width);
+			break;
+		case Command::quit:
+		default:
+			_exit(0);
+		}
+
+		pthread_barrier_wait(&shared->control);
+	}
+}
+
+#else
+
+struct DomainDecompositionTeamH::Shared {};
+
+#endif
+
+DomainDecompositionTeamH::DomainDecompositionTeamH()
+	: mShared{}, mMappingSize{}, mWorkerCount{}, mWidth{}, mHeight{}
+{
+}
+
+DomainDecompositionTeamH::~DomainDecompositionTeamH()
+{
+	stop();
+}
+
+bool DomainDecompositionTeamH::start(size_t processCount, size_t width, size_t height)
+{
+	stop();
+
+#ifdef __linux__
+	// Au moins une rangée intérieure par travailleur.
+	if (processCount < 1 || width < 3 || height < 3 || processCount > height - 2)
+		return false;
+
+	mMappingSize = sizeof(Shared) + processCount * 4 * width + 8
+		+ processCount * COUNT_HISTORY * sizeof(uint64_t) + width * height;
+
+	void* mapping{ mmap(nullptr, mMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0) };
+	if (mapping == MAP_FAILED) {
+		mMappingSize = 0;
+		return false;
+	}
+
+	mShared = static_cast<Shared*>(mapping);
+
+	pthread_barrierattr_t attributes;
+	pthread_barrierattr_init(&attributes);
+	pthread_barrierattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+	pthread_barrier_init(&mShared->control, &attributes, static_cast<unsigned>(processCount + 1));
+	pthread_barrier_init(&mShared->step, &attributes, static_cast<unsigned>(processCount));
+	pthread_barrierattr_destroy(&attributes);
+
+	mWidth = width;
+	mHeight = height;
+
+	auto const interior{ height - 2 };
+	size_t rowBegin{ 1 };
+
+	for (size_t worker{}; worker < processCount; ++worker) {
+		auto const rows{ interior / processCount + (worker < interior % processCount ? 1 : 0) };
+
+		pid_t const pid{ fork() };
+		if (pid == 0) {
+			// Le travailleur meurt avec le coordinateur.
+			prctl(PR_SET_PDEATHSIG, SIGKILL);
+			workerLoop(mShared, worker, processCount, width, rowBegin, rows);
+		}
+
+		if (pid < 0) {
+			// Les travailleurs déjà créés attendent sur une barrière qui ne
+			// sera jamais complète : on les termine directement.
+			for (auto created : mPids) {
+				kill(created, SIGKILL);
+				waitpid(created, nullptr, 0);
+			}
+			mPids.clear();
+			munmap(mShared, mMappingSize);
+			mShared = nullptr;
+			mMappingSize = 0;
+			return false;
+		}
+
+		mPids.push_back(pid);
+		rowBegin += rows;
+	}
+
+	mWorkerCount = processCount;
+	return true;
+#else
+	(void)processCount;
+	(void)width;
+	(void)height;
+	return false;
+#endif
+}
+
+void DomainDecompositionTeamH::stop()
+{
+#ifdef __linux__
+	if (!running())
+		return;
+
+	mShared->command = Command::quit;
+	pthread_barrier_wait(&mShared->control);
+
+	for (auto pid : mPids)
+		waitpid(pid, nullptr, 0);
+	mPids.clear();
+
+	pthread_barrier_destroy(&mShared->control);
+	pthread_barrier_destroy(&mShared->step);
+	munmap(mShared, mMappingSize);
+	mShared = nullptr;
+	mMappingSize = 0;
+	mWorkerCount = 0;
+#endif
+}
+
+void DomainDecompositionTeamH::load(const uint8_t* grid, uint32_t parsedRule, NeighborhoodTeamH::Mask neighborhood)
+{
+#ifdef __linux__
+	if (!running())
+		return;
+
+	memcpy(mShared->grid(mWidth, mWorkerCount), grid, mWidth * mHeight);
+	mShared->parsedRule = parsedRule;
+	mShared->neighborhood = neighborhood;
+	command(Command::load);
+#else
+	(void)grid;
+	(void)parsedRule;
+	(void)neighborhood;
+#endif
+}
+
+void DomainDecompositionTeamH::run(size_t steps, std::vector<size_t>& aliveCounts)
+{
+	aliveCounts.clear();
+
+#ifdef __linux__
+	if (!running() || steps == 0)
+		return;
+
+	mShared->steps = steps;
+	command(Command::run);
+
+	for (size_t generation{ steps - std::min(steps, COUNT_HISTORY) }; generation < steps; ++generation) {
+		size_t aliveCount{};
+		for (size_t worker{}; worker < mWorkerCount; ++worker)
+			aliveCount += mShared->counts(mWidth, mWorkerCount, worker)[generation % COUNT_HISTORY];
+		aliveCounts.push_back(aliveCount);
+	}
+#endif
+}
+
+void DomainDecompositionTeamH::gather(uint8_t* grid)
+{
+#ifdef __linux__
+	if (!running())
+		return;
+
+	command(Command::gather);
+	memcpy(grid + mWidth, mShared->grid(mWidth, mWorkerCount) + mWidth, (mHeight - 2) * mWidth);
+#else
+	(void)grid;
+#endif
+}
+
+// Envoie une commande et attend que tous les travailleurs l'aient terminée.
+void DomainDecompositionTeamH::command(uint32_t command)
+{
+#ifdef __linux__
+	mShared->command = command;
+	pthread_barrier_wait(&mShared->control);	// Départ
+	pthread_barrier_wait(&mShared->control);	// Fin
+#else
+	(void)command;
+#endif
+}
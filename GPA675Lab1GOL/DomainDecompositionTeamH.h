@@ -0,0 +1,91 @@
+﻿#pragma once
+#ifndef DOMAINDECOMPOSITIONTEAMH_H
+#define DOMAINDECOMPOSITIONTEAMH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "NeighborhoodTeamH.h"
+
+// Fichier : DomainDecompositionTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/16
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe DomainDecompositionTeamH
+//
+// Simulation répartie sur plusieurs processus (Linux seulement).
+//
+// L'intérieur de la grille est découpé en tranches horizontales. Chaque
+// processus travailleur (fork) conserve sa tranche dans sa propre mémoire,
+// entourée d'une rangée fantôme en haut et en bas. À chaque génération, les
+// travailleurs publient leur première et leur dernière rangée dans une
+// mémoire partagée (mmap MAP_SHARED), se synchronisent sur une barrière
+// inter-processus, puis copient les rangées de leurs voisins dans leurs
+// rangées fantômes. Les rangées publiées alternent entre deux zones selon
+// la parité de la génération : une seule barrière par génération suffit.
+//
+// Le coordinateur (le processus appelant) envoie les commandes load, run et
+// gather, puis recueille le nombre de cellules vivantes des dernières
+// générations. La grille complète n'est rassemblée que par gather().
+//
+// La bordure de la grille est fixe (immutableAsIs, foreverDead,
+// foreverAlive) : elle est chargée une fois dans les tranches et n'est
+// jamais recalculée. warping et mirror ne sont pas supportés. GOLTeamH ne
+// répartit que si sa bordure est identique dans ses deux grilles.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class DomainDecompositionTeamH
+{
+public:
+	// Nombre de générations dont le compte de cellules vivantes est conservé.
+	static constexpr size_t COUNT_HISTORY{ 16 };
+
+#ifdef __linux__
+	static constexpr bool supported{ true };
+#else
+	static constexpr bool supported{ false };
+#endif
+
+	DomainDecompositionTeamH();
+	DomainDecompositionTeamH(DomainDecompositionTeamH const&) = delete;
+	DomainDecompositionTeamH& operator=(DomainDecompositionTeamH const&) = delete;
+	~DomainDecompositionTeamH();
+
+	// Crée `processCount` travailleurs pour une grille width x height
+	// (bordure incluse). Retourne false si ce n'est pas possible.
+	bool start(size_t processCount, size_t width, size_t height);
+	void stop();
+
+	bool running() const { return mWorkerCount > 0; }
+	size_t processCount() const { return mWorkerCount; }
+	size_t width() const { return mWidth; }
+	size_t height() const { return mHeight; }
+
+	// Copie la grille (width * height octets) dans les tranches.
+	void load(const uint8_t* grid, uint32_t parsedRule, NeighborhoodTeamH::Mask neighborhood);
+
+	// Fait évoluer les tranches de `steps` générations. `aliveCounts` reçoit
+	// le nombre de cellules vivantes (intérieur) des min(steps, COUNT_HISTORY)
+	// dernières générations, de la plus ancienne à la plus récente.
+	void run(size_t steps, std::vector<size_t>& aliveCounts);
+
+	// Rassemble les tranches dans `grid` (l'intérieur seulement).
+	void gather(uint8_t* grid);
+
+private:
+	struct Shared;
+
+	Shared* mShared;
+	size_t mMappingSize;
+	std::vector<int> mPids;
+	size_t mWorkerCount, mWidth, mHeight;
+
+	void command(uint32_t command);
+	[[noreturn]] static void workerLoop(Shared* shared, size_t worker, size_t workerCount,
+		size_t width, size_t rowBegin, size_t rows);
+};
+
+#endif // DOMAINDECOMPOSITIONTEAMH_H
@@ -0,0 +1,106 @@
+﻿#include "EditQueueTeamH.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+EditQueueTeamH::Edit EditQueueTeamH::Edit::cell(int x, int y, GOL::State state)
+{
+	return Edit{ .type = Type::cell, .state = state,
+		.borderManagement = GOL::BorderManagement::immutableAsIs, .centered = false,
+		.x = x, .y = y, .percentAlive = 0.0, .text = {} };
+}
+
+EditQueueTeamH::Edit EditQueueTeamH::Edit::fill(GOL::State state)
+{
+	return Edit{ .type = Type::fill, .state = state,
+		.borderManagement = GOL::BorderManagement::immutableAsIs, .centered = false,
+		.x = 0, .y = 0, .percentAlive = 0.0, .text = {} };
+}
+
+EditQueueTeamH::Edit EditQueueTeamH::Edit::fillAlternately(GOL::State firstCell)
+{
+	return Edit{ .type = Type::fillAlternately, .state = firstCell,
+		.borderManagement = GOL::BorderManagement::immutableAsIs, .centered = false,
+		.x = 0, .y = 0, .percentAlive = 0.0, .text = {} };
+}
+
+EditQueueTeamH::Edit EditQueueTeamH::Edit::randomize(double percentAlive)
+{
+	return Edit{ .type = Type::randomize, .state = GOL::State::dead,
+		.borderManagement = GOL::BorderManagement::immutableAsIs, .centered = false,
+		.x = 0, .y = 0, .percentAlive = percentAlive, .text = {} };
+}
+
+EditQueueTeamH::Edit EditQueueTeamH::Edit::pattern(std::string pattern)
+{
+	return Edit{ .type = Type::pattern, .state = GOL::State::dead,
+		.borderManagement = GOL::BorderManagement::immutableAsIs, .centered = true,
+		.x = 0, .y = 0, .percentAlive = 0.0, .text = std::move(pattern) };
+}
+
+EditQueueTeamH::Edit EditQueueTeamH::Edit::pattern(std::string pattern, int centerX, int centerY)
+{
+	return Edit{ .type = Type::pattern, .state = GOL::State::dead,
+		.borderManagement = GOL::BorderManagement::immutableAsIs, .centered = false,
+		.x = centerX, .y = centerY, .percentAlive = 0.0, .text = std::move(pattern) };
+}
+
+EditQueueTeamH::Edit EditQueueTeamH::Edit::rule(std::string rule)
+{
+	return Edit{ .type = Type::rule, .state = GOL::State::dead,
+		.borderManagement = GOL::BorderManagement::immutableAsIs, .centered = false,
+		.x = 0, .y = 0, .percentAlive = 0.0, .text = std::move(rule) };
+}
+
+EditQueueTeamH::Edit EditQueueTeamH::Edit::border(GOL::BorderManagement borderManagement)
+{
+	return Edit{ .type = Type::borderManagement, .state = GOL::State::dead,
+		.borderManagement = borderManagement, .centered = false,
+		.x = 0, .y = 0, .percentAlive = 0.0, .text = {} };
+}
+
+EditQueueTeamH::EditQueueTeamH(size_t capacity)
+	: mSlots{ std::make_unique<Slot[]>(std::bit_ceil(std::max<size_t>(capacity, 2))) }
+	, mMask{ std::bit_ceil(std::max<size_t>(capacity, 2)) - 1 }
+	, mTail{}, mHead{}, mDropped{}
+{
+	// Case i : libre pour la position i.
+	for (size_t i{}; i <= mMask; ++i)
+		mSlots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+//! \brief Dépose une modification dans la file.
+//!
+//! \details La case de la position `tail` est libre lorsque son numéro vaut
+//! `tail` ; plus petit, elle n'a pas encore été lue au tour précédent (file
+//! pleine). Plus grand, un autre producteur l'a réservée entre-temps : on
+//! relit la queue.
+bool EditQueueTeamH::push(Edit edit)
+{
+	auto tail{ mTail.load(std::memory_order_relaxed) };
+	for (;;) {
+		auto& slot{ mSlots[tail & mMask] };
+		auto const sequence{ slot.sequence.load(std::memory_order_acquire) };
+		auto const difference{ static_cast<std::ptrdiff_t>(sequence - tail) };
+
+		if (difference == 0) {
+			if (mTail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+				slot.edit = std::move(edit);
+				slot.sequence.store(tail + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (difference < 0) {
+			mDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+			tail = mTail.load(std::memory_order_relaxed);
+	}
+}
+
+bool EditQueueTeamH::empty() const
+{
+	return mSlots[mHead & mMask].sequence.load(std::memory_order_acquire) != mHead + 1;
+}
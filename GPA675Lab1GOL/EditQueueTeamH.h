@@ -0,0 +1,114 @@
+﻿#pragma once
+#ifndef EDITQUEUETEAMH_H
+#define EDITQUEUETEAMH_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "GOL.h"
+
+// Fichier : EditQueueTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/03/02
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe EditQueueTeamH
+//
+// File bornée de modifications de la grille (cellule, remplissage, patron,
+// règle...) déposées par n'importe quel fil et appliquées par le fil de
+// simulation entre deux générations (voir GOLTeamH::post).
+//
+// Anneau sans verrou à plusieurs producteurs et un consommateur : chaque
+// case porte un numéro de séquence. Un producteur réserve une case par
+// compare-and-swap sur la queue, y écrit la modification puis publie la
+// case en avançant son numéro ; le consommateur lit les cases publiées dans
+// l'ordre. Aucun fil n'attend l'autre : si la file est pleine, push()
+// retourne false (la modification est abandonnée, voir dropped()).
+//
+// push() peut être appelée de n'importe quel fil ; empty() et drain()
+// seulement du fil consommateur.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class EditQueueTeamH
+{
+public:
+	static constexpr size_t DEFAULT_CAPACITY{ 4096 };
+
+	// Modification de la grille. Les coordonnées sont celles de
+	// GOLTeamH::setState.
+	struct Edit {
+		enum class Type : uint8_t {
+			cell, fill, fillAlternately, randomize, pattern, rule, borderManagement
+		};
+
+		Type type{};
+		GOL::State state{};
+		GOL::BorderManagement borderManagement{};
+		bool centered{};		// pattern : centré dans la grille
+		int x{}, y{};			// cell : la cellule ; pattern : le centre
+		double percentAlive{};
+		std::string text;		// pattern, rule
+
+		static Edit cell(int x, int y, GOL::State state);
+		static Edit fill(GOL::State state);
+		static Edit fillAlternately(GOL::State firstCell);
+		static Edit randomize(double percentAlive);
+		static Edit pattern(std::string pattern);
+		static Edit pattern(std::string pattern, int centerX, int centerY);
+		static Edit rule(std::string rule);
+		static Edit border(GOL::BorderManagement borderManagement);
+	};
+
+	// capacity est arrondie à la puissance de 2 supérieure.
+	explicit EditQueueTeamH(size_t capacity = DEFAULT_CAPACITY);
+	EditQueueTeamH(EditQueueTeamH const&) = delete;
+	EditQueueTeamH& operator=(EditQueueTeamH const&) = delete;
+
+	size_t capacity() const { return mMask + 1; }
+	size_t dropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+	// Producteurs. Ne bloque jamais ; false si la file est pleine.
+	bool push(Edit edit);
+
+	// Consommateur.
+	bool empty() const;
+	// Retire au plus `limit` modifications, dans l'ordre, et appelle
+	// function(edit) pour chacune. Retourne leur nombre.
+	template <typename Function>
+	size_t drain(Function function, size_t limit);
+
+private:
+	struct alignas(64) Slot {
+		std::atomic<size_t> sequence;
+		Edit edit;
+	};
+
+	std::unique_ptr<Slot[]> mSlots;
+	size_t mMask;
+	alignas(64) std::atomic<size_t> mTail;		// Prochaine case à réserver (producteurs)
+	alignas(64) size_t mHead;					// Prochaine case à lire (consommateur)
+	std::atomic<size_t> mDropped;
+};
+
+template <typename Function>
+size_t EditQueueTeamH::drain(Function function, size_t limit)
+{
+	size_t count{};
+	for (; count < limit; ++count) {
+		auto& slot{ mSlots[mHead & mMask] };
+		if (slot.sequence.load(std::memory_order_acquire) != mHead + 1)
+			break;
+
+		auto edit{ std::move(slot.edit) };
+		// La case redevient libre pour le tour suivant de l'anneau.
+		slot.sequence.store(mHead + capacity(), std::memory_order_release);
+		++mHead;
+		function(edit);
+	}
+	return count;
+}
+
+#endif // EDITQUEUETEAMH_H
@@ -0,0 +1,257 @@
+﻿#include "EnsembleTeamH.h"
+
+#include <algorithm>
+#include <random>
+
+#include "BitKernelTeamH.h"
+#include "ParsingTeamH.h"
+#include "TraceTeamH.h"
+
+namespace
+{
+	// Coordonnée i (de -1 à n) ramenée dans la grille, comme
+	// GOLTeamH::countNeighbors : warping prend le côté opposé de la grille,
+	// mirror la cellule opposée par rapport au bord.
+	size_t mapIndex(ptrdiff_t i, size_t n, GOL::BorderManagement borderManagement)
+	{
+		auto const size{ static_cast<ptrdiff_t>(n) };
+		if (i >= 0 && i < size)
+			return static_cast<size_t>(i);
+
+		if (borderManagement == GOL::BorderManagement::mirror && size > 1)
+			return static_cast<size_t>(i < 0 ? 1 : size - 2);
+
+		return static_cast<size_t>(i < 0 ? size - 1 : 0);
+	}
+}
+
+EnsembleTeamH::EnsembleTeamH()
+	: mRule{ "B3/S23" }, mParsedRule{ *ParsingTeamH::parseRule("B3/S23") }
+	, mBorderManagement{ GOL::BorderManagement::immutableAsIs }, mIteration{}
+	, mWidth{}, mHeight{}, mAliveCounts{}, mCountsValid{ true }
+{
+}
+
+void EnsembleTeamH::resize(size_t width, size_t height, GOL::State defaultState)
+{
+	if (width == 0 || height == 0)
+		width = height = 0;
+
+	mWidth = width;
+	mHeight = height;
+	mCells.assign(width * height, defaultState == GOL::State::alive ? ~Word{} : Word{});
+	mNext.assign(width * height, Word{});
+	applyBorder();
+	changed();
+}
+
+bool EnsembleTeamH::setRule(std::string const& rule)
+{
+	auto const parsed{ ParsingTeamH::parseRule(rule) };
+	if (!parsed || ParsingTeamH::parseNeighborhood(rule) != NeighborhoodTeamH::MOORE)
+		return false;
+
+	mRule = rule;
+	mParsedRule = *parsed;
+	mIteration = 0;
+	return true;
+}
+
+void EnsembleTeamH::setBorderManagement(GOL::BorderManagement borderManagement)
+{
+	mBorderManagement = borderManagement;
+	applyBorder();
+	changed();
+}
+
+GOL::State EnsembleTeamH::state(size_t lane, size_t x, size_t y) const
+{
+	return static_cast<GOL::State>((mCells[y * mWidth + x] >> lane) & 1);
+}
+
+void EnsembleTeamH::setState(size_t lane, size_t x, size_t y, GOL::State state)
+{
+	auto& cell{ mCells[y * mWidth + x] };
+	auto const bit{ Word{ 1 } << lane };
+	cell = state == GOL::State::alive ? (cell | bit) : (cell & ~bit);
+	changed();
+}
+
+void EnsembleTeamH::fill(GOL::State state)
+{
+	std::fill(mCells.begin(), mCells.end(), state == GOL::State::alive ? ~Word{} : Word{});
+	applyBorder();
+	changed();
+}
+
+void EnsembleTeamH::randomize(size_t lane, double percentAlive, uint64_t seed)
+{
+	std::mt19937_64 engine(seed);
+	std::bernoulli_distribution distribution(std::clamp(percentAlive, 0.0, 1.0));
+	auto const bit{ Word{ 1 } << lane };
+
+	for (auto& cell : mCells)
+		cell = distribution(engine) ? (cell | bit) : (cell & ~bit);
+
+	applyBorder();
+	changed();
+}
+
+// Une passe sur la grille avec un générateur par voie : même résultat que
+// randomize(k, percentAlive, seeds[k]) pour chaque voie.
+void EnsembleTeamH::randomize(double percentAlive, std::span<const uint64_t> seeds)
+{
+	auto const lanes{ std::min(seeds.size(), LANES) };
+	std::vector<std::mt19937_64> engines(seeds.begin(), seeds.begin() + lanes);
+	std::bernoulli_distribution distribution(std::clamp(percentAlive, 0.0, 1.0));
+	auto const mask{ lanes == LANES ? ~Word{} : (Word{ 1 } << lanes) - 1 };
+
+	for (auto& cell : mCells) {
+		Word drawn{};
+		for (size_t lane{}; lane < lanes; ++lane)
+			drawn |= static_cast<Word>(distribution(engines[lane])) << lane;
+		cell = (cell & ~mask) | drawn;
+	}
+
+	applyBorder();
+	changed();
+}
+
+// Fait évoluer les 64 voies d'une génération. En immutableAsIs, foreverDead
+// et foreverAlive, le contour est recopié tel quel ; en warping et mirror,
+// les rangées et colonnes voisines hors de la grille passent par mapIndex.
+void EnsembleTeamH::processOneStep()
+{
+	GOLTEAMH_TRACE_SCOPE("EnsembleTeamH::processOneStep");
+
+	bool const all{ evolvesBorder() };
+	auto const width{ mWidth }, height{ mHeight };
+
+	if (!all) {
+		// Contour fixe : première et dernière rangées, puis les côtés.
+		for (size_t y{}; y < height; ++y) {
+			auto const* row{ mCells.data() + y * width };
+			auto* next{ mNext.data() + y * width };
+			if (y == 0 || y + 1 == height)
+				std::copy(row, row + width, next);
+			else {
+				next[0] = row[0];
+				next[width - 1] = row[width - 1];
+			}
+		}
+	}
+
+	auto const rowBegin{ all ? size_t{} : size_t{ 1 } }, rowEnd{ all ? height : (height > 1 ? height - 1 : 0) };
+	for (size_t y{ rowBegin }; y < rowEnd; ++y) {
+		auto const above{ mapIndex(static_cast<ptrdiff_t>(y) - 1, height, mBorderManagement) };
+		auto const below{ mapIndex(static_cast<ptrdiff_t>(y) + 1, height, mBorderManagement) };
+		evolveRow(y, above, below, all);
+	}
+
+	mCells.swap(mNext);
+	mIteration++;
+	mCountsValid = false;
+}
+
+void EnsembleTeamH::processSteps(size_t steps)
+{
+	while (steps-- > 0)
+		processOneStep();
+}
+
+size_t EnsembleTeamH::aliveCount(size_t lane) const
+{
+	return aliveCounts()[lane];
+}
+
+// Les cellules sont additionnées en tranches de bits : planes[b] contient le
+// bit b du compte de chaque voie. Chaque ajout ne propage la retenue que
+// sur les plans touchés (2 en moyenne).
+std::array<size_t, EnsembleTeamH::LANES> const& EnsembleTeamH::aliveCounts() const
+{
+	if (mCountsValid)
+		return mAliveCounts;
+
+	std::array<Word, 64> planes{};
+	for (auto cell : mCells) {
+		auto carry{ cell };
+		for (size_t b{}; carry; ++b) {
+			auto const next{ planes[b] & carry };
+			planes[b] ^= carry;
+			carry = next;
+		}
+	}
+
+	for (size_t lane{}; lane < LANES; ++lane) {
+		size_t count{};
+		for (size_t b{}; b < planes.size(); ++b)
+			count |= static_cast<size_t>((planes[b] >> lane) & 1) << b;
+		mAliveCounts[lane] = count;
+	}
+
+	mCountsValid = true;
+	return mAliveCounts;
+}
+
+void EnsembleTeamH::extract(size_t lane, uint8_t* cells) const
+{
+	for (size_t i{}; i < mCells.size(); ++i)
+		cells[i] = static_cast<uint8_t>((mCells[i] >> lane) & 1);
+}
+
+bool EnsembleTeamH::evolvesBorder() const
+{
+	return mBorderManagement == GOL::BorderManagement::warping || mBorderManagement == GOL::BorderManagement::mirror;
+}
+
+// foreverDead et foreverAlive : le contour de toutes les voies.
+void EnsembleTeamH::applyBorder()
+{
+	if (mBorderManagement != GOL::BorderManagement::foreverDead && mBorderManagement != GOL::BorderManagement::foreverAlive)
+		return;
+
+	auto const value{ mBorderManagement == GOL::BorderManagement::foreverAlive ? ~Word{} : Word{} };
+	for (size_t y{}; y < mHeight; ++y) {
+		auto* row{ mCells.data() + y * mWidth };
+		if (y == 0 || y + 1 == mHeight)
+			std::fill(row, row + mWidth, value);
+		else {
+			row[0] = value;
+			row[mWidth - 1] = value;
+		}
+	}
+}
+
+void EnsembleTeamH::changed()
+{
+	mIteration = 0;
+	mCountsValid = false;
+}
+
+// Rangée y à partir des rangées `above` et `below`. Les colonnes 1 à
+// width - 2 lisent directement leurs voisines ; avec `edges`, les colonnes
+// 0 et width - 1 sont aussi calculées à travers mapIndex.
+void EnsembleTeamH::evolveRow(size_t y, size_t above, size_t below, bool edges)
+{
+	auto const width{ mWidth };
+	auto const rule{ mParsedRule };
+	auto const* a{ mCells.data() + above * width };
+	auto const* r{ mCells.data() + y * width };
+	auto const* b{ mCells.data() + below * width };
+	auto* next{ mNext.data() + y * width };
+
+	for (size_t x{ 1 }; x + 1 < width; ++x) {
+		auto const count{ BitKernelTeamH::sum(a[x - 1], a[x], a[x + 1], r[x - 1], r[x + 1], b[x - 1], b[x], b[x + 1]) };
+		next[x] = BitKernelTeamH::applyRule(count, r[x], rule);
+	}
+
+	if (!edges)
+		return;
+
+	for (auto const x : { size_t{}, width - 1 }) {
+		auto const left{ mapIndex(static_cast<ptrdiff_t>(x) - 1, width, mBorderManagement) };
+		auto const right{ mapIndex(static_cast<ptrdiff_t>(x) + 1, width, mBorderManagement) };
+		auto const count{ BitKernelTeamH::sum(a[left], a[x], a[right], r[left], r[right], b[left], b[x], b[right]) };
+		next[x] = BitKernelTeamH::applyRule(count, r[x], rule);
+	}
+}
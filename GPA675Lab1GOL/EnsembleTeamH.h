@@ -0,0 +1,99 @@
+﻿#pragma once
+#ifndef ENSEMBLETEAMH_H
+#define ENSEMBLETEAMH_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <GOL.h>
+
+// Fichier : EnsembleTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/21
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe EnsembleTeamH
+//
+// LANES (64) simulations indépendantes de même taille, même règle et même
+// gestion de bord, calculées ensemble. Chaque cellule est un mot de 64
+// bits : le bit k est l'état de la cellule dans la simulation k (la
+// « voie » k). Les voisins sont additionnés en tranches de bits
+// (BitKernelTeamH) : une passe sur la grille fait avancer les 64
+// simulations d'une génération, sans branche par cellule.
+//
+// Pensé pour les balayages de paramètres (par exemple des milliers de
+// soupes 256 x 256) : une seule grille, un seul appel par génération, au
+// lieu de 64 instances de GOLTeamH.
+//
+// Les coordonnées commencent à 0. Le contour (première et dernière rangées
+// et colonnes) suit les mêmes stratégies que GOLTeamH : fixe en
+// immutableAsIs, foreverDead et foreverAlive ; évalué en warping et mirror.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class EnsembleTeamH
+{
+public:
+	using Word = uint64_t;
+	static constexpr size_t LANES{ 64 };
+
+	EnsembleTeamH();
+
+	size_t width() const { return mWidth; }
+	size_t height() const { return mHeight; }
+	std::string const& rule() const { return mRule; }
+	GOL::BorderManagement borderManagement() const { return mBorderManagement; }
+	uint64_t iteration() const { return mIteration; }
+
+	// Toutes les voies sont remises à `defaultState`.
+	void resize(size_t width, size_t height, GOL::State defaultState = GOL::State::dead);
+	// « B###/S### », voisinage de Moore seulement.
+	bool setRule(std::string const& rule);
+	void setBorderManagement(GOL::BorderManagement borderManagement);
+
+	GOL::State state(size_t lane, size_t x, size_t y) const;
+	void setState(size_t lane, size_t x, size_t y, GOL::State state);
+	void fill(GOL::State state);
+
+	// Soupe aléatoire de la voie `lane`, reproductible par `seed`.
+	void randomize(size_t lane, double percentAlive, uint64_t seed);
+	// Voie k tirée avec seeds[k] ; les voies sans graine ne changent pas.
+	void randomize(double percentAlive, std::span<const uint64_t> seeds);
+
+	void processOneStep();
+	void processSteps(size_t steps);
+
+	// Nombre de cellules vivantes de chaque voie (calculé à la demande).
+	size_t aliveCount(size_t lane) const;
+	std::array<size_t, LANES> const& aliveCounts() const;
+
+	// Copie la voie `lane` dans `cells` (width * height octets, 0 ou 1),
+	// par exemple pour l'afficher ou la passer à GOLTeamH.
+	void extract(size_t lane, uint8_t* cells) const;
+
+	// Grille brute : un mot par cellule, rangée par rangée (bit k = voie k).
+	std::vector<Word> const& cells() const { return mCells; }
+
+private:
+	std::string mRule;
+	uint32_t mParsedRule;
+	GOL::BorderManagement mBorderManagement;
+	uint64_t mIteration;
+
+	size_t mWidth, mHeight;
+	std::vector<Word> mCells, mNext;
+
+	// Comptes par voie, recalculés seulement après un changement.
+	mutable std::array<size_t, LANES> mAliveCounts;
+	mutable bool mCountsValid;
+
+	bool evolvesBorder() const;
+	void applyBorder();
+	void changed();
+	void evolveRow(size_t y, size_t above, size_t below, bool edges);
+};
+
+#endif // ENSEMBLETEAMH_H
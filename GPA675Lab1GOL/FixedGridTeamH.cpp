@@ -0,0 +1,23 @@
+﻿#include "FixedGridTeamH.h"
+
+// Une seule instanciation par taille pour tout le programme.
+template class FixedGridTeamH<64, 64>;
+template class FixedGridTeamH<128, 128>;
+template class FixedGridTeamH<256, 256>;
+
+std::unique_ptr<GOL> createFixedGridTeamH(size_t width, size_t height)
+{
+	if (width != height)
+		return nullptr;
+
+	switch (width) {
+	case 64:
+		return std::make_unique<FixedGridTeamH<64, 64>>();
+	case 128:
+		return std::make_unique<FixedGridTeamH<128, 128>>();
+	case 256:
+		return std::make_unique<FixedGridTeamH<256, 256>>();
+	default:
+		return nullptr;
+	}
+}
@@ -0,0 +1,442 @@
+﻿#pragma once
+#ifndef FIXEDGRIDTEAMH_H
+#define FIXEDGRIDTEAMH_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+
+#include <GOL.h>
+#include "BitKernelTeamH.h"
+#include "ParsingTeamH.h"
+#include "TendencyTeamH.h"
+#include "TraceTeamH.h"
+
+// Fichier : FixedGridTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/23
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe FixedGridTeamH<W, H>
+//
+// Moteur pour les petites grilles dont la taille est connue à la
+// compilation (64 x 64, 128 x 128...). Les cellules sont compactées à 1 bit
+// (BitKernelTeamH) dans deux std::array membres, sans allocation : une
+// rangée de W cellules tient dans W / 64 mots. Toutes les bornes et tous
+// les pas sont des constantes ; la boucle sur les mots d'une rangée est
+// déroulée par le compilateur et chaque mot fait évoluer 64 cellules.
+//
+// W doit être un multiple de 64. La taille ne change jamais : resize()
+// n'accepte que W x H (il remplit alors la grille) ; toute autre taille est
+// une erreur de l'appelant, signalée par assert. Les tailles courantes sont
+// instanciées une fois dans FixedGridTeamH.cpp ; createFixedGridTeamH()
+// retourne le moteur de la taille demandée, ou nullptr si elle n'est pas
+// instanciée (voir GOLBench).
+//
+// Gestion de bord identique à GOLTeamH : le contour est fixe en
+// immutableAsIs, foreverDead et foreverAlive ; il évolue en warping et
+// mirror. Les coordonnées commencent à 0.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+template <size_t W, size_t H>
+class FixedGridTeamH : public GOL
+{
+	static_assert(W >= 64 && W % 64 == 0, "FixedGridTeamH : W doit etre un multiple de 64");
+	static_assert(H >= 3, "FixedGridTeamH : H doit etre au moins 3");
+
+public:
+	using Word = uint64_t;
+	static constexpr size_t WORDS{ W / 64 };	// Mots par rangée
+
+	FixedGridTeamH();
+	FixedGridTeamH(FixedGridTeamH const&) = delete;
+	FixedGridTeamH(FixedGridTeamH&&) = delete;
+	FixedGridTeamH& operator =(FixedGridTeamH const&) = delete;
+	FixedGridTeamH& operator =(FixedGridTeamH&&) = delete;
+
+	virtual ~FixedGridTeamH() = default;
+
+	// inline puisque trivial.
+	size_t width() const override { return W; }
+	size_t height() const override { return H; }
+	size_t size() const override { return W * H; }
+	State state(int x, int y) const override { return static_cast<State>(bit(cells(), static_cast<size_t>(x), static_cast<size_t>(y))); }
+	std::string rule() const override { return mRule.value_or(std::string()); }
+	BorderManagement borderManagement() const override { return mBorderManagement.value_or(GOL::BorderManagement::immutableAsIs); }
+	Color color(State state) const override { return state == GOL::State::alive ? mAliveColor : mDeadColor; }
+
+	Statistics statistics() const override;
+	ImplementationInformation information() const override;
+
+	void resize(size_t width, size_t height, State defaultState) override;
+	bool setRule(std::string const& rule) override;
+	void setBorderManagement(BorderManagement borderManagement) override;
+	void setState(int x, int y, State state) override;
+	void fill(State state) override;
+	void fillAlternately(State firstCell) override;
+	void randomize(double percentAlive) override;
+	bool setFromPattern(std::string const& pattern, int centerX, int centerY) override;
+	bool setFromPattern(std::string const& pattern) override;
+	void setSolidColor(State state, Color const& color) override;
+	void processOneStep() override;
+	void updateImage(uint32_t* buffer, size_t buffer_size) const override;
+
+private:
+	using Cells = std::array<Word, WORDS * H>;
+
+	std::optional<std::string> mRule;
+	std::optional<BorderManagement> mBorderManagement;
+	std::optional<IterationType> mIteration;
+
+	uint32_t mParsedRule;
+	size_t mAliveCount;
+
+	// Génération courante : mBuffers[mCurrent].
+	std::array<Cells, 2> mBuffers;
+	size_t mCurrent;
+
+	TendencyTeamH mTendency;
+	Color mDeadColor, mAliveColor;
+
+	std::random_device mRandomDevice;
+	std::mt19937 mEngine;
+
+	Cells& cells() { return mBuffers[mCurrent]; }
+	Cells const& cells() const { return mBuffers[mCurrent]; }
+
+	static Word bit(Cells const& cells, size_t x, size_t y) { return (cells[y * WORDS + x / 64] >> (x % 64)) & 1; }
+	static void setBit(Cells& cells, size_t x, size_t y, bool alive);
+
+	bool evolvesBorder() const;
+	void applyBorder();
+	void restart();
+};
+
+// Moteur de taille width x height, ou nullptr si cette taille n'est pas
+// instanciée.
+std::unique_ptr<GOL> createFixedGridTeamH(size_t width, size_t height);
+
+template <size_t W, size_t H>
+FixedGridTeamH<W, H>::FixedGridTeamH()
+	: mParsedRule{ *ParsingTeamH::parseRule("B3/S23") }, mAliveCount{}
+	, mBuffers{}, mCurrent{}, mDeadColor{}, mAliveColor{}, mEngine(mRandomDevice())
+{
+}
+
+//! \brief Accesseurs retournant des informations générales sur la
+//! simulation en cours.
+//!
+//! \details Voir GOLTeamH::statistics.
+template <size_t W, size_t H>
+GOL::Statistics FixedGridTeamH<W, H>::statistics() const
+{
+	auto const cells{ size() };
+	auto const relative = [cells](size_t count) { return static_cast<float>(count) / static_cast<float>(cells); };
+
+	return GOL::Statistics{
+		.rule = mRule,
+		.borderManagement = mBorderManagement,
+		.width = W,
+		.height = H,
+		.totalCells = cells,
+		.iteration = mIteration,
+		.totalDeadAbs = cells - mAliveCount,
+		.totalAliveAbs = mAliveCount,
+		.totalDeadRel = relative(cells - mAliveCount),
+		.totalAliveRel = relative(mAliveCount),
+		.tendencyAbs = static_cast<int>(std::lround(mTendency.slope())),
+		.tendencyRel = static_cast<float>(mTendency.slope() / static_cast<double>(cells))
+	};
+}
+
+//! \brief Accesseurs retournant les informations sur la réalisation
+//! de l'implémentation.
+template <size_t W, size_t H>
+GOL::ImplementationInformation FixedGridTeamH<W, H>::information() const
+{
+	return ImplementationInformation{
+		.title{"Laboratoire 1 - Grille fixe " + std::to_string(W) + " x " + std::to_string(H)},
+		.authors{{{"Leclaire-Fournier"}, {"Timothée"}, {"timothee.leclaire-fournier.1@ens.etsmtl.ca"}},
+		{{"Euzenat"}, {"Martin"}, {"martin.euzenat.1@ens.etsmtl.ca"}}},
+		.answers{{"Deux std::array de mots de 64 bits, une cellule par bit, dans l'objet lui-même. \
+Les dimensions sont des paramètres du patron."},
+		{"Les voisins de 64 cellules sont additionnés en tranches de bits ; les bornes des boucles \
+sont des constantes et la boucle d'une rangée est déroulée."},
+		{"Les couleurs sont encodées une fois par image ; le bit de la cellule sert d'indice."},
+		{"La règle est appliquée aux plans du compte des voisins (voir BitKernelTeamH)."}},
+		.optionnalComments{"La taille est fixée à la compilation : resize() n'accepte que les dimensions du patron."}
+	};
+}
+
+//! \brief Mutateur modifiant la taille de la grille de simulation.
+//!
+//! \details Les dimensions sont fixées par le patron : width et height
+//! doivent valoir W et H, et la grille est alors seulement mise à l'état
+//! passé en argument. Une autre taille est une erreur de l'appelant
+//! (assert) ; sans assert (NDEBUG), la grille reste W x H et l'appelant
+//! doit vérifier width() et height() (voir createFixedGridTeamH).
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::resize([[maybe_unused]] size_t width, [[maybe_unused]] size_t height, State defaultState)
+{
+	assert(width == W && height == H && "FixedGridTeamH : taille fixee par le patron");
+	fill(defaultState);
+}
+
+//! \brief Mutateur modifiant la règle de la simulation.
+//!
+//! \details « B###/S### », voisinage de Moore seulement.
+template <size_t W, size_t H>
+bool FixedGridTeamH<W, H>::setRule(std::string const& rule)
+{
+	auto const parsed{ ParsingTeamH::parseRule(rule) };
+	if (!parsed || ParsingTeamH::parseNeighborhood(rule) != NeighborhoodTeamH::MOORE)
+		return false;
+
+	mRule = rule;
+	mParsedRule = *parsed;
+	restart();
+	return true;
+}
+
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::setBorderManagement(BorderManagement borderManagement)
+{
+	mBorderManagement = borderManagement;
+	applyBorder();
+	restart();
+}
+
+//! \brief Mutateur modifiant l'état d'une cellule de la grille (origine 0).
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::setState(int x, int y, State state)
+{
+	setBit(cells(), static_cast<size_t>(x), static_cast<size_t>(y), state == State::alive);
+	restart();
+}
+
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::fill(State state)
+{
+	cells().fill(state == State::alive ? ~Word{} : Word{});
+	applyBorder();
+	restart();
+}
+
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::fillAlternately(State firstCell)
+{
+	// Bits pairs : colonnes paires.
+	constexpr Word EVEN{ 0x5555555555555555ull };
+	auto const first{ firstCell == State::alive ? EVEN : ~EVEN };
+
+	for (size_t y{}; y < H; ++y)
+		for (size_t k{}; k < WORDS; ++k)
+			cells()[y * WORDS + k] = y % 2 ? ~first : first;
+
+	applyBorder();
+	restart();
+}
+
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::randomize(double percentAlive)
+{
+	std::uniform_real_distribution<> distribution(0.0, 1.0);
+	for (size_t y{}; y < H; ++y)
+		for (size_t x{}; x < W; ++x)
+			setBit(cells(), x, y, distribution(mEngine) < percentAlive);
+
+	applyBorder();
+	restart();
+}
+
+//! \brief Mutateur remplissant la grille par le patron passé en argument.
+//!
+//! \details Comme LargerThanLifeTeamH::setFromPattern : la grille est vidée
+//! puis le patron est centré sur (centerX, centerY).
+template <size_t W, size_t H>
+bool FixedGridTeamH<W, H>::setFromPattern(std::string const& pattern, int centerX, int centerY)
+{
+	auto const parsed{ ParsingTeamH::parsePattern(pattern) };
+	if (!parsed)
+		return false;
+
+	cells().fill(Word{});
+
+	auto const left{ static_cast<int64_t>(centerX) - static_cast<int64_t>((parsed->width + 1) / 2) };
+	auto const top{ static_cast<int64_t>(centerY) - static_cast<int64_t>((parsed->height + 1) / 2) };
+
+	for (size_t y{}; y < parsed->height; ++y) {
+		for (size_t x{}; x < parsed->width; ++x) {
+			auto const destX{ left + static_cast<int64_t>(x) }, destY{ top + static_cast<int64_t>(y) };
+			if (destX >= 0 && destY >= 0 && destX < static_cast<int64_t>(W) && destY < static_cast<int64_t>(H))
+				setBit(cells(), static_cast<size_t>(destX), static_cast<size_t>(destY), parsed->cells[y * parsed->width + x] != '0');
+		}
+	}
+
+	applyBorder();
+	restart();
+	return true;
+}
+
+//! \brief Surcharge centrant le patron dans la grille.
+template <size_t W, size_t H>
+bool FixedGridTeamH<W, H>::setFromPattern(std::string const& pattern)
+{
+	return setFromPattern(pattern, static_cast<int>(W / 2), static_cast<int>(H / 2));
+}
+
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::setSolidColor(State state, Color const& color)
+{
+	if (state == State::alive)
+		mAliveColor = color;
+	else
+		mDeadColor = color;
+}
+
+//! \brief Fonction effectuant une itération de la simulation.
+//!
+//! \details Chaque mot est calculé par BitKernelTeamH::evolve à partir des
+//! mots voisins. Le bit qui entre par la gauche du premier mot d'une rangée
+//! (et par la droite du dernier) vient de la colonne opposée en warping et
+//! de la colonne 1 (resp. W - 2) en mirror. En immutableAsIs, foreverDead
+//! et foreverAlive, les rangées 0 et H - 1 et les colonnes 0 et W - 1 sont
+//! recopiées.
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::processOneStep()
+{
+	GOLTEAMH_TRACE_SCOPE("FixedGridTeamH::processOneStep");
+
+	auto const& current{ cells() };
+	auto& next{ mBuffers[1 - mCurrent] };
+	auto const rule{ mParsedRule };
+	bool const all{ evolvesBorder() };
+	bool const mirror{ borderManagement() == BorderManagement::mirror };
+
+	// Bit 63 du mot à gauche de la colonne 0 et bit 0 du mot à droite de la
+	// colonne W - 1.
+	auto const west = [mirror](const Word* row) { return mirror ? row[0] << 62 : row[WORDS - 1]; };
+	auto const east = [mirror](const Word* row) { return mirror ? row[WORDS - 1] >> 62 : row[0]; };
+
+	size_t aliveCount{};
+	auto const rowBegin{ all ? size_t{} : size_t{ 1 } }, rowEnd{ all ? H : H - 1 };
+
+	for (size_t y{ rowBegin }; y < rowEnd; ++y) {
+		auto const above{ y > 0 ? y - 1 : (mirror ? 1 : H - 1) };
+		auto const below{ y + 1 < H ? y + 1 : (mirror ? H - 2 : 0) };
+		auto const* a{ current.data() + above * WORDS };
+		auto const* r{ current.data() + y * WORDS };
+		auto const* b{ current.data() + below * WORDS };
+		auto* n{ next.data() + y * WORDS };
+
+		for (size_t k{}; k < WORDS; ++k) {
+			auto const previous{ k > 0 ? k - 1 : 0 }, following{ k + 1 < WORDS ? k + 1 : 0 };
+			n[k] = BitKernelTeamH::evolve(a[k], r[k], b[k],
+				k > 0 ? a[previous] : west(a), k > 0 ? r[previous] : west(r), k > 0 ? b[previous] : west(b),
+				k + 1 < WORDS ? a[following] : east(a), k + 1 < WORDS ? r[following] : east(r), k + 1 < WORDS ? b[following] : east(b),
+				rule);
+		}
+
+		if (!all) {
+			// Colonnes 0 et W - 1 : inchangées.
+			constexpr Word FIRST{ 1 }, LAST{ Word{ 1 } << 63 };
+			n[0] = (n[0] & ~FIRST) | (r[0] & FIRST);
+			n[WORDS - 1] = (n[WORDS - 1] & ~LAST) | (r[WORDS - 1] & LAST);
+		}
+
+		for (size_t k{}; k < WORDS; ++k)
+			aliveCount += static_cast<size_t>(std::popcount(n[k]));
+	}
+
+	if (!all) {
+		for (auto const y : { size_t{}, H - 1 }) {
+			for (size_t k{}; k < WORDS; ++k) {
+				next[y * WORDS + k] = current[y * WORDS + k];
+				aliveCount += static_cast<size_t>(std::popcount(current[y * WORDS + k]));
+			}
+		}
+	}
+
+	mCurrent = 1 - mCurrent;
+	mAliveCount = aliveCount;
+	mTendency.push(aliveCount);
+	mIteration = mIteration.value_or(0) + 1;
+}
+
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::updateImage(uint32_t* buffer, size_t buffer_size) const
+{
+	if (buffer == nullptr)
+		return;
+
+	GOLTEAMH_TRACE_SCOPE("FixedGridTeamH::updateImage");
+
+	auto const encode = [](Color const& color) {
+		return 0xFF000000u | static_cast<uint32_t>(color.red) << 16 | static_cast<uint32_t>(color.green) << 8 | color.blue;
+		};
+	uint32_t const colors[2]{ encode(mDeadColor), encode(mAliveColor) };
+
+	auto const pixels{ std::min(buffer_size, W * H) };
+	for (size_t i{}; i < pixels; ++i)
+		buffer[i] = colors[(cells()[i / 64] >> (i % 64)) & 1];
+
+	std::fill(buffer + pixels, buffer + buffer_size, 0u);
+}
+
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::setBit(Cells& cells, size_t x, size_t y, bool alive)
+{
+	auto& word{ cells[y * WORDS + x / 64] };
+	auto const mask{ Word{ 1 } << (x % 64) };
+	word = alive ? (word | mask) : (word & ~mask);
+}
+
+template <size_t W, size_t H>
+bool FixedGridTeamH<W, H>::evolvesBorder() const
+{
+	auto const bm{ borderManagement() };
+	return bm == BorderManagement::warping || bm == BorderManagement::mirror;
+}
+
+// foreverDead et foreverAlive : le contour prend sa valeur.
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::applyBorder()
+{
+	auto const bm{ borderManagement() };
+	if (bm != BorderManagement::foreverDead && bm != BorderManagement::foreverAlive)
+		return;
+
+	bool const alive{ bm == BorderManagement::foreverAlive };
+	for (auto const y : { size_t{}, H - 1 })
+		std::fill_n(cells().begin() + y * WORDS, WORDS, alive ? ~Word{} : Word{});
+
+	for (size_t y{ 1 }; y + 1 < H; ++y) {
+		setBit(cells(), 0, y, alive);
+		setBit(cells(), W - 1, y, alive);
+	}
+}
+
+template <size_t W, size_t H>
+void FixedGridTeamH<W, H>::restart()
+{
+	mIteration = 0;
+	mAliveCount = 0;
+	for (auto word : cells())
+		mAliveCount += static_cast<size_t>(std::popcount(word));
+	mTendency.reset(mAliveCount);
+}
+
+// Tailles instanciées dans FixedGridTeamH.cpp.
+extern template class FixedGridTeamH<64, 64>;
+extern template class FixedGridTeamH<128, 128>;
+extern template class FixedGridTeamH<256, 256>;
+
+#endif // FIXEDGRIDTEAMH_H
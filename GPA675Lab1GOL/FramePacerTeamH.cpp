@@ -0,0 +1,137 @@
+﻿#include "FramePacerTeamH.h"
+#include "GOLTeamH.h"
+#include "TraceTeamH.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+	// Poids d'une nouvelle mesure dans les moyennes mobiles.
+	constexpr double SMOOTHING{ 0.25 };
+
+	FramePacerTeamH::Seconds smooth(FramePacerTeamH::Seconds average, FramePacerTeamH::Seconds sample)
+	{
+		return average.count() > 0.0 ? average + (sample - average) * SMOOTHING : sample;
+	}
+}
+
+FramePacerTeamH::FramePacerTeamH(std::unique_ptr<GOL> engine, double framesPerSecond)
+	: mEngine{ std::move(engine) }, mFramesPerSecond{}, mMaxGenerations{ DEFAULT_MAX_GENERATIONS }, mGenerations{}
+	, mFrameBudget{}, mStepTime{}, mFrameTime{}, mRenderTime{}, mLastFrame{}, mHasLastFrame{}
+{
+	setFramesPerSecond(framesPerSecond);
+}
+
+GOL::ImplementationInformation FramePacerTeamH::information() const
+{
+	auto information{ mEngine->information() };
+	information.title += " (cadencé)";
+	information.optionnalComments.push_back("Plusieurs générations sont calculées par image affichée, \
+selon le budget de temps d'une image (voir FramePacerTeamH.h).");
+	return information;
+}
+
+//! \brief Redimensionne le moteur enveloppé.
+//!
+//! \details La durée d'une génération change avec la taille : les mesures
+//! repartent de zéro.
+void FramePacerTeamH::resize(size_t width, size_t height, State defaultState)
+{
+	mEngine->resize(width, height, defaultState);
+	resetMeasures();
+}
+
+bool FramePacerTeamH::setRule(std::string const& rule)
+{
+	if (!mEngine->setRule(rule))
+		return false;
+
+	resetMeasures();
+	return true;
+}
+
+void FramePacerTeamH::setBorderManagement(BorderManagement borderManagement)
+{
+	mEngine->setBorderManagement(borderManagement);
+	resetMeasures();
+}
+
+//! \brief Calcule les générations d'une image.
+//!
+//! \details Le budget est la durée d'une image moins la durée moyenne du
+//! rendu. Chaque lot vise la moitié du temps restant selon la durée moyenne
+//! d'une génération ; on s'arrête lorsqu'une génération de plus dépasserait
+//! le budget. Au moins une génération est calculée.
+void FramePacerTeamH::processOneStep()
+{
+	GOLTEAMH_TRACE_SCOPE("FramePacerTeamH::processOneStep");
+
+	auto const start{ Clock::now() };
+	if (mHasLastFrame)
+		mFrameTime = smooth(mFrameTime, start - mLastFrame);
+	mLastFrame = start;
+	mHasLastFrame = true;
+
+	auto const budget{ std::max(mFrameBudget - mRenderTime, Seconds{}) };
+	auto const limit{ mMaxGenerations ? mMaxGenerations : SIZE_MAX };
+	mGenerations = 0;
+
+	do {
+		Seconds const remaining{ budget - (Clock::now() - start) };
+		size_t batch{ 1 };
+		if (mStepTime.count() > 0.0 && remaining.count() > 0.0)
+			batch = static_cast<size_t>(std::max(1.0, std::floor(remaining / mStepTime / 2.0)));
+		batch = std::min(batch, limit - mGenerations);
+
+		auto const batchStart{ Clock::now() };
+		runGenerations(batch);
+		mStepTime = smooth(mStepTime, (Clock::now() - batchStart) / static_cast<double>(batch));
+		mGenerations += batch;
+	} while (mGenerations < limit && Clock::now() - start + mStepTime <= budget);
+}
+
+//! \brief Dessine la dernière génération calculée et mesure le rendu.
+void FramePacerTeamH::updateImage(uint32_t* buffer, size_t buffer_size) const
+{
+	auto const start{ Clock::now() };
+	mEngine->updateImage(buffer, buffer_size);
+	mRenderTime = smooth(mRenderTime, Clock::now() - start);
+}
+
+//! \brief Change la cadence visée.
+//!
+//! \param framesPerSecond Le nombre d'images par seconde (> 0).
+void FramePacerTeamH::setFramesPerSecond(double framesPerSecond)
+{
+	mFramesPerSecond = framesPerSecond > 0.0 ? framesPerSecond : 60.0;
+	mFrameBudget = Seconds{ 1.0 / mFramesPerSecond };
+}
+
+//! \brief Générations calculées par seconde, selon la durée moyenne entre
+//! deux images.
+double FramePacerTeamH::generationsPerSecond() const
+{
+	return mFrameTime.count() > 0.0 ? static_cast<double>(mGenerations) / mFrameTime.count() : 0.0;
+}
+
+// GOLTeamH saute les cycles détectés dans processSteps : on lui passe le
+// lot entier.
+void FramePacerTeamH::runGenerations(size_t count)
+{
+	if (auto* teamH{ dynamic_cast<GOLTeamH*>(mEngine.get()) }) {
+		teamH->processSteps(count);
+		return;
+	}
+
+	for (size_t i{}; i < count; ++i)
+		mEngine->processOneStep();
+}
+
+void FramePacerTeamH::resetMeasures()
+{
+	mStepTime = mFrameTime = Seconds{};
+	mHasLastFrame = false;
+	mGenerations = 0;
+}
@@ -0,0 +1,107 @@
+﻿#pragma once
+#ifndef FRAMEPACERTEAMH_H
+#define FRAMEPACERTEAMH_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <GOL.h>
+
+// Fichier : FramePacerTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/26
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe FramePacerTeamH
+//
+// Enveloppe d'un moteur GOL qui découple les générations par seconde des
+// images par seconde. GOLApp appelle processOneStep() puis updateImage() à
+// chaque image : ici, processOneStep() calcule autant de générations du
+// moteur enveloppé que le budget d'une image le permet, et updateImage() ne
+// dessine que la dernière.
+//
+// Le budget de calcul d'une image est la durée d'une image (1 / cadence
+// visée) moins la durée mesurée du rendu. Les générations sont faites par
+// lots : chaque lot vise la moitié du temps restant selon la durée moyenne
+// mesurée d'une génération, ce qui borne le dépassement lorsque la durée
+// change. Une image calcule toujours au moins une génération : si une seule
+// génération dépasse le budget, la cadence baisse plutôt que la simulation
+// s'arrête. Le nombre de générations par image est aussi plafonné : un
+// cycle sauté par GOLTeamH::processSteps ne coûte presque rien et ferait
+// sinon défiler les itérations par millions.
+//
+// Toutes les autres fonctions sont transmises au moteur enveloppé.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class FramePacerTeamH : public GOL
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using Seconds = std::chrono::duration<double>;
+
+	static constexpr size_t DEFAULT_MAX_GENERATIONS{ 4096 };
+
+	explicit FramePacerTeamH(std::unique_ptr<GOL> engine, double framesPerSecond = 60.0);
+	FramePacerTeamH(FramePacerTeamH const&) = delete;
+	FramePacerTeamH(FramePacerTeamH&&) = delete;
+	FramePacerTeamH& operator =(FramePacerTeamH const&) = delete;
+	FramePacerTeamH& operator =(FramePacerTeamH&&) = delete;
+
+	virtual ~FramePacerTeamH() = default;
+
+	// inline puisque trivial.
+	size_t width() const override { return mEngine->width(); }
+	size_t height() const override { return mEngine->height(); }
+	size_t size() const override { return mEngine->size(); }
+	State state(int x, int y) const override { return mEngine->state(x, y); }
+	std::string rule() const override { return mEngine->rule(); }
+	BorderManagement borderManagement() const override { return mEngine->borderManagement(); }
+	Color color(State state) const override { return mEngine->color(state); }
+	Statistics statistics() const override { return mEngine->statistics(); }
+	ImplementationInformation information() const override;
+
+	void resize(size_t width, size_t height, State defaultState) override;
+	bool setRule(std::string const& rule) override;
+	void setBorderManagement(BorderManagement borderManagement) override;
+	void setState(int x, int y, State state) override { mEngine->setState(x, y, state); }
+	void fill(State state) override { mEngine->fill(state); }
+	void fillAlternately(State firstCell) override { mEngine->fillAlternately(firstCell); }
+	void randomize(double percentAlive) override { mEngine->randomize(percentAlive); }
+	bool setFromPattern(std::string const& pattern, int centerX, int centerY) override { return mEngine->setFromPattern(pattern, centerX, centerY); }
+	bool setFromPattern(std::string const& pattern) override { return mEngine->setFromPattern(pattern); }
+	void setSolidColor(State state, Color const& color) override { mEngine->setSolidColor(state, color); }
+	void processOneStep() override;
+	void updateImage(uint32_t* buffer, size_t buffer_size) const override;
+
+	GOL& engine() { return *mEngine; }
+	GOL const& engine() const { return *mEngine; }
+
+	// Cadence visée, en images par seconde.
+	void setFramesPerSecond(double framesPerSecond);
+	double framesPerSecond() const { return mFramesPerSecond; }
+	// Nombre maximal de générations par image (0 = sans limite).
+	void setMaxGenerationsPerFrame(size_t generations) { mMaxGenerations = generations; }
+	size_t maxGenerationsPerFrame() const { return mMaxGenerations; }
+
+	// Mesures de la dernière image et moyennes mobiles.
+	size_t generationsPerFrame() const { return mGenerations; }
+	Seconds stepTime() const { return mStepTime; }
+	Seconds renderTime() const { return mRenderTime; }
+	double generationsPerSecond() const;
+
+private:
+	std::unique_ptr<GOL> mEngine;
+	double mFramesPerSecond;
+	size_t mMaxGenerations, mGenerations;
+	Seconds mFrameBudget, mStepTime, mFrameTime;
+	mutable Seconds mRenderTime;	// mutable : updateImage est const
+	Clock::time_point mLastFrame;
+	bool mHasLastFrame;
+
+	void runGenerations(size_t count);
+	void resetMeasures();
+};
+
+#endif // FRAMEPACERTEAMH_H
@@ -1,7 +1,8 @@
 ﻿#include "GOLTeamH.h"
 
 GOLTeamH::GOLTeamH()
-	: mParsedRule{}, mColorEncoded{}
+	: mParsedRule{}, mNeighborhood{ NeighborhoodTeamH::MOORE }, mColorEncoded{}, mCycleSkipping{ true }, mProcessCount{ 1 }, mDecompositionLoaded{}
+	, mTrackChanges{}, mPyramidEnabled{}
 {
 }
 
@@ -50,6 +51,47 @@ GOL::Statistics GOLTeamH::statistics() const
 	};
 }
 
+//! \brief Accesseur retournant les statistiques de statistics() ainsi que
+//! les informations propres à GOLTeamH.
+//! 
+//! \details Les durées par phase (moyenne glissante et centiles sur les 
+//! dernières itérations) ne sont présentes que si l'instrumentation est 
+//! compilée et activée (voir setInstrumentationEnabled). Les compteurs
+//! matériels (moyennes par itération et par cellule) demandent en plus
+//! setCountersEnabled.
+//! 
+//! La tendance (pente, variance résiduelle et caractère de stabilité) est
+//! calculée sur les TendencyTeamH::WINDOW_SIZE dernières itérations.
+GOLTeamH::ExtendedStatistics GOLTeamH::extendedStatistics() const
+{
+	using Phase = InstrumentationTeamH::Phase;
+
+	ExtendedStatistics stats{};
+	static_cast<Statistics&>(stats) = statistics();
+	stats.interiorTime = mInstrumentation.timing(Phase::interior);
+	stats.borderTime = mInstrumentation.timing(Phase::border);
+	stats.swapTime = mInstrumentation.timing(Phase::swap);
+	stats.statisticsTime = mInstrumentation.timing(Phase::statistics);
+	stats.renderTime = mInstrumentation.timing(Phase::render);
+	stats.interiorCounters = mInstrumentation.counters(Phase::interior, size());
+	stats.borderCounters = mInstrumentation.counters(Phase::border, size());
+	stats.swapCounters = mInstrumentation.counters(Phase::swap, size());
+	stats.statisticsCounters = mInstrumentation.counters(Phase::statistics, size());
+	stats.renderCounters = mInstrumentation.counters(Phase::render, size());
+	stats.period = mCycleDetector.period();
+	stats.tendencySlope = mData.tendencySlope();
+	stats.tendencyVariance = mData.tendencyVariance();
+	stats.tendencyStability = mData.tendencyStability();
+	if (mDecomposition.running())
+		stats.processCount = mDecomposition.processCount();
+	if (mThreadPool) {
+		stats.threadCount = mThreadPool->threadCount();
+		stats.activeTiles = mScheduler.activeTiles();
+		stats.stolenTiles = mScheduler.stolenTiles();
+	}
+	return stats;
+}
+
 //! \brief Accesseurs retournant les informations sur la réalisation 
 	//! de l'implémentation. 
 	//! 
@@ -113,9 +155,13 @@ détails nécessaires. Nous nous sommes basés sur la troisième."}
 //! 
 void GOLTeamH::resize(size_t width, size_t height, State defaultState)
 {
+	mRecorder.stop();
 	mData.resize(width, height, defaultState);
+	if (mTrackChanges)
+		mChanges.resize(width, height);
 	setBorder();
 	countLifeStatusCells();
+	resetHistory();
 }
 
 //! \brief Mutateur modifiant la règle de la simulation.
@@ -156,23 +202,24 @@ void GOLTeamH::resize(size_t width, size_t height, State defaultState)
 	//!		- elle survie si elle possède 1, 3, 5 ou 7 voisins vivants
 	//! 
 	//! La règle de Conway `B3/S23` est celle par défaut.
+	//! 
+	//! Un suffixe optionnel choisit le voisinage (voir
+	//! ParsingTeamH::parseNeighborhood) : `B2/S34H` (hexagonal), `B1/S012V`
+	//! (von Neumann) ou `B3/S23NDB` (masque). Sans suffixe, c'est Moore.
 
 bool GOLTeamH::setRule(std::string const& rule)
 {
-	mParsedRule = 0;
-	std::regex regexp(R"(B(\d+)/S(\d+))", std::regex_constants::icase);
-	std::smatch m;
+	auto const parsed{ ParsingTeamH::parseRule(rule) };
+	auto const neighborhood{ ParsingTeamH::parseNeighborhood(rule) };
 
-	if (std::regex_search(rule, m, regexp)) {
-		for (auto& i : m[1].str())
-			mParsedRule |= 1u << convertCharToNumber(i);
-
-		for (auto& i : m[2].str())
-			mParsedRule |= 1u << (convertCharToNumber(i) + 16);
+	if (!parsed || !neighborhood)
+		return false;
 
-		return true;
-	}
-	return false;
+	mRule = rule;
+	mParsedRule = *parsed;
+	mNeighborhood = *neighborhood;
+	resetHistory();
+	return true;
 }
 
 //! \brief Mutateur modifiant la stratégie de gestion de bord.
@@ -212,6 +259,7 @@ void GOLTeamH::setBorderManagement(BorderManagement borderManagement)
 	mIteration = 0;
 	setBorder();
 	countLifeStatusCells();
+	resetHistory();
 }
 
 void GOLTeamH::setBorder()
@@ -240,6 +288,7 @@ void GOLTeamH::setState(int x, int y, State state)
 	mData.setAt(x, y, state);
 	mIteration = 0;
 	countLifeStatusCells();
+	resetHistory();
 }
 
 //! \brief Mutateur remplissant de façon uniforme toutes les cellules de 
@@ -260,6 +309,7 @@ void GOLTeamH::fill(State state)
 	modifyBorderIfNecessary();
 	mIteration = 0;
 	countLifeStatusCells();
+	resetHistory();
 }
 
 //! \brief Mutateur remplissant de façon alternée toutes les cellules de
@@ -281,6 +331,7 @@ void GOLTeamH::fillAlternately(State firstCell)
 	modifyBorderIfNecessary();
 	mIteration = 0;
 	countLifeStatusCells();
+	resetHistory();
 }
 
 //! \brief Mutateur remplissant de façon aléatoire toutes les cellules de
@@ -303,6 +354,7 @@ void GOLTeamH::randomize(double percentAlive)
 	modifyBorderIfNecessary();
 	mIteration = 0;
 	countLifeStatusCells();
+	resetHistory();
 }
 
 //! \brief Mutateur remplissant la grille par le patron passé en argument.
@@ -326,6 +378,7 @@ void GOLTeamH::randomize(double percentAlive)
 
 bool GOLTeamH::setFromPattern(std::string const& pattern, int centerX, int centerY)
 {
+	GOLTEAMH_TRACE_SCOPE("setFromPattern");
 	auto sq = parsePattern(pattern);
 
 	if (!sq.has_value())
@@ -336,6 +389,7 @@ bool GOLTeamH::setFromPattern(std::string const& pattern, int centerX, int cente
 
 	mIteration = 0;
 	countLifeStatusCells();
+	resetHistory();
 	return true;
 }
 
@@ -352,6 +406,7 @@ bool GOLTeamH::setFromPattern(std::string const& pattern, int centerX, int cente
 
 bool GOLTeamH::setFromPattern(std::string const& pattern)
 {
+	GOLTEAMH_TRACE_SCOPE("setFromPattern");
 	auto sq = parsePattern(pattern);
 
 	if (!sq.has_value())
@@ -362,6 +417,7 @@ bool GOLTeamH::setFromPattern(std::string const& pattern)
 
 	mIteration = 0;
 	countLifeStatusCells();
+	resetHistory();
 	return true;
 }
 
@@ -409,74 +465,585 @@ void GOLTeamH::setSolidColor(State state, Color const& color)
 
 void GOLTeamH::processOneStep()
 {
-	// Pour des raisons de performance, on accède à la grille interne.
-	//
-	// Les variables suivantes sont utilisées afin d'éviter des appels de fonctions
-	// qui peuvent prendre beaucoup de temps.
-	auto const widthNoBorder{ mData.width() - 2 }, heightNoBorder{ mData.height() - 2 };
-	auto const offset{ mData.width() };
+	GOLTEAMH_TRACE_SCOPE("processOneStep");
 
-	size_t neighborsAliveCount{}, aliveCount{};
+	applyEdits();
+	pushHistory();
+	if (useDecomposition()) {
+		processDistributed(1);
+		return;
+	}
 
-	// On commence à la première case qui n'est pas dans le border pour sauver une opération
-	// par cycle.
-	// Pointeur du tableau intermédiaire.
-	auto* ptrGridInt{ reinterpret_cast<uint8_t*>(mData.intData()) + (offset + 1) };
+	// La grille change ici : les tranches des travailleurs ne sont plus à jour.
+	mDecompositionLoaded = false;
 
-	// Pointeur qui se promène en mémoire.
-	auto* ptrGrid{ reinterpret_cast<uint8_t*>(mData.data()) };
+	// Cycle de période 1 ou 2 déjà détecté : la prochaine génération est
+	// connue sans calcul.
+	if (skipCycle()) {
+		updatePyramid();
+		pushHistory();
+		return;
+	}
 
-	for (size_t j{ 1 }; j < heightNoBorder + 1; ++j) {
-		for (size_t i{ 1 }; i < widthNoBorder + 1; ++i) {
-			neighborsAliveCount = 0;
+	KernelResult result{};
+	if (mTrackChanges)
+		mChanges.clear();
 
-			// Top
-			neighborsAliveCount += *ptrGrid;
-			ptrGrid++;
-			neighborsAliveCount += *ptrGrid;
-			ptrGrid++;
-			neighborsAliveCount += *ptrGrid;
+	{
+		GOLTEAMH_TIME_PHASE(mInstrumentation, interior);
+		result = mThreadPool && mInstrumentation.countersEnabled() ? processInteriorCounted() : processInterior();
+	}
+	{
+		GOLTEAMH_TIME_PHASE(mInstrumentation, border);
+		modifyBorderIfNecessary();
+	}
+	{
+		GOLTEAMH_TIME_PHASE(mInstrumentation, swap);
+		mData.switchToIntermediate(); // Mise à jour de la grille
+	}
+	{
+		// Le noyau a déjà compté les cellules vivantes : cette phase mesure
+		// le suivi qui dépend de la nouvelle génération.
+		GOLTEAMH_TIME_PHASE(mInstrumentation, statistics);
+		if (mTrackChanges)
+			recordBorderChanges();
+		updatePyramid();
+		mIteration = mIteration.value_or(0) + 1;
+		mData.setAliveCount(result.aliveCount);
+		mCycleDetector.push(result.hash + hashBorder());
+
+		if (mRecorder.isRecording())
+			mRecorder.record(mIteration.value(), mData);
+		pushHistory();
+	}
+}
 
-			// Milieu
-			ptrGrid += offset - 2;
-			neighborsAliveCount += *ptrGrid;
-			ptrGrid += 2;
-			neighborsAliveCount += *ptrGrid;
+//! \brief Fait évoluer la simulation de plusieurs itérations.
+//! 
+//! \details Équivalent à appeler processOneStep() `steps` fois. Si un cycle
+//! de période p a été détecté, les multiples de p itérations sont sautés
+//! sans calcul : seul le compteur d'itérations avance. Pendant un
+//! enregistrement ou sans saut de cycle (setCycleSkipping), toutes les
+//! générations sont calculées.
+//! 
+//! Si la simulation est répartie (setProcessCount), les `steps` itérations
+//! sont faites par les travailleurs et la grille n'est rassemblée qu'à la
+//! fin : de grands `steps` amortissent ce rassemblement.
+//! 
+//! \param steps Le nombre d'itérations.
+void GOLTeamH::processSteps(size_t steps)
+{
+	applyEdits();
+	if (useDecomposition()) {
+		processDistributed(steps);
+		return;
+	}
 
+	while (steps > 0) {
+		applyEdits();
+		auto const period{ mCycleDetector.period() };
+
+		if (mCycleSkipping && period && steps >= *period && !mRecorder.isRecording()) {
+			auto const skipped{ steps - steps % *period };
+			pushHistory();
+			mIteration = static_cast<IterationType>(mIteration.value_or(0) + skipped);
+			mData.repeatAliveCounts(*period, skipped);
+			pushHistory();
+			steps -= skipped;
+			continue;
+		}
 
-			// Dessous
-			ptrGrid += offset - 2;
-			neighborsAliveCount += *ptrGrid;
-			ptrGrid++;
-			neighborsAliveCount += *ptrGrid;
-			ptrGrid++;
-			neighborsAliveCount += *ptrGrid;
+		processOneStep();
+		steps--;
+	}
+}
 
-			// On retourne à une place plus loin qu'à l'origine.
-			ptrGrid -= (2 * offset) + 1;
-			ptrGridInt++;
+//! \brief Applique les modifications déposées par post().
+//!
+//! \details Appelée par le fil de simulation entre deux générations. Les
+//! modifications de cellules consécutives sont appliquées directement dans
+//! la grille, en ajustant le compte des cellules vivantes ; l'itération et
+//! les caches ne sont remis à zéro qu'une fois pour tout le lot. Les autres
+//! modifications passent par le mutateur correspondant. Au plus une
+//! capacité de file est retirée par appel : des producteurs rapides ne
+//! retiennent pas la simulation indéfiniment.
+//!
+//! \return Le nombre de modifications retirées de la file.
+size_t GOLTeamH::applyEdits()
+{
+	if (mEdits.empty())
+		return 0;
+
+	GOLTEAMH_TRACE_SCOPE("applyEdits");
+
+	using Type = EditQueueTeamH::Edit::Type;
+	auto aliveCount{ mData.totalAlive() };
+	bool cellsChanged{};
+
+	// Termine le lot de modifications de cellules en cours.
+	auto const flush = [this, &aliveCount, &cellsChanged]() {
+		if (!cellsChanged)
+			return;
+		mIteration = 0;
+		mData.resetAliveCount(aliveCount);
+		resetHistory();
+		cellsChanged = false;
+		};
 
-			// On prend avantage du fait que GOL::State::alive = 1.
-			// 
-			// On accède à la bonne partie des bits et on compare si le bit de survie/réanimation est
-			// présent. Voir GOLTeamH.cpp pour plus de détails.
-			*(ptrGridInt - 1) = ((mParsedRule >> *(ptrGrid + offset) * 16) >> neighborsAliveCount) & 1;
+	auto const applied{ mEdits.drain([&](EditQueueTeamH::Edit& edit) {
+		if (edit.type == Type::cell) {
+			// Une modification déposée avant un redimensionnement peut sortir
+			// de la grille.
+			if (edit.x < 1 || edit.y < 1 || static_cast<size_t>(edit.x) > mData.width() || static_cast<size_t>(edit.y) > mData.height())
+				return;
+
+			if (mData.value(edit.x, edit.y) != edit.state) {
+				mData.setAt(edit.x, edit.y, edit.state);
+				if (edit.state == State::alive)
+					++aliveCount;
+				else
+					--aliveCount;
+			}
+			cellsChanged = true;
+			return;
+		}
 
-			aliveCount += *(ptrGridInt - 1);
+		flush();
+		switch (edit.type) {
+		case Type::fill:
+			fill(edit.state);
+			break;
+		case Type::fillAlternately:
+			fillAlternately(edit.state);
+			break;
+		case Type::randomize:
+			randomize(edit.percentAlive);
+			break;
+		case Type::pattern:
+			if (edit.centered)
+				setFromPattern(edit.text);
+			else
+				setFromPattern(edit.text, edit.x, edit.y);
+			break;
+		case Type::rule:
+			setRule(edit.text);
+			break;
+		case Type::borderManagement:
+			setBorderManagement(edit.borderManagement);
+			break;
+		default:
+			break;
 		}
+		aliveCount = mData.totalAlive();
+		}, mEdits.capacity()) };
 
-		// On saute le border
-		ptrGrid += 2;
-		ptrGridInt += 2;
+	flush();
+	return applied;
+}
+
+// Avance d'une génération sans calcul lorsque la période détectée est 1
+// (rien ne change) ou 2 (le tableau intermédiaire contient déjà la
+// génération précédente, qui est aussi la suivante).
+bool GOLTeamH::skipCycle()
+{
+	auto const period{ mCycleDetector.period() };
+	if (!mCycleSkipping || !period || *period > 2 || mRecorder.isRecording())
+		return false;
+
+	// Période 2 : les cellules qui changent sont celles de l'itération
+	// précédente. Période 1 : aucune.
+	if (*period == 2) {
+		mData.switchToIntermediate();
+		mData.setAliveCount(mData.lastGenAlive());
+	}
+	else {
+		mData.setAliveCount(mData.totalAlive());
+		if (mTrackChanges)
+			mChanges.clear();
 	}
 
-	ptrGrid = nullptr;
-	ptrGridInt = nullptr;
+	mIteration = mIteration.value_or(0) + 1;
+	return true;
+}
 
-	modifyBorderIfNecessary();
-	mData.switchToIntermediate(); // Mise à jour de la grille
-	mIteration.value()++;
-	mData.setAliveCount(aliveCount);
+void GOLTeamH::resetHistory()
+{
+	invalidateCaches();
+	mHistory.clear();
+}
+
+// Tout ce qui est déduit des générations précédentes.
+void GOLTeamH::invalidateCaches()
+{
+	mCycleDetector.reset();
+	mScheduler.invalidate();
+	mDecompositionLoaded = false;
+	mChanges.invalidate();
+	mPyramid.invalidate();
+}
+
+// Les tuiles changées à cette itération sont recalculées dans la pyramide ;
+// sans ensemble valide, elle sera reconstruite au besoin. À la période 2,
+// les cellules qui changent sont celles de l'itération précédente.
+void GOLTeamH::updatePyramid()
+{
+	if (mPyramidEnabled && mChanges.valid())
+		mPyramid.update(mData, mChanges);
+	else
+		mPyramid.invalidate();
+}
+
+// Ajoute la génération courante à l'historique, si elle n'y est pas déjà.
+void GOLTeamH::pushHistory()
+{
+	auto const iteration{ mIteration.value_or(0) };
+	if (mHistory.enabled() && mHistory.position() != iteration)
+		mHistory.push(iteration, mData.totalAlive(), mData);
+}
+
+// La répartition exige une bordure fixe (les travailleurs ne calculent que
+// l'intérieur et chargent la bordure une seule fois) et des rangées
+// contiguës (rowMajor) ; elle est suspendue pendant un enregistrement. Le
+// calcul local ne recalcule pas la bordure d'immutableAsIs, foreverDead et
+// foreverAlive, mais échange les deux grilles à chaque génération : la
+// bordure n'est fixe que si elle est identique dans les deux (elle ne l'est
+// pas, par exemple, après setState() ou randomize() sous immutableAsIs).
+bool GOLTeamH::useDecomposition() const
+{
+	auto const bm{ mBorderManagement.value_or(BorderManagement::immutableAsIs) };
+
+	return mProcessCount > 1 && !mRecorder.isRecording() && mData.layout() == GridTeamH::Layout::rowMajor &&
+		bm != BorderManagement::warping && bm != BorderManagement::mirror && mData.borderIsStable() &&
+		mData.width() >= 3 && mData.height() >= mProcessCount + 2;
+}
+
+void GOLTeamH::processDistributed(size_t steps)
+{
+	GOLTEAMH_TRACE_SCOPE("processDistributed");
+
+	pushHistory();
+
+	if (!mDecomposition.running() || mDecomposition.processCount() != mProcessCount ||
+		mDecomposition.width() != mData.width() || mDecomposition.height() != mData.height()) {
+		if (!mDecomposition.start(mProcessCount, mData.width(), mData.height())) {
+			// Impossible de créer les processus : on revient au calcul local.
+			mProcessCount = 1;
+			processSteps(steps);
+			return;
+		}
+		mDecompositionLoaded = false;
+	}
+
+	if (!mDecompositionLoaded) {
+		mDecomposition.load(reinterpret_cast<const uint8_t*>(mData.data()), mParsedRule, mNeighborhood);
+		mDecompositionLoaded = true;
+	}
+
+	std::vector<size_t> aliveCounts;
+	mDecomposition.run(steps, aliveCounts);
+	mDecomposition.gather(reinterpret_cast<uint8_t*>(mData.data()));
+
+	for (auto aliveCount : aliveCounts)
+		mData.setAliveCount(aliveCount);
+
+	mIteration = static_cast<IterationType>(mIteration.value_or(0) + steps);
+	mCycleDetector.reset();
+	mChanges.invalidate();
+	mPyramid.invalidate();
+	pushHistory();
+}
+
+namespace
+{
+	constexpr uint64_t HASH_MULTIPLIER{ 0x9E3779B97F4A7C15ull };
+
+	// Finaliseur de splitmix64 : bon mélange des bits.
+	inline uint64_t mix(uint64_t value)
+	{
+		value ^= value >> 30;
+		value *= 0xBF58476D1CE4E5B9ull;
+		value ^= value >> 27;
+		value *= 0x94D049BB133111EBull;
+		return value ^ (value >> 31);
+	}
+
+	// Empreinte d'une rangée de cellules, 8 cellules à la fois. La position
+	// de la rangée est mélangée au résultat : l'empreinte d'une génération est
+	// la somme de celles de ses rangées, indépendante de l'ordre de calcul.
+	inline uint64_t hashRow(const uint8_t* row, size_t count, size_t rowIndex)
+	{
+		uint64_t hash{ rowIndex * HASH_MULTIPLIER };
+		size_t i{};
+
+		for (; i + 8 <= count; i += 8) {
+			uint64_t word;
+			memcpy(&word, row + i, sizeof(word));
+			hash = (hash ^ word) * HASH_MULTIPLIER;
+			hash ^= hash >> 29;
+		}
+		for (; i < count; ++i)
+			hash = (hash ^ row[i]) * HASH_MULTIPLIER;
+
+		return mix(hash);
+	}
+
+	// Empreinte des cellules intérieures [column, column + count) d'une
+	// rangée, par morceaux de HASH_CHUNK colonnes alignés sur l'intérieur :
+	// une rangée découpée en tuiles (TileSchedulerTeamH) a la même empreinte
+	// que la rangée entière. `column` est un multiple de HASH_CHUNK.
+	constexpr size_t HASH_CHUNK{ 64 };
+	static_assert(TileSchedulerTeamH::TILE_SIZE % HASH_CHUNK == 0);
+
+	inline uint64_t hashCells(const uint8_t* cells, size_t count, size_t rowIndex, size_t column)
+	{
+		uint64_t hash{};
+		for (size_t i{}; i < count; i += HASH_CHUNK) {
+			auto const chunk{ (column + i) / HASH_CHUNK };
+			hash += hashRow(cells + i, std::min(HASH_CHUNK, count - i), rowIndex ^ (chunk << 32));
+		}
+		return hash;
+	}
+
+	struct BlockResult {
+		size_t aliveCount;
+		uint64_t hash;
+		bool changed;
+	};
+
+	// Calcule `rows` rangées de `count` cellules dans `destination` à partir
+	// de `source`, qui pointe sur le voisin en haut à gauche de la première
+	// cellule. Les deux tableaux ont leur propre pas entre les rangées.
+	// `firstRow` et `chunkColumn` numérotent les morceaux de l'empreinte
+	// (voir hashCells). Avec trackChanges, compare aussi chaque cellule à son
+	// état précédent. `neighborhood` est une politique de NeighborhoodTeamH :
+	// chaque politique a sa propre instance du noyau. Si `changes` est donné,
+	// les cellules changées y sont inscrites rangée par rangée, à partir de
+	// la colonne `firstColumn` de la grille.
+	template <bool trackChanges, typename Neighborhood>
+	BlockResult evolveBlock(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride,
+		size_t rows, size_t count, size_t firstRow, size_t chunkColumn, uint32_t parsedRule, Neighborhood const& neighborhood,
+		ChangeSetTeamH* changes = nullptr, size_t firstColumn = 0)
+	{
+		if (rows == 0 || count == 0)
+			return {};
+
+		size_t aliveCount{};
+		uint64_t hash{};
+		uint8_t changed{};
+
+		for (size_t j{}; j < rows; ++j) {
+			// Les trois rangées du voisinage et la rangée de destination.
+			auto const* above{ source + j * sourceStride };
+			auto const* middle{ above + sourceStride };
+			auto const* below{ middle + sourceStride };
+			auto* ptrGridInt{ destination + j * destinationStride };
+
+			for (size_t i{}; i < count; ++i) {
+				auto const neighborsAliveCount{ neighborhood.count(above, middle, below, i) };
+				auto const state{ middle[i + 1] };
+
+				// On prend avantage du fait que GOL::State::alive = 1.
+				// 
+				// On accède à la bonne partie des bits et on compare si le bit de survie/réanimation est
+				// présent. Voir GOLTeamH.cpp pour plus de détails.
+				ptrGridInt[i] = ((parsedRule >> state * 16) >> neighborsAliveCount) & 1;
+
+				aliveCount += ptrGridInt[i];
+				if constexpr (trackChanges)
+					changed |= ptrGridInt[i] ^ state;
+			}
+
+			// Empreinte et changements de la rangée pendant qu'elle est encore
+			// en cache.
+			hash += hashCells(ptrGridInt, count, firstRow + j, chunkColumn);
+			if (changes)
+				changes->record(firstRow + j, firstColumn, middle + 1, ptrGridInt, count);
+		}
+
+		return { aliveCount, hash, changed != 0 };
+	}
+}
+
+// Empreinte des cellules de la bordure (tableau courant).
+uint64_t GOLTeamH::hashBorder() const
+{
+	auto const* data{ reinterpret_cast<const uint8_t*>(mData.data()) };
+	auto const width{ mData.width() }, height{ mData.height() };
+	if (width == 0 || height == 0)
+		return 0;
+
+	// Rangées du haut et du bas, par suites contiguës.
+	uint64_t hash{};
+	auto hashSpan = [&hash](size_t row, size_t column, GridTeamH::DataType cells, size_t count) {
+		hash += hashCells(reinterpret_cast<const uint8_t*>(cells), count, row, column);
+		};
+	mData.forEachSpan(0, 1, hashSpan);
+	mData.forEachSpan(height - 1, height, hashSpan);
+
+	uint64_t sides{};
+	for (size_t j{ 1 }; j + 1 < height; ++j)
+		sides = (sides ^ (data[mData.offset(0, j)] | data[mData.offset(width - 1, j)] << 1)) * HASH_MULTIPLIER;
+
+	return hash + mix(sides);
+}
+
+// Cellules du contour changées : après l'échange des tableaux, intData()
+// contient la génération précédente. Valable pour toutes les stratégies de
+// bord.
+void GOLTeamH::recordBorderChanges()
+{
+	auto const* current{ reinterpret_cast<const uint8_t*>(mData.data()) };
+	auto const* previous{ reinterpret_cast<const uint8_t*>(mData.intData()) };
+
+	mData.forEachBorderCell([&](size_t column, size_t row) {
+		auto const offset{ mData.offset(column, row) };
+		if (current[offset] != previous[offset])
+			mChanges.mark(column, row);
+		});
+}
+
+// Noyau de la simulation : calcule les rangées [rowBegin, rowEnd) de
+// l'intérieur de la grille (sans la bordure) dans le tableau intermédiaire.
+// Retourne le nombre de cellules vivantes calculées et leur empreinte.
+GOLTeamH::KernelResult GOLTeamH::processRows(size_t rowBegin, size_t rowEnd)
+{
+	if (mData.height() < 3)
+		return {};
+
+	return evolveRows(reinterpret_cast<const uint8_t*>(mData.data()), reinterpret_cast<uint8_t*>(mData.intData()),
+		mData.width(), rowBegin, rowEnd, mParsedRule, mNeighborhood, mTrackChanges ? &mChanges : nullptr);
+}
+
+// Intérieur complet de la grille, en parallèle si un bassin de fils existe.
+// Les fils se partagent alors les tuiles actives (voir TileSchedulerTeamH) ;
+// l'empreinte est une somme, donc indépendante du découpage.
+GOLTeamH::KernelResult GOLTeamH::processInterior()
+{
+	if (mData.layout() == GridTeamH::Layout::tiled)
+		return processBlocks();
+
+	if (!mThreadPool || mData.height() < 3)
+		return processRows(1, mData.height() - 1);
+
+	auto const* data{ reinterpret_cast<const uint8_t*>(mData.data()) };
+	auto* intData{ reinterpret_cast<uint8_t*>(mData.intData()) };
+	auto const width{ mData.width() };
+	auto const parsedRule{ mParsedRule };
+	auto const neighborhood{ mNeighborhood };
+	auto* changes{ mTrackChanges ? &mChanges : nullptr };
+
+	auto const totals{ mScheduler.run(*mThreadPool, width, mData.height(), mIteration.value_or(0),
+		[=](size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd) {
+			return evolveTile(data, intData, width, rowBegin, rowEnd, columnBegin, columnEnd, parsedRule, neighborhood, changes);
+		}) };
+
+	return { totals.aliveCount, totals.hash };
+}
+
+// processInterior en ajoutant à la phase interior les compteurs matériels
+// de chaque fil du bassin, lus avant et après le noyau.
+GOLTeamH::KernelResult GOLTeamH::processInteriorCounted()
+{
+	std::vector<PerfCountersTeamH::Sample> samples(mThreadPool->threadCount());
+	mThreadPool->run([&](size_t worker) { samples[worker] = InstrumentationTeamH::threadCounters().read(); });
+
+	auto const result{ processInterior() };
+
+	mThreadPool->run([&](size_t worker) { samples[worker] = InstrumentationTeamH::threadCounters().read() - samples[worker]; });
+	for (auto const& sample : samples)
+		mInstrumentation.addCounters(InstrumentationTeamH::Phase::interior, sample, 0);
+	return result;
+}
+
+// Disposition tiled : chaque bloc est calculé à partir de sa fenêtre (le
+// bloc et une cellule de ses voisins, voir GridTeamH::gatherBlock) vers son
+// bloc du tableau intermédiaire. Avec un bassin de fils, chaque fil traite
+// une suite de blocs dans l'ordre Z, celle qu'il a touchée en premier.
+GOLTeamH::KernelResult GOLTeamH::processBlocks()
+{
+	constexpr size_t BLOCK{ GridTeamH::BLOCK_SIZE }, STRIDE{ BLOCK + 2 };
+
+	auto const width{ mData.width() }, height{ mData.height() };
+	auto const blocks{ mData.blockCount() };
+	auto const workers{ mThreadPool ? mThreadPool->threadCount() : 1 };
+	auto* intData{ reinterpret_cast<uint8_t*>(mData.intData()) };
+	std::vector<KernelResult> results(workers);
+
+	auto process = [&](size_t worker) {
+		GOLTEAMH_TRACE_SCOPE("processBlocks");
+		std::array<uint8_t, STRIDE * STRIDE> window;
+		auto const [first, last] = ThreadPoolTeamH::partition(worker, workers, 0, blocks);
+		KernelResult result{};
+
+		for (size_t index{ first }; index < last; ++index) {
+			auto const [bx, by] = mData.blockPosition(index);
+			auto const x0{ bx * BLOCK }, y0{ by * BLOCK };
+
+			// Cellules intérieures (hors bordure) du bloc.
+			auto const rowBegin{ std::max<size_t>(y0, 1) }, rowEnd{ std::min(y0 + BLOCK, height - 1) };
+			auto const columnBegin{ std::max<size_t>(x0, 1) }, columnEnd{ std::min(x0 + BLOCK, width - 1) };
+			if (rowBegin >= rowEnd || columnBegin >= columnEnd)
+				continue;
+
+			mData.gatherBlock(index, window.data());
+			auto const block{ NeighborhoodTeamH::dispatch(mNeighborhood, [&](auto const& policy) {
+				return evolveBlock<false>(window.data() + (rowBegin - y0) * STRIDE + (columnBegin - x0), STRIDE,
+					intData + mData.offset(columnBegin, rowBegin), BLOCK,
+					rowEnd - rowBegin, columnEnd - columnBegin, rowBegin, x0, mParsedRule, policy,
+					mTrackChanges ? &mChanges : nullptr, columnBegin);
+				}) };
+
+			result.aliveCount += block.aliveCount;
+			result.hash += block.hash;
+		}
+		results[worker] = result;
+		};
+
+	if (mThreadPool)
+		mThreadPool->run(process);
+	else
+		process(0);
+
+	KernelResult total{};
+	for (auto const& result : results) {
+		total.aliveCount += result.aliveCount;
+		total.hash += result.hash;
+	}
+	return total;
+}
+
+// Noyau de processRows sur des tableaux quelconques de largeur `width`
+// (bordure incluse) : lit les rangées [rowBegin - 1, rowEnd] de `data` et
+// écrit les colonnes intérieures des rangées [rowBegin, rowEnd) de `intData`.
+// Utilisé aussi par les processus de DomainDecompositionTeamH.
+GOLTeamH::KernelResult GOLTeamH::evolveRows(const uint8_t* data, uint8_t* intData, size_t width,
+	size_t rowBegin, size_t rowEnd, uint32_t parsedRule, NeighborhoodTeamH::Mask neighborhood, ChangeSetTeamH* changes)
+{
+	if (width < 3 || rowBegin >= rowEnd)
+		return {};
+
+	auto const block{ NeighborhoodTeamH::dispatch(neighborhood, [&](auto const& policy) {
+		return evolveBlock<false>(data + (rowBegin - 1) * width, width, intData + rowBegin * width + 1, width,
+			rowEnd - rowBegin, width - 2, rowBegin, 0, parsedRule, policy, changes, 1);
+		}) };
+	return { block.aliveCount, block.hash };
+}
+
+// Comme evolveRows, limité aux colonnes [columnBegin, columnEnd) ; indique
+// en plus si une cellule a changé. Noyau des tuiles de TileSchedulerTeamH.
+TileSchedulerTeamH::TileResult GOLTeamH::evolveTile(const uint8_t* data, uint8_t* intData, size_t width,
+	size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd, uint32_t parsedRule, NeighborhoodTeamH::Mask neighborhood,
+	ChangeSetTeamH* changes)
+{
+	if (rowBegin >= rowEnd || columnBegin >= columnEnd)
+		return {};
+
+	auto const block{ NeighborhoodTeamH::dispatch(neighborhood, [&](auto const& policy) {
+		return evolveBlock<true>(data + (rowBegin - 1) * width + (columnBegin - 1), width,
+			intData + rowBegin * width + columnBegin, width,
+			rowEnd - rowBegin, columnEnd - columnBegin, rowBegin, columnBegin - 1, parsedRule, policy, changes, columnBegin);
+		}) };
+	return { block.aliveCount, block.hash, block.changed };
 }
 
 
@@ -519,44 +1086,346 @@ void GOLTeamH::updateImage(uint32_t* buffer, size_t buffer_size) const
 	if (buffer == nullptr)
 		return;
 
-	auto* s_ptr{ buffer }, * e_ptr{ buffer + buffer_size };
+	GOLTEAMH_TRACE_SCOPE("updateImage");
+	GOLTEAMH_TIME_PHASE(mInstrumentation, render);
 
-	// Pointeur qui se promène en mémoire.
-	auto* ptrGrid{ reinterpret_cast<uint8_t*>(mData.data()) };
+	auto const width{ mData.width() };
+	auto const colors{ mColorEncoded };
 
-	// Clear tout
-	memset(buffer, 0, sizeof(uint32_t) * buffer_size);
+	// On parcourt les suites contiguës de la grille et on associe la couleur.
+	mData.forEachSpan(0, mData.height(), [&](size_t row, size_t column, GridTeamH::DataType cells, size_t count) {
+		auto const first{ row * width + column };
+		if (first >= buffer_size)
+			return;
+
+		auto* s_ptr{ buffer + first };
+		auto const* ptrGrid{ reinterpret_cast<const uint8_t*>(cells) };
+		auto const* e_ptr{ ptrGrid + std::min(count, buffer_size - first) };
+
+		while (ptrGrid < e_ptr) {
+			// Alpha = 255
+			*s_ptr = static_cast<uint32_t>(colors >> (32 * (*ptrGrid))) | MAX_ALPHA;
+
+			s_ptr++;
+			ptrGrid++;
+		}
+		});
+
+	// Clear le reste
+	if (buffer_size > mData.size())
+		memset(buffer + mData.size(), 0, sizeof(uint32_t) * (buffer_size - mData.size()));
+}
+
+//! \brief Dessine toute la grille réduite (ou agrandie) à la taille de
+//! l'image.
+//! 
+//! \details Chaque pixel lit un seul bloc du niveau de la pyramide dont les
+//! blocs couvrent au moins la surface d'un pixel ; sa couleur est le mélange
+//! des couleurs des cellules mortes et vivantes selon la densité du bloc.
+//! Si l'image est plus grande que la grille, chaque pixel lit directement
+//! sa cellule.
+//! 
+//! \param buffer L'image, de `imageWidth` x `imageHeight` pixels.
+//! \param imageWidth La largeur de l'image.
+//! \param imageHeight La hauteur de l'image.
+void GOLTeamH::updateImageLevelOfDetail(uint32_t* buffer, size_t imageWidth, size_t imageHeight) const
+{
+	if (buffer == nullptr || imageWidth == 0 || imageHeight == 0)
+		return;
 
-	// On itère sur chaque éléments du tableau et on associe la couleur.
-	while (s_ptr < e_ptr) {
-		// Alpha = 255
-		*s_ptr |= mColorEncoded >> (32 * (*ptrGrid)) | MAX_ALPHA;
+	GOLTEAMH_TRACE_SCOPE("updateImageLevelOfDetail");
+	GOLTEAMH_TIME_PHASE(mInstrumentation, render);
 
-		s_ptr++;
-		ptrGrid++;
+	auto const width{ mData.width() }, height{ mData.height() };
+	if (width == 0 || height == 0) {
+		memset(buffer, 0, sizeof(uint32_t) * imageWidth * imageHeight);
+		return;
 	}
 
-	s_ptr = nullptr;
-	ptrGrid = nullptr;
+	auto const scaleX{ static_cast<double>(width) / static_cast<double>(imageWidth) };
+	auto const scaleY{ static_cast<double>(height) / static_cast<double>(imageHeight) };
+	auto const& pyramid{ densityPyramid() };
+	auto const level{ pyramid.levelFor(std::max(scaleX, scaleY)) };
+
+	auto const dead{ static_cast<uint32_t>(mColorEncoded) }, alive{ static_cast<uint32_t>(mColorEncoded >> 32) };
+	// t sur 256 : 0 = mort, 256 = vivant ; canal par canal.
+	auto blend = [dead, alive](uint32_t t) {
+		uint32_t color{ MAX_ALPHA };
+		for (int shift{}; shift < 24; shift += 8) {
+			auto const from{ static_cast<int32_t>((dead >> shift) & 0xff) }, to{ static_cast<int32_t>((alive >> shift) & 0xff) };
+			color |= static_cast<uint32_t>(from + (((to - from) * static_cast<int32_t>(t)) >> 8)) << shift;
+		}
+		return color;
+		};
+
+	auto const* cells{ reinterpret_cast<const uint8_t*>(mData.data()) };
+	for (size_t y{}; y < imageHeight; ++y) {
+		auto const row{ std::min(static_cast<size_t>((static_cast<double>(y) + 0.5) * scaleY), height - 1) };
+		auto* pixels{ buffer + y * imageWidth };
+
+		for (size_t x{}; x < imageWidth; ++x) {
+			auto const column{ std::min(static_cast<size_t>((static_cast<double>(x) + 0.5) * scaleX), width - 1) };
+			if (level == 0) {
+				pixels[x] = static_cast<uint32_t>(mColorEncoded >> (32 * cells[mData.offset(column, row)])) | MAX_ALPHA;
+				continue;
+			}
+
+			auto const blockX{ column >> level }, blockY{ row >> level };
+			auto const t{ static_cast<uint32_t>(uint64_t{ pyramid.count(level, blockX, blockY) } * 256 /
+				pyramid.cellCount(level, blockX, blockY)) };
+			pixels[x] = blend(t);
+		}
+	}
 }
 
-unsigned char GOLTeamH::convertCharToNumber(const char c)
+//! \brief Démarre l'enregistrement compressé des générations.
+//! 
+//! \details La génération courante est enregistrée immédiatement, puis
+//! chaque appel à processOneStep ajoute une génération. L'écriture sur
+//! disque se fait dans un fil séparé : la simulation n'attend jamais après
+//! le disque. Un redimensionnement de la grille termine l'enregistrement.
+//! 
+//! \param path Le fichier de destination (écrasé s'il existe).
+//! \param keyframeInterval Le nombre de générations entre deux images clés.
+//! \return true si le fichier a pu être ouvert.
+bool GOLTeamH::startRecording(std::string const& path, size_t keyframeInterval)
 {
-	return (c - 48);
+	if (!mRecorder.start(path, mData.width(), mData.height(), keyframeInterval))
+		return false;
+
+	mRecorder.record(mIteration.value_or(0), mData);
+	return true;
 }
 
-std::optional<GOLTeamH::sizeQueried> GOLTeamH::parsePattern(std::string const& pattern)
+//! \brief Termine l'enregistrement et attend l'écriture des générations
+//! en attente.
+void GOLTeamH::stopRecording()
 {
-	// \[ -> on match le caractère [
-	// (\d+) -> on match plusieurs caractères de 0-9
-	// std::regex_constants::icase -> min ou maj
-	std::regex regexp(R"(\[(\d+)x(\d+)\](\d+))", std::regex_constants::icase);
-	std::smatch m;
+	mRecorder.stop();
+}
+
+//! \brief Active ou désactive les chronomètres par phase.
+//! 
+//! \details Les fenêtres de mesures sont vidées à chaque changement.
+//! 
+//! \return false si l'instrumentation n'a pas été compilée 
+//! (GOLTEAMH_INSTRUMENTATION non défini).
+bool GOLTeamH::setInstrumentationEnabled(bool enabled)
+{
+	mInstrumentation.reset();
+	return mInstrumentation.setEnabled(enabled);
+}
 
-	if (std::regex_search(pattern, m, regexp))
-		return GOLTeamH::sizeQueried{ .width = std::stoull(m[1]), .height = std::stoull(m[2]), .pos = m[3] };
+//! \brief Active ou désactive le suivi des cellules changées.
+//! 
+//! \details Le noyau compare chaque rangée calculée à la précédente pendant
+//! qu'elle est en cache et inscrit les différences dans changes() ; le
+//! contour est comparé après l'échange des tableaux. L'ensemble devient
+//! valide après la prochaine itération calculée localement. Les itérations
+//! réparties sur plusieurs processus le laissent invalide.
+void GOLTeamH::setChangeTracking(bool enabled)
+{
+	mTrackChanges = enabled;
+	if (enabled)
+		mChanges.resize(mData.width(), mData.height());
 	else
+		mChanges.resize(0, 0);
+}
+
+//! \brief Configure l'historique des dernières générations.
+//! 
+//! \details Après chaque itération, la grille est compactée à 1 bit par
+//! cellule et ajoutée à l'historique : une image clé toutes les
+//! `keyframeInterval` générations, le XOR avec la précédente entre deux.
+//! Les plus anciennes générations sont oubliées pour respecter le budget.
+//! L'historique est vidé à chaque appel.
+//! 
+//! \param keyframeInterval Le nombre de générations par image clé (0 =
+//! historique désactivé).
+//! \param budgetBytes La mémoire maximale de l'historique, en octets.
+void GOLTeamH::setHistory(size_t keyframeInterval, size_t budgetBytes)
+{
+	mHistory.configure(keyframeInterval, budgetBytes);
+}
+
+//! \brief Revient `generations` itérations en arrière.
+//! 
+//! \return false si cette génération n'est plus dans l'historique.
+bool GOLTeamH::stepBack(size_t generations)
+{
+	auto const iteration{ mIteration.value_or(0) };
+	if (generations > iteration)
+		return false;
+
+	return seek(static_cast<IterationType>(iteration - generations));
+}
+
+//! \brief Place la simulation à l'itération donnée.
+//! 
+//! \details La génération conservée la plus proche avant `iteration` est
+//! reconstruite à partir de l'historique (une image clé et au plus
+//! `keyframeInterval - 1` différences), puis les itérations manquantes sont
+//! calculées. Vers l'avant, l'historique n'est utilisé que s'il contient
+//! une génération plus proche que la génération courante (après un
+//! stepBack, par exemple).
+//! 
+//! Les statistiques de tendance et la détection de cycles repartent de la
+//! génération reconstruite.
+//! 
+//! \return false si `iteration` est antérieure à l'historique.
+bool GOLTeamH::seek(IterationType iteration)
+{
+	auto const current{ mIteration.value_or(0) };
+	if (iteration == current)
+		return true;
+
+	pushHistory();
+	auto const found{ mHistory.find(iteration) };
+	if (found && (iteration < current || *found > current)) {
+		auto const restored{ mHistory.restore(iteration, mData) };
+		if (!restored)
+			return false;
+
+		mIteration = restored->iteration;
+		mData.resetAliveCount(restored->aliveCount);
+		invalidateCaches();
+	}
+	else if (iteration < current)
+		return false;
+
+	processSteps(iteration - mIteration.value_or(0));
+	return true;
+}
+
+//! \brief Active ou désactive la pyramide des densités.
+//! 
+//! \details Active aussi le suivi des cellules changées, dont la pyramide
+//! se sert pour ne recalculer que les tuiles changées.
+void GOLTeamH::setDensityPyramid(bool enabled)
+{
+	mPyramidEnabled = enabled;
+	mPyramid.invalidate();
+	if (enabled && !mTrackChanges)
+		setChangeTracking(true);
+}
+
+//! \brief Pyramide des densités de la génération courante, reconstruite si
+//! elle n'est pas à jour (première utilisation, grille modifiée...).
+DensityPyramidTeamH const& GOLTeamH::densityPyramid() const
+{
+	if (!mPyramid.valid())
+		mPyramid.rebuild(mData);
+	return mPyramid;
+}
+
+//! \brief Active ou désactive les compteurs matériels par phase.
+//! 
+//! \details Les compteurs sont lus par PerfCountersTeamH autour de chaque
+//! phase, sur le fil appelant. Avec un bassin de fils, chaque fil lit
+//! aussi les siens autour du noyau intérieur (deux passages de plus dans le
+//! bassin par itération, seulement quand les compteurs sont actifs).
+//! 
+//! \return false si l'instrumentation n'a pas été compilée ou si aucun
+//! compteur n'est disponible ; rien n'est alors mesuré.
+bool GOLTeamH::setCountersEnabled(bool enabled)
+{
+	if (!mInstrumentation.setCountersEnabled(enabled))
+		return false;
+	return !enabled || mInstrumentation.enabled() || setInstrumentationEnabled(true);
+}
+
+//! \brief Change la disposition mémoire de la grille.
+//! 
+//! \details En GridTeamH::Layout::tiled, les cellules sont rangées en blocs
+//! de 64 x 64 selon l'ordre Z : les voisins du dessus et du dessous sont
+//! dans la même page, ce qui réduit les défauts de cache et de TLB sur les
+//! grilles larges. Chaque bloc est calculé à partir d'une copie de sa
+//! fenêtre. Le contenu de la grille est conservé ; l'historique des cycles
+//! repart de zéro. La répartition sur plusieurs processus n'est utilisée
+//! qu'en GridTeamH::Layout::rowMajor.
+//! 
+//! \param layout La nouvelle disposition.
+void GOLTeamH::setLayout(GridTeamH::Layout layout)
+{
+	mData.setLayout(layout);
+	resetHistory();
+}
+
+//! \brief Change le voisinage compté par la règle.
+//! 
+//! \details Chaque voisinage a son propre noyau, compilé pour son masque
+//! (voir NeighborhoodTeamH) : von Neumann, hexagonal ou un masque
+//! quelconque sont aussi rapides que Moore. L'historique des cycles repart
+//! de zéro.
+//! 
+//! \param neighborhood Le masque des voisins comptés.
+void GOLTeamH::setNeighborhood(NeighborhoodTeamH::Mask neighborhood)
+{
+	mNeighborhood = neighborhood;
+	resetHistory();
+}
+
+//! \brief Calcule l'intérieur de la grille avec plusieurs fils.
+//! 
+//! \details L'intérieur est découpé en tuiles ; seules les tuiles dont le
+//! voisinage a changé sont recalculées, et un fil inoccupé vole les tuiles
+//! des autres (voir TileSchedulerTeamH). Chaque fil reçoit d'abord les
+//! tuiles de sa bande de rangées. En mode NUMA, les fils sont épinglés à
+//! des coeurs et la grille est recopiée pour que chaque fil touche en
+//! premier sa bande des deux tableaux ; les pages sont alors sur le noeud
+//! de ce fil, y compris après resize(). La bordure reste calculée par le
+//! fil appelant.
+//! 
+//! \param count Le nombre de fils. 1 revient au calcul séquentiel.
+//! \param numaAware Épinglage et placement des pages par bande.
+void GOLTeamH::setThreadCount(size_t count, bool numaAware)
+{
+	// Le bassin doit survivre à la grille qui y fait référence.
+	mData.setThreadPool(nullptr);
+	mThreadPool.reset();
+	mScheduler.invalidate();
+
+	if (count <= 1)
+		return;
+
+	mThreadPool = std::make_unique<ThreadPoolTeamH>(count, numaAware);
+
+	if (numaAware)
+		mData.setThreadPool(mThreadPool.get());
+}
+
+//! \brief Répartit la simulation sur plusieurs processus.
+//! 
+//! \details L'intérieur de la grille est découpé en `count` tranches
+//! horizontales, chacune calculée par un processus travailleur (voir
+//! DomainDecompositionTeamH). Les processus sont créés à la première
+//! itération. La répartition est suspendue si la bordure est warping ou
+//! mirror, ou diffère entre les deux grilles (voir useDecomposition),
+//! pendant un enregistrement, ou si la grille a moins de `count` rangées
+//! intérieures.
+//! 
+//! \param count Le nombre de processus. 1 arrête les travailleurs.
+//! \return false si la plateforme ne le supporte pas (Linux seulement).
+bool GOLTeamH::setProcessCount(size_t count)
+{
+	if (count > 1 && !DomainDecompositionTeamH::supported)
+		return false;
+
+	mProcessCount = std::max<size_t>(count, 1);
+	if (mProcessCount == 1)
+		mDecomposition.stop();
+
+	return true;
+}
+
+std::optional<GOLTeamH::sizeQueried> GOLTeamH::parsePattern(std::string const& pattern)
+{
+	auto parsed{ ParsingTeamH::parsePattern(pattern) };
+
+	if (!parsed)
 		return std::nullopt;
+
+	return GOLTeamH::sizeQueried{ .width = parsed->width, .height = parsed->height, .pos = std::move(parsed->cells) };
 }
 
 void GOLTeamH::fillDataFromPattern(sizeQueried& sq, int centerX, int centerY)
@@ -588,121 +1457,70 @@ void GOLTeamH::fillDataFromPattern(sizeQueried& sq, int centerX, int centerY)
 void GOLTeamH::countLifeStatusCells()
 {
 	size_t aliveCount{};
-	auto* s_ptr{ mData.data() }, * e_ptr{ mData.data() + mData.size() };
 
-	while (s_ptr < e_ptr) {
-		if (*s_ptr == State::alive) {
-			aliveCount++;
-		}
-		s_ptr++;
-	}
-	mData.setAliveCount(aliveCount);
+	mData.forEachSpan(0, mData.height(), [&aliveCount](size_t, size_t, GridTeamH::DataType cells, size_t count) {
+		for (size_t i{}; i < count; ++i)
+			if (cells[i] == State::alive)
+				aliveCount++;
+		});
+	mData.resetAliveCount(aliveCount);
 }
 
 
 // TODO: combiner avec fillBorder
 void GOLTeamH::modifyBorderIfNecessary()
 {
-	auto* ptrGrid{ reinterpret_cast<uint8_t*>(mData.data()) };
+	auto const* ptrGrid{ reinterpret_cast<const uint8_t*>(mData.data()) };
 	auto* ptrGridInt{ reinterpret_cast<uint8_t*>(mData.intData()) };
 	auto bm = mBorderManagement.value_or(BorderManagement::immutableAsIs);
-	auto width{ mData.width() }, height{ mData.height() };	// Pour éviter des appels de fonctions trop souvent.
 	auto rule{ mParsedRule };								// Pour la capture du lambda.
-	int count{};
 
-	if (mBorderManagement.value() == GOL::BorderManagement::immutableAsIs ||
+	if (bm == GOL::BorderManagement::immutableAsIs ||
 		bm == GOL::BorderManagement::foreverAlive ||
 		bm == GOL::BorderManagement::foreverDead)
 		return;
 
-	auto* e_ptr = ptrGrid + (width - 1);
-
 	// Lambda pour une opération courante.
-	auto applyRule = [rule](size_t count, uint8_t* ptrGrid) {
-		return static_cast<bool>((rule >> *(ptrGrid) * 16) & (1u << count));
+	auto applyRule = [rule](size_t count, uint8_t state) {
+		return static_cast<bool>((rule >> state * 16) & (1u << count));
 		};
 
-	// TOP
-	while (ptrGrid < e_ptr) {
-		*ptrGridInt = applyRule(countNeighbors(ptrGrid), ptrGrid);
-
-		ptrGrid++;
-		ptrGridInt++;
-		count++;
-	}
-
-	// DROITE
-	e_ptr += width * (height - 1);
-	while (ptrGrid < e_ptr) {
-		*ptrGridInt = applyRule(countNeighbors(ptrGrid), ptrGrid);
-
-		ptrGrid += width;
-		ptrGridInt += width;
-	}
-
-	// DESSOUS
-	e_ptr -= (width - 1);
-	while (ptrGrid > e_ptr) {
-		*ptrGridInt = applyRule(countNeighbors(ptrGrid), ptrGrid);
-
-		ptrGrid--;
-		ptrGridInt--;
-	}
-
-	// GAUCHE
-	e_ptr -= width * (height - 1);
-	while (ptrGrid > e_ptr) {
-		*ptrGridInt = applyRule(countNeighbors(ptrGrid), ptrGrid);
-
-		ptrGrid -= width;
-		ptrGridInt -= width;
-	}
+	// Contour complet, dans n'importe quelle disposition de la grille.
+	mData.forEachBorderCell([&](size_t column, size_t row) {
+		auto const offset{ mData.offset(column, row) };
+		ptrGridInt[offset] = applyRule(countNeighbors(column, row), ptrGrid[offset]);
+		});
 }
 
-size_t GOLTeamH::countNeighbors(const uint8_t* cellPtr) const
+size_t GOLTeamH::countNeighbors(size_t column, size_t row) const
 {
-	auto bm{ mBorderManagement };
-	auto width{ mData.width() }, height{ mData.height() };	// Pour éviter des appels de fonctions trop souvent.
+	auto bm{ mBorderManagement.value_or(BorderManagement::immutableAsIs) };
+	auto const width{ static_cast<ptrdiff_t>(mData.width()) }, height{ static_cast<ptrdiff_t>(mData.height()) };
 	size_t neighborsAliveCount{};
-	auto* tempPtr{ cellPtr - (width + 1) };	// Pointeur qui se promène en mémoire.
 	const auto* firstGridPtr{ reinterpret_cast<uint8_t*>(mData.data()) };
-	const auto* lastGridPtr{ reinterpret_cast<uint8_t*>(mData.data()) + (width * height) - 1 };
-
-	// Petit lambda pour simplifier les opérations.
-	auto putInBounds = [width, height, bm, firstGridPtr, lastGridPtr](const uint8_t* ptr) {
-		// En bas ou en haut de la grille.
-		if (ptr < firstGridPtr)
-			ptr += width * ((bm == GOL::BorderManagement::mirror) ? 2 : height);
-		else if (ptr > lastGridPtr)
-			ptr -= width * ((bm == GOL::BorderManagement::mirror) ? 2 : height);
-
-		// Gauche ou droite
-		if ((ptr - firstGridPtr) % width == 0)
-			ptr -= ((bm == GOL::BorderManagement::mirror) ? 2 : width);
-		else if ((ptr - firstGridPtr) % width == width - 1)
-			ptr += ((bm == GOL::BorderManagement::mirror) ? 2 : width);
-
-		return ptr;
-		};
-
-	neighborsAliveCount += *(putInBounds(tempPtr));
-	tempPtr++;
-	neighborsAliveCount += *(putInBounds(tempPtr));
-	tempPtr++;
-	neighborsAliveCount += *(putInBounds(tempPtr));
 
-	tempPtr += (width - 2);
-	neighborsAliveCount += *(putInBounds(tempPtr));
-	tempPtr += 2;
-	neighborsAliveCount += *(putInBounds(tempPtr));
+	// On travaille en coordonnées : l'arithmétique de pointeurs seule ne
+	// permet pas de distinguer un voisin hors de la grille d'une cellule de
+	// la rangée voisine (et peut sortir du tableau dans les coins).
+	// Petit lambda pour ramener une coordonnée dans la grille.
+	auto putInBounds = [bm](ptrdiff_t value, ptrdiff_t size) -> ptrdiff_t {
+		if (value < 0)
+			return (bm == GOL::BorderManagement::mirror) ? 1 : size - 1;
+		if (value >= size)
+			return (bm == GOL::BorderManagement::mirror) ? size - 2 : 0;
+		return value;
+		};
 
+	// Seuls les voisins du voisinage courant sont comptés (cellules du
+	// contour seulement : une boucle suffit).
+	for (size_t neighbor{}; neighbor < 8; ++neighbor) {
+		if (!NeighborhoodTeamH::contains(mNeighborhood, neighbor))
+			continue;
 
-	tempPtr += (width - 2);
-	neighborsAliveCount += *(putInBounds(tempPtr));
-	tempPtr++;
-	neighborsAliveCount += *(putInBounds(tempPtr));
-	tempPtr++;
-	neighborsAliveCount += *(putInBounds(tempPtr));
+		auto const neighborRow{ putInBounds(static_cast<ptrdiff_t>(row) + NeighborhoodTeamH::DY[neighbor], height) };
+		auto const neighborColumn{ putInBounds(static_cast<ptrdiff_t>(column) + NeighborhoodTeamH::DX[neighbor], width) };
+		neighborsAliveCount += firstGridPtr[mData.offset(static_cast<size_t>(neighborColumn), static_cast<size_t>(neighborRow))];
+	}
 
 	return neighborsAliveCount;
 }
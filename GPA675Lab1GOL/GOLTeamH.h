@@ -3,14 +3,31 @@
 #define GOLTEAMH_H
 
 
+#include <array>
 #include <iostream>
 #include <regex>
 #include <string>
 #include <optional>
-#include < algorithm >
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 #include <GOL.h>
+#include "ChangeSetTeamH.h"
+#include "CycleDetectorTeamH.h"
+#include "DensityPyramidTeamH.h"
+#include "DomainDecompositionTeamH.h"
+#include "EditQueueTeamH.h"
 #include "GridTeamH.h"
+#include "HistoryTeamH.h"
+#include "InstrumentationTeamH.h"
+#include "NeighborhoodTeamH.h"
+#include "ParsingTeamH.h"
+#include "TraceTeamH.h"
+#include "RecorderTeamH.h"
+#include "ThreadPoolTeamH.h"
+#include "TileSchedulerTeamH.h"
 
 // Fichier : GridTeam.h
 // GPA675 – Laboratoire 1 
@@ -34,6 +51,29 @@ public:
 		std::string pos;
 	};
 
+	// Statistiques de GOL complétées par les informations propres à GOLTeamH.
+	// Les durées sont absentes si l'instrumentation est désactivée.
+	struct ExtendedStatistics : Statistics {
+		std::optional<InstrumentationTeamH::Timing> interiorTime;	//!< Noyau intérieur de processOneStep
+		std::optional<InstrumentationTeamH::Timing> borderTime;		//!< Évaluation de la bordure
+		std::optional<InstrumentationTeamH::Timing> swapTime;		//!< Échange des tableaux
+		std::optional<InstrumentationTeamH::Timing> statisticsTime;	//!< Suivi après l'échange (voir Phase::statistics)
+		std::optional<InstrumentationTeamH::Timing> renderTime;		//!< updateImage
+		std::optional<InstrumentationTeamH::Counters> interiorCounters;	//!< Compteurs matériels par cellule (voir setCountersEnabled)
+		std::optional<InstrumentationTeamH::Counters> borderCounters;
+		std::optional<InstrumentationTeamH::Counters> swapCounters;
+		std::optional<InstrumentationTeamH::Counters> statisticsCounters;
+		std::optional<InstrumentationTeamH::Counters> renderCounters;
+		std::optional<size_t> period;								//!< Période du cycle détecté (1 = stable)
+		std::optional<double> tendencySlope;						//!< Variation moyenne par itération
+		std::optional<double> tendencyVariance;						//!< Variance autour de la tendance
+		std::optional<char> tendencyStability;						//!< '-', '~', 'w' ou 'W' (voir statistics)
+		std::optional<size_t> processCount;							//!< Processus travailleurs, si la simulation est répartie
+		std::optional<size_t> threadCount;							//!< Fils du noyau intérieur, s'il est parallèle
+		std::optional<size_t> activeTiles;							//!< Tuiles recalculées à la dernière itération parallèle
+		std::optional<size_t> stolenTiles;							//!< Tuiles volées par un autre fil à cette itération
+	};
+
 	GOLTeamH();
 	GOLTeamH(GOLTeamH const&) = delete;
 	GOLTeamH(GOLTeamH&&) = delete;
@@ -52,6 +92,7 @@ public:
 	Color color(State state) const override { return state == GOL::State::alive ? mAliveColor : mDeadColor; }
 
 	Statistics statistics() const override;
+	ExtendedStatistics extendedStatistics() const;
 	ImplementationInformation information() const override;
 
 	void resize(size_t width, size_t height, State defaultState) override;
@@ -66,8 +107,87 @@ public:
 	bool setFromPattern(std::string const& pattern) override;
 	void setSolidColor(State state, Color const& color) override;
 	void processOneStep() override;
+	void processSteps(size_t steps);
 	void updateImage(uint32_t* buffer, size_t buffer_size) const override;
 
+	// Enregistrement compressé des générations (voir RecorderTeamH).
+	bool startRecording(std::string const& path, size_t keyframeInterval = 64);
+	void stopRecording();
+	bool isRecording() const { return mRecorder.isRecording(); }
+
+	// Saut sans calcul des générations d'un cycle détecté (période 1 ou 2
+	// dans processOneStep, toute période dans processSteps). Activé par
+	// défaut ; la détection (statistics().period) continue sans lui.
+	void setCycleSkipping(bool enabled) { mCycleSkipping = enabled; }
+	bool cycleSkipping() const { return mCycleSkipping; }
+
+	// Chronomètres par phase (voir InstrumentationTeamH). Retourne false si
+	// l'instrumentation n'a pas été compilée (GOLTEAMH_INSTRUMENTATION).
+	bool setInstrumentationEnabled(bool enabled);
+	// Compteurs matériels par phase, y compris ceux des fils du noyau
+	// parallèle. Active aussi les chronomètres. Retourne false si
+	// l'instrumentation n'a pas été compilée ou si les compteurs sont
+	// indisponibles (conteneur, perf_event_paranoid...).
+	bool setCountersEnabled(bool enabled);
+
+	// Simulation répartie sur plusieurs processus (voir
+	// DomainDecompositionTeamH). 1 = dans le processus courant. Le calcul
+	// reste local tant que la bordure diffère entre les deux grilles.
+	bool setProcessCount(size_t count);
+	size_t processCount() const { return mProcessCount; }
+
+	// Noyau intérieur parallèle par tuiles actives, avec vol de travail (voir
+	// TileSchedulerTeamH). En mode NUMA, les fils sont épinglés et touchent en
+	// premier leur bande de rangées.
+	void setThreadCount(size_t count, bool numaAware = true);
+	size_t threadCount() const { return mThreadPool ? mThreadPool->threadCount() : 1; }
+
+	// Disposition mémoire de la grille (voir GridTeamH::Layout).
+	void setLayout(GridTeamH::Layout layout);
+	GridTeamH::Layout layout() const { return mData.layout(); }
+
+	// Voisinage compté par la règle (voir NeighborhoodTeamH). setRule le
+	// remplace par celui du suffixe de la règle.
+	void setNeighborhood(NeighborhoodTeamH::Mask neighborhood);
+	NeighborhoodTeamH::Mask neighborhood() const { return mNeighborhood; }
+
+	// Cellules changées à la dernière itération, calculées par le noyau
+	// pendant processOneStep (voir ChangeSetTeamH). Les coordonnées de
+	// l'ensemble commencent à 0 : la cellule (x, y) est state(x + 1, y + 1).
+	// L'ensemble est invalide tant qu'aucune itération n'a été suivie.
+	void setChangeTracking(bool enabled);
+	bool changeTracking() const { return mTrackChanges; }
+	ChangeSetTeamH const& changes() const { return mChanges; }
+
+	// Historique borné des dernières générations (voir HistoryTeamH) : une
+	// image clé toutes les `keyframeInterval` générations, des différences
+	// entre deux. keyframeInterval = 0 le désactive. Toute modification de
+	// la grille, de la règle ou de la bordure le vide.
+	void setHistory(size_t keyframeInterval, size_t budgetBytes = 64 * 1024 * 1024);
+	HistoryTeamH const& history() const { return mHistory; }
+	bool stepBack(size_t generations = 1);
+	bool seek(IterationType iteration);
+
+	// Pyramide des densités (voir DensityPyramidTeamH), mise à jour après
+	// chaque itération à partir des tuiles changées. L'activer active aussi
+	// le suivi des changements. densityPyramid() la reconstruit au besoin.
+	void setDensityPyramid(bool enabled);
+	bool densityPyramidEnabled() const { return mPyramidEnabled; }
+	DensityPyramidTeamH const& densityPyramid() const;
+	// Rendu de toute la grille dans une image de `imageWidth` x
+	// `imageHeight` pixels, à partir du niveau de la pyramide qui correspond
+	// à l'échelle : un coût proportionnel au nombre de pixels.
+	void updateImageLevelOfDetail(uint32_t* buffer, size_t imageWidth, size_t imageHeight) const;
+
+	// Modifications déposées par n'importe quel fil pendant que la
+	// simulation tourne (voir EditQueueTeamH). Elles sont appliquées, dans
+	// l'ordre, au début de la prochaine génération (processOneStep,
+	// processSteps) ou par applyEdits(), toujours par le fil de simulation.
+	// post() ne bloque jamais : false si la file est pleine.
+	bool post(EditQueueTeamH::Edit edit) { return mEdits.push(std::move(edit)); }
+	size_t applyEdits();
+	size_t droppedEdits() const { return mEdits.dropped(); }
+
 private:
 	std::optional<std::string> mRule;
 	std::optional<BorderManagement> mBorderManagement;
@@ -86,20 +206,72 @@ private:
 	//     Bits non utilisés
 	//
 	uint32_t mParsedRule;
+	NeighborhoodTeamH::Mask mNeighborhood;
 
 	GridTeamH mData;
 	Color mDeadColor, mAliveColor;
 	uint64_t mColorEncoded;
 
+	RecorderTeamH mRecorder;
+	mutable InstrumentationTeamH mInstrumentation;	// mutable : updateImage est const
+	CycleDetectorTeamH mCycleDetector;
+	bool mCycleSkipping;
+
+	DomainDecompositionTeamH mDecomposition;
+	size_t mProcessCount;
+	bool mDecompositionLoaded;	// Les tranches contiennent la grille courante
+
+	// Résultat du noyau pour un groupe de rangées.
+	struct KernelResult {
+		size_t aliveCount;
+		uint64_t hash;	// Empreinte des rangées calculées (voir hashRow)
+	};
+
+	std::unique_ptr<ThreadPoolTeamH> mThreadPool;
+	TileSchedulerTeamH mScheduler;
+
+	ChangeSetTeamH mChanges;
+	bool mTrackChanges;
+
+	HistoryTeamH mHistory;
+
+	mutable DensityPyramidTeamH mPyramid;	// mutable : reconstruite au besoin par le rendu
+	bool mPyramidEnabled;
+
+	EditQueueTeamH mEdits;
+
+	// Accès aux noyaux internes pour les microbancs d'essai (GOLBench).
+	friend struct KernelAccessTeamH;
+	// Les travailleurs utilisent evolveRows.
+	friend class DomainDecompositionTeamH;
+
 	// Fonctions utilisées à l'interne.
-	unsigned char convertCharToNumber(const char c);
+	KernelResult processRows(size_t rowBegin, size_t rowEnd);
+	KernelResult processInterior();
+	KernelResult processInteriorCounted();
+	KernelResult processBlocks();
+	static KernelResult evolveRows(const uint8_t* data, uint8_t* intData, size_t width,
+		size_t rowBegin, size_t rowEnd, uint32_t parsedRule, NeighborhoodTeamH::Mask neighborhood,
+		ChangeSetTeamH* changes = nullptr);
+	static TileSchedulerTeamH::TileResult evolveTile(const uint8_t* data, uint8_t* intData, size_t width,
+		size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd, uint32_t parsedRule,
+		NeighborhoodTeamH::Mask neighborhood, ChangeSetTeamH* changes = nullptr);
+	uint64_t hashBorder() const;
+	void recordBorderChanges();
+	bool skipCycle();
+	bool useDecomposition() const;
+	void processDistributed(size_t steps);
+	void resetHistory();
+	void invalidateCaches();
+	void pushHistory();
+	void updatePyramid();
 	std::optional<sizeQueried> parsePattern(std::string const& pattern);
 	void fillDataFromPattern(sizeQueried& sq, int centerX, int centerY);
 	void countLifeStatusCells();
 
 	// Fonction qui modifie le border selon la règle
 	void modifyBorderIfNecessary();
-	size_t countNeighbors(const uint8_t* ptrGrid) const;
+	size_t countNeighbors(size_t column, size_t row) const;
 };
 
-#endif GOLTEAMH_H
\ No newline at end of file
+#endif // GOLTEAMH_H
\ No newline at end of file
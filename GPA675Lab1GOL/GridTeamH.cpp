@@ -1,7 +1,11 @@
 ﻿#include "GridTeamH.h"
 #include "GOL.h"
+#include "ThreadPoolTeamH.h"
 
+#include <cmath>
+#include <cstring>
 #include <optional>
+#include <tuple>
 #include <utility>
 
 // Constructeur Grid par défaut
@@ -11,9 +15,10 @@ GridTeamH::GridTeamH()
 }
 
 GridTeamH::GridTeamH(size_t width, size_t height, CellType initValue)
-	:mWidth{ width }, mHeight{ height }, mEngine(mRandomDevice()), mDistribution(0.0, 1.0)
-	, mAliveCount{}, mLastGenAliveCount{}
-	, mData{}, mIntermediateData{}
+	: mData{}, mIntermediateData{}, mWidth{ width }, mHeight{ height }
+	, mAliveCount{}, mLastGenAliveCount{}, mPool{}
+	, mLayout{ Layout::rowMajor }, mBlocksX{}, mBlocksY{}
+	, mEngine(mRandomDevice()), mDistribution(0.0, 1.0)
 {
 	resize(width, height, initValue);
 }
@@ -21,14 +26,17 @@ GridTeamH::GridTeamH(size_t width, size_t height, CellType initValue)
 GridTeamH::GridTeamH(GridTeamH const& cpy)
 	: GridTeamH(cpy.width(), cpy.height(), CellType::alive)
 {
+	setLayout(cpy.mLayout);
 	mAliveCount = cpy.mAliveCount;
 	mLastGenAliveCount = cpy.mLastGenAliveCount;
-	memcpy(mData, cpy.mData, cpy.size() * sizeof(CellType));
-	memcpy(mIntermediateData, cpy.mIntermediateData, cpy.size() * sizeof(CellType));
+	mTendency = cpy.mTendency;
+	memcpy(mData, cpy.mData, cpy.storageSize() * sizeof(CellType));
+	memcpy(mIntermediateData, cpy.mIntermediateData, cpy.storageSize() * sizeof(CellType));
 }
 
 // https://learn.microsoft.com/en-us/cpp/cpp/move-constructors-and-move-assignment-operators-cpp
 GridTeamH::GridTeamH(GridTeamH&& mv) noexcept
+	: mData{}, mIntermediateData{}, mPool{}, mLayout{ Layout::rowMajor }, mBlocksX{}, mBlocksY{}
 {
 	*this = std::move(mv);
 }
@@ -43,12 +51,15 @@ GridTeamH& GridTeamH::operator=(GridTeamH const& cpy)
 		mHeight = cpy.mHeight;
 		mAliveCount = cpy.mAliveCount;
 		mLastGenAliveCount = cpy.mLastGenAliveCount;
+		mTendency = cpy.mTendency;
+		mLayout = cpy.mLayout;
+		buildBlocks();
 
-		mData = new CellType[mWidth * mHeight];
-		mIntermediateData = new CellType[mWidth * mHeight];
+		mData = new CellType[storageSize()];
+		mIntermediateData = new CellType[storageSize()];
 
-		memcpy(mData, cpy.mData, cpy.size() * sizeof(CellType));
-		memcpy(mIntermediateData, cpy.mIntermediateData, cpy.size() * sizeof(CellType));
+		memcpy(mData, cpy.mData, cpy.storageSize() * sizeof(CellType));
+		memcpy(mIntermediateData, cpy.mIntermediateData, cpy.storageSize() * sizeof(CellType));
 	}
 
 	return *this;
@@ -63,8 +74,15 @@ GridTeamH& GridTeamH::operator=(GridTeamH&& mv) noexcept
 
 		mAliveCount = mv.mAliveCount;
 		mLastGenAliveCount = mv.mLastGenAliveCount;
+		mTendency = mv.mTendency;
+		mPool = mv.mPool;
 		mWidth = mv.mWidth;
 		mHeight = mv.mHeight;
+		mLayout = mv.mLayout;
+		mBlocksX = mv.mBlocksX;
+		mBlocksY = mv.mBlocksY;
+		mBlockSlots = std::move(mv.mBlockSlots);
+		mBlockOrder = std::move(mv.mBlockOrder);
 		mData = mv.mData;
 		mIntermediateData = mv.mIntermediateData;
 
@@ -89,11 +107,206 @@ void GridTeamH::resize(size_t width, size_t height, CellType initValue)
 
 	mWidth = width;
 	mHeight = height;
+	buildBlocks();
 
-	mData = new CellType[width * height];
-	mIntermediateData = new CellType[width * height];
+	// Aucune page n'est touchée par l'allocation (pas d'initialisation).
+	mData = new CellType[storageSize()];
+	mIntermediateData = new CellType[storageSize()];
 
+	if (mPool) {
+		firstTouch(nullptr, nullptr, initValue);
+		return;
+	}
+
+	// Les cellules de remplissage des blocs du bord ne sont jamais lues, mais
+	// restent définies.
+	if (mLayout == Layout::tiled)
+		memset(mData, 0, storageSize() * sizeof(CellType));
 	fill(initValue, true);
+
+	// Le tableau intermédiaire doit aussi être initialisé : sa bordure n'est
+	// pas toujours réécrite par processOneStep.
+	memcpy(mIntermediateData, mData, storageSize() * sizeof(CellType));
+}
+
+void GridTeamH::setLayout(Layout layout)
+{
+	if (layout == mLayout)
+		return;
+
+	auto const oldLayout{ mLayout };
+	auto* oldData{ mData }, * oldIntermediate{ mIntermediateData };
+
+	mLayout = layout;
+	mData = new CellType[storageSize()]{};
+	mIntermediateData = new CellType[storageSize()]{};
+
+	// Copie par morceaux d'au plus BLOCK_SIZE cellules, contigus dans les
+	// deux dispositions.
+	for (size_t row{}; row < mHeight; ++row) {
+		for (size_t column{}; column < mWidth; column += BLOCK_SIZE) {
+			auto const from{ offset(oldLayout, column, row) }, to{ offset(column, row) };
+			auto const count{ std::min(BLOCK_SIZE, mWidth - column) };
+			memcpy(mData + to, oldData + from, count * sizeof(CellType));
+			memcpy(mIntermediateData + to, oldIntermediate + from, count * sizeof(CellType));
+		}
+	}
+
+	delete[] oldData;
+	delete[] oldIntermediate;
+
+	// Replace les pages par bande si le mode NUMA est actif.
+	if (mPool)
+		setThreadPool(mPool);
+}
+
+size_t GridTeamH::storageSize() const
+{
+	return mLayout == Layout::rowMajor ? mWidth * mHeight : mBlockOrder.size() * BLOCK_CELLS;
+}
+
+// Ordre Z des blocs : tri selon le code de Morton (bits de bx et de by
+// entrelacés). Des blocs voisins sont ainsi proches en mémoire dans les
+// deux directions.
+void GridTeamH::buildBlocks()
+{
+	mBlocksX = (mWidth + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	mBlocksY = (mHeight + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+	auto morton = [](uint64_t x, uint64_t y) {
+		uint64_t code{};
+		for (unsigned bit{}; bit < 32; ++bit)
+			code |= ((x >> bit) & 1) << (2 * bit) | ((y >> bit) & 1) << (2 * bit + 1);
+		return code;
+		};
+
+	mBlockOrder.resize(mBlocksX * mBlocksY);
+	for (size_t i{}; i < mBlockOrder.size(); ++i)
+		mBlockOrder[i] = static_cast<uint32_t>(i);
+	std::sort(mBlockOrder.begin(), mBlockOrder.end(), [this, &morton](uint32_t a, uint32_t b) {
+		return morton(a % mBlocksX, a / mBlocksX) < morton(b % mBlocksX, b / mBlocksX);
+		});
+
+	mBlockSlots.resize(mBlockOrder.size());
+	for (size_t i{}; i < mBlockOrder.size(); ++i)
+		mBlockSlots[mBlockOrder[i]] = static_cast<uint32_t>(i);
+}
+
+std::pair<size_t, size_t> GridTeamH::blockPosition(size_t index) const
+{
+	return { mBlockOrder[index] % mBlocksX, mBlockOrder[index] / mBlocksX };
+}
+
+void GridTeamH::gatherBlock(size_t index, uint8_t* window) const
+{
+	constexpr size_t stride{ BLOCK_SIZE + 2 }, last{ BLOCK_SIZE - 1 };
+	auto const [bx, by] = blockPosition(index);
+	auto const* data{ reinterpret_cast<const uint8_t*>(mData) };
+
+	// Blocs voisins, nullptr hors de la grille (bx - 1 déborde à 0).
+	const uint8_t* blocks[3][3];
+	bool complete{ true };
+	for (size_t dy{}; dy < 3; ++dy) {
+		for (size_t dx{}; dx < 3; ++dx) {
+			auto const x{ bx + dx - 1 }, y{ by + dy - 1 };
+			blocks[dy][dx] = (x < mBlocksX && y < mBlocksY)
+				? data + size_t{ mBlockSlots[y * mBlocksX + x] } * BLOCK_CELLS : nullptr;
+			complete = complete && blocks[dy][dx];
+		}
+	}
+	if (!complete)
+		memset(window, 0, stride * stride);
+
+	// Rangée `row` des blocs de la rangée de blocs `dy` vers la rangée `r` de
+	// la fenêtre. Les colonnes de remplissage des blocs du bord sont copiées
+	// aussi : elles ne servent jamais au calcul d'une cellule de la grille.
+	auto copyRow = [&](size_t dy, size_t row, size_t r) {
+		auto* out{ window + r * stride };
+		if (blocks[dy][0])
+			out[0] = blocks[dy][0][row * BLOCK_SIZE + last];
+		memcpy(out + 1, blocks[dy][1] + row * BLOCK_SIZE, BLOCK_SIZE);
+		if (blocks[dy][2])
+			out[stride - 1] = blocks[dy][2][row * BLOCK_SIZE];
+		};
+
+	if (blocks[0][1])
+		copyRow(0, last, 0);
+	for (size_t row{}; row < BLOCK_SIZE; ++row)
+		copyRow(1, row, row + 1);
+	if (blocks[2][1])
+		copyRow(2, 0, stride - 1);
+}
+
+void GridTeamH::copyTo(CellType* destination) const
+{
+	forEachSpan(0, mHeight, [&](size_t row, size_t column, DataType cells, size_t count) {
+		memcpy(destination + row * mWidth + column, cells, count * sizeof(CellType));
+		});
+}
+
+void GridTeamH::copyFrom(CellType const* source)
+{
+	forEachSpan(0, mHeight, [&](size_t row, size_t column, DataType cells, size_t count) {
+		memcpy(cells, source + row * mWidth + column, count * sizeof(CellType));
+		});
+}
+
+void GridTeamH::setThreadPool(ThreadPoolTeamH* pool)
+{
+	mPool = pool;
+	if (!mPool || !mData)
+		return;
+
+	// Les pages existantes sont sur le noeud du fil qui les a touchées : on
+	// recopie les tableaux dans de nouvelles pages touchées par chaque bande.
+	auto* oldData{ mData }, * oldIntermediate{ mIntermediateData };
+	mData = new CellType[storageSize()];
+	mIntermediateData = new CellType[storageSize()];
+
+	firstTouch(oldData, oldIntermediate, CellType{});
+
+	delete[] oldData;
+	delete[] oldIntermediate;
+}
+
+// Chaque fil du bassin écrit sa bande (la même que pour la simulation) des
+// deux tableaux : ses pages sont placées sur son noeud NUMA. En rowMajor, les
+// bandes sont des rangées et le premier et le dernier fil écrivent aussi les
+// rangées de bordure ; en tiled, ce sont des suites de blocs dans l'ordre Z.
+// Les bandes sont copiées des sources si elles sont présentes, sinon
+// remplies avec `value`.
+//
+// Les deux tableaux ont le même placement : switchToIntermediate le conserve.
+void GridTeamH::firstTouch(DataType source, DataType intermediateSource, CellType value)
+{
+	auto const workers{ mPool->threadCount() };
+	bool const rows{ mLayout == Layout::rowMajor };
+	auto const unitSize{ rows ? mWidth : BLOCK_CELLS };
+
+	mPool->run([&](size_t worker) {
+		size_t begin, end;
+		if (rows) {
+			std::tie(begin, end) = ThreadPoolTeamH::partition(worker, workers, 1, mHeight > 1 ? mHeight - 1 : mHeight);
+			if (worker == 0)
+				begin = 0;
+			if (worker + 1 == workers)
+				end = mHeight;
+		}
+		else
+			std::tie(begin, end) = ThreadPoolTeamH::partition(worker, workers, 0, blockCount());
+		if (begin >= end)
+			return;
+
+		auto const offset{ begin * unitSize }, count{ (end - begin) * unitSize };
+		if (source) {
+			memcpy(mData + offset, source + offset, count * sizeof(CellType));
+			memcpy(mIntermediateData + offset, intermediateSource + offset, count * sizeof(CellType));
+		}
+		else {
+			memset(mData + offset, static_cast<int>(value), count * sizeof(CellType));
+			memset(mIntermediateData + offset, static_cast<int>(value), count * sizeof(CellType));
+		}
+		});
 }
 
 
@@ -110,13 +323,13 @@ void GridTeamH::dealloc()
 // Accesseur retournant la valeur d'une cellule à une certaine coordonnée.
 GridTeamH::CellType GridTeamH::value(int column, int row) const
 {
-	return mData[(static_cast<unsigned long long>(row) - 1) * mWidth + (static_cast<unsigned long long>(column) - 1)];
+	return mData[offset(static_cast<size_t>(column) - 1, static_cast<size_t>(row) - 1)];
 }
 
 // Mutateur modifiant la valeur d'une cellule à une certaine coordonnée.
 void GridTeamH::setValue(int column, int row, CellType value)
 {
-	mData[(static_cast<unsigned long long>(row) - 1) * mWidth + (static_cast<unsigned long long>(column) - 1)] = value;
+	mData[offset(static_cast<size_t>(column) - 1, static_cast<size_t>(row) - 1)] = value;
 }
 
 // Accesseur retournant la valeur d'une cellule à une certaine coordonnée. 
@@ -125,20 +338,38 @@ std::optional<GridTeamH::CellType> GridTeamH::at(int column, int row) const
 	if (column >= mWidth || row >= mHeight)
 		return std::nullopt;
 
-	return mData[(row - 1) * mWidth + (column - 1)];
+	return mData[offset(static_cast<size_t>(column) - 1, static_cast<size_t>(row) - 1)];
 }
 
 
 // Mutateur modifiant la valeur d'une cellule à une certaine coordonnée.
 void GridTeamH::setAt(int column, int row, CellType value)
 {
-	mData[(static_cast<unsigned long long>(row) - 1) * mWidth + (static_cast<unsigned long long>(column) - 1)] = value;
+	mData[offset(static_cast<size_t>(column) - 1, static_cast<size_t>(row) - 1)] = value;
 }
 
 void GridTeamH::setAliveCount(size_t aliveCount)
 {
 	mLastGenAliveCount = mAliveCount;
 	mAliveCount = aliveCount;
+	mTendency.push(aliveCount);
+}
+
+// Nouveau compte qui ne découle pas d'une génération (remplissage,
+// modification manuelle) : l'historique de la tendance repart de zéro.
+void GridTeamH::resetAliveCount(size_t aliveCount)
+{
+	mLastGenAliveCount = aliveCount;
+	mAliveCount = aliveCount;
+	mTendency.reset(aliveCount);
+}
+
+// Générations sautées d'un cycle de période `period` (voir
+// GOLTeamH::processSteps). Les comptes courants ne changent pas puisqu'on
+// saute un multiple de la période.
+void GridTeamH::repeatAliveCounts(size_t period, size_t generations)
+{
+	mTendency.repeat(period, generations);
 }
 
 // Accesseur en lecture seule sur le "buffer" de la grille.
@@ -203,37 +434,73 @@ float GridTeamH::lastGenAliveRel() const
 	return static_cast<float>(lastGenAlive()) / static_cast<float>(size());
 }
 
+// Variation moyenne du nombre de cellules vivantes par génération sur la
+// fenêtre de TendencyTeamH. Positive si la population croît.
 int GridTeamH::tendencyAbs() const
 {
-	return lastGenAlive() - totalAlive();
+	return static_cast<int>(std::lround(tendencySlope()));
 }
 
 float GridTeamH::tendencyRel() const
 {
-	return static_cast<float>(tendencyAbs()) / static_cast<float>(size());
+	return static_cast<float>(tendencySlope() / static_cast<double>(size()));
 }
 
+double GridTeamH::tendencySlope() const
+{
+	return mTendency.slope();
+}
+
+double GridTeamH::tendencyVariance() const
+{
+	return mTendency.residualVariance();
+}
+
+char GridTeamH::tendencyStability() const
+{
+	return mTendency.stability();
+}
+
+// Les remplissages parcourent les suites contiguës de forEachSpan, en se
+// limitant à l'intérieur si fillBorder est faux.
 void GridTeamH::fill(CellType value, bool fillBorder)
 {
-	for (size_t i{ static_cast<size_t>(1) - fillBorder }; i < mWidth - (static_cast<size_t>(1) - fillBorder); i++)
-		for (size_t j{ static_cast<size_t>(1) - fillBorder }; j < mHeight - (static_cast<size_t>(1) - fillBorder); ++j)
-			mData[i + (j * mWidth)] = value;
+	size_t const margin{ !fillBorder };
+	if (mWidth <= 2 * margin || mHeight <= 2 * margin)
+		return;
+
+	forEachSpan(margin, mHeight - margin, [&](size_t, size_t column, DataType cells, size_t count) {
+		auto const first{ std::max(column, margin) }, last{ std::min(column + count, mWidth - margin) };
+		if (first < last)
+			memset(cells + (first - column), static_cast<int>(value), (last - first) * sizeof(CellType));
+		});
 }
 
 void GridTeamH::fillAlternately(CellType initValue, bool fillBorder)
 {
 	auto otherValue = (initValue == CellType::alive) ? CellType::dead : CellType::alive;
+	size_t const margin{ !fillBorder };
+	if (mWidth <= 2 * margin || mHeight <= 2 * margin)
+		return;
 
-	for (size_t i{ static_cast<size_t>(1) - fillBorder }; i < mWidth - (static_cast<size_t>(1) - fillBorder); i++)
-		for (size_t j{ static_cast<size_t>(1) - fillBorder }; j < mHeight - (static_cast<size_t>(1) - fillBorder); ++j)
-			mData[i + (j * mWidth)] = !((i + j) % 2) ? initValue : otherValue;
+	forEachSpan(margin, mHeight - margin, [&](size_t row, size_t column, DataType cells, size_t count) {
+		auto const first{ std::max(column, margin) }, last{ std::min(column + count, mWidth - margin) };
+		for (size_t i{ first }; i < last; ++i)
+			cells[i - column] = !((i + row) % 2) ? initValue : otherValue;
+		});
 }
 
 void GridTeamH::randomize(double percentAlive, bool fillBorder)
 {
-	for (size_t i{ static_cast<size_t>(1) - fillBorder }; i < mWidth - (static_cast<size_t>(1) - fillBorder); i++)
-		for (size_t j{ static_cast<size_t>(1) - fillBorder }; j < mHeight - (static_cast<size_t>(1) - fillBorder); ++j)
-			mData[i + (j * mWidth)] = static_cast<GridTeamH::CellType>(mDistribution(mEngine) < percentAlive);
+	size_t const margin{ !fillBorder };
+	if (mWidth <= 2 * margin || mHeight <= 2 * margin)
+		return;
+
+	forEachSpan(margin, mHeight - margin, [&](size_t, size_t column, DataType cells, size_t count) {
+		auto const first{ std::max(column, margin) }, last{ std::min(column + count, mWidth - margin) };
+		for (size_t i{ first }; i < last; ++i)
+			cells[i - column] = static_cast<GridTeamH::CellType>(mDistribution(mEngine) < percentAlive);
+		});
 }
 
 void GridTeamH::fillBorder(CellType value)
@@ -242,36 +509,21 @@ void GridTeamH::fillBorder(CellType value)
 	fillBorderOperation(mIntermediateData, value);
 }
 
-void GridTeamH::fillBorderOperation(DataType ptr, CellType value) const
+bool GridTeamH::borderIsStable() const
 {
-	auto* e_ptr = ptr + (mWidth - 1);
-
-	// TOP
-	while (ptr < e_ptr) {
-		*ptr = value;
-		ptr++;
-	}
-
-	// DROITE
-	e_ptr += mWidth * (mHeight - 1);
-	while (ptr < e_ptr) {
-		*ptr = value;
-		ptr += mWidth;
-	}
-
-	// DESSOUS
-	e_ptr -= (mWidth - 1);
-	while (ptr > e_ptr) {
-		*ptr = value;
-		ptr--;
-	}
+	bool stable{ true };
+	forEachBorderCell([&](size_t column, size_t row) {
+		auto const index{ offset(column, row) };
+		stable = stable && mData[index] == mIntermediateData[index];
+		});
+	return stable;
+}
 
-	// GAUCHE
-	e_ptr -= mWidth * (mHeight - 1);
-	while (ptr > e_ptr) {
-		*ptr = value;
-		ptr -= mWidth;
-	}
+void GridTeamH::fillBorderOperation(DataType ptr, CellType value) const
+{
+	forEachBorderCell([&](size_t column, size_t row) {
+		ptr[offset(column, row)] = value;
+		});
 }
 
 void GridTeamH::switchToIntermediate()
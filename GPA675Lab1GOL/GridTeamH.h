@@ -2,8 +2,15 @@
 #ifndef GRIDTEAMH_H
 #define GRIDTEAMH_H
 
+#include <algorithm>
+#include <cstdint>
 #include <random>
+#include <utility>
+#include <vector>
 #include "GOL.h"
+#include "TendencyTeamH.h"
+
+class ThreadPoolTeamH;
 
 // Fichier : GridTeam.h
 // GPA675 – Laboratoire 1 
@@ -20,6 +27,10 @@
 // La classe point représente une grille dans l’espace 2d des réels.
 // Deux tableaux sont utilisés, un réel et un intermédiaire.
 // Elle comporte des méthodes pour manipuler les cellules de la grille et en sortir des statistiques.
+//
+// Deux dispositions mémoire sont possibles (voir Layout). Le code qui ne
+// passe pas par value()/setValue() doit utiliser offset(), forEachSpan() ou
+// forEachBorderCell() plutôt que de supposer des rangées contiguës.
 
 class GridTeamH
 {
@@ -28,6 +39,14 @@ public:
 	using CellType = GOL::State;
 	using DataType = CellType*;
 
+	// rowMajor : rangée par rangée (voisins du dessus et du dessous à
+	// mWidth octets). tiled : blocs de BLOCK_SIZE x BLOCK_SIZE cellules
+	// (une page de 4 ko), rangés selon une courbe de Morton (ordre Z) ;
+	// chaque bloc est contigu, rangée par rangée.
+	enum class Layout { rowMajor, tiled };
+	static constexpr size_t BLOCK_SIZE{ 64 };
+	static constexpr size_t BLOCK_CELLS{ BLOCK_SIZE * BLOCK_SIZE };
+
 	// Définition des constructeurs / destructeur
 	GridTeamH();
 	GridTeamH(size_t width, size_t height, CellType initValue = CellType{});
@@ -46,6 +65,62 @@ public:
 
 	void resize(size_t width, size_t height, CellType initValue = CellType{});
 
+	// Change la disposition des deux tableaux en conservant leur contenu.
+	void setLayout(Layout layout);
+	Layout layout() const { return mLayout; }
+	// Taille allouée par tableau (les blocs du bord sont complets en tiled).
+	size_t storageSize() const;
+
+	// Mode NUMA : chaque fil du bassin touche en premier sa bande de rangées
+	// des deux tableaux (voir ThreadPoolTeamH::partition). nullptr le désactive.
+	void setThreadPool(ThreadPoolTeamH* pool);
+
+	// Position de la cellule (column, row), à partir de 0, dans les tableaux.
+	size_t offset(size_t column, size_t row) const { return offset(mLayout, column, row); }
+
+	// Appelle function(row, column, cells, count) pour chaque suite contiguë
+	// de cellules des rangées [rowBegin, rowEnd) de data(), de gauche à
+	// droite : une par rangée en rowMajor, une par bloc en tiled.
+	template <typename Function>
+	void forEachSpan(size_t rowBegin, size_t rowEnd, Function function) const
+	{
+		auto const step{ mLayout == Layout::rowMajor ? mWidth : BLOCK_SIZE };
+		for (size_t row{ rowBegin }; row < rowEnd; ++row)
+			for (size_t column{}; column < mWidth; column += step)
+				function(row, column, mData + offset(column, row), std::min(step, mWidth - column));
+	}
+
+	// Appelle function(column, row) une fois pour chaque cellule du contour.
+	template <typename Function>
+	void forEachBorderCell(Function function) const
+	{
+		if (mWidth == 0 || mHeight == 0)
+			return;
+
+		for (size_t column{}; column < mWidth; ++column) {
+			function(column, size_t{});
+			if (mHeight > 1)
+				function(column, mHeight - 1);
+		}
+		for (size_t row{ 1 }; row + 1 < mHeight; ++row) {
+			function(size_t{}, row);
+			if (mWidth > 1)
+				function(mWidth - 1, row);
+		}
+	}
+
+	// Disposition tiled : nombre de blocs, position (en blocs) du bloc rangé
+	// à l'indice `index` et copie de sa fenêtre de (BLOCK_SIZE + 2)^2
+	// cellules (le bloc et une cellule de ses voisins) de data(), rangée par
+	// rangée. Les cellules hors de la grille ne sont pas significatives.
+	size_t blockCount() const { return mBlockOrder.size(); }
+	std::pair<size_t, size_t> blockPosition(size_t index) const;
+	void gatherBlock(size_t index, uint8_t* window) const;
+
+	// Copie de ou vers un tableau rangée par rangée de size() cellules.
+	void copyTo(CellType* destination) const;
+	void copyFrom(CellType const* source);
+
 	// Accesseurs et mutateurs des cellules
 	CellType value(int column, int row) const;
 	void setValue(int column, int row, CellType value);
@@ -54,6 +129,8 @@ public:
 	void setAt(int column, int row, CellType value);
 
 	void setAliveCount(size_t aliveCount);
+	void resetAliveCount(size_t aliveCount);
+	void repeatAliveCounts(size_t period, size_t generations);
 
 	// Accesseurs du "buffer" de la grille
 	DataType const& data() const;
@@ -77,6 +154,9 @@ public:
 
 	int tendencyAbs() const;
 	float tendencyRel() const;
+	double tendencySlope() const;
+	double tendencyVariance() const;
+	char tendencyStability() const;
 
 	// Méthode de remplissage
 	void fill(CellType value, bool fillBorder);
@@ -85,6 +165,9 @@ public:
 
 	// Méthode de gestion de bordure
 	void fillBorder(CellType value);
+	// Vrai si le contour est identique dans les deux grilles : sans
+	// recalcul du bord, il ne change alors plus d'une génération à l'autre.
+	bool borderIsStable() const;
 
 	// Alternance entre les deux grilles
 	void switchToIntermediate();
@@ -92,6 +175,13 @@ public:
 private:
 	DataType mData, mIntermediateData;
 	size_t mWidth, mHeight, mAliveCount, mLastGenAliveCount;
+	TendencyTeamH mTendency;
+	ThreadPoolTeamH* mPool;	// Non possédé
+
+	Layout mLayout;
+	size_t mBlocksX, mBlocksY;
+	std::vector<uint32_t> mBlockSlots;	// Bloc (by * mBlocksX + bx) -> rang dans l'ordre Z
+	std::vector<uint32_t> mBlockOrder;	// Rang dans l'ordre Z -> bloc
 
 	// Pour la génération de nombres aléatoires
 	std::random_device mRandomDevice;
@@ -101,6 +191,16 @@ private:
 	// Méthodes utilisées en interne
 	void fillBorderOperation(DataType ptr, CellType value) const;
 	void dealloc();
+	void firstTouch(DataType source, DataType intermediateSource, CellType value);
+	void buildBlocks();
+	size_t offset(Layout layout, size_t column, size_t row) const
+	{
+		if (layout == Layout::rowMajor)
+			return row * mWidth + column;
+
+		return size_t{ mBlockSlots[(row / BLOCK_SIZE) * mBlocksX + column / BLOCK_SIZE] } * BLOCK_CELLS
+			+ (row % BLOCK_SIZE) * BLOCK_SIZE + column % BLOCK_SIZE;
+	}
 };
 
-#endif GRIDTEAMH_H
\ No newline at end of file
+#endif // GRIDTEAMH_H
\ No newline at end of file
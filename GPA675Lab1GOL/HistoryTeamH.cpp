@@ -0,0 +1,159 @@
+﻿#include "HistoryTeamH.h"
+#include "DeltaCodecTeamH.h"
+
+#include <algorithm>
+
+HistoryTeamH::HistoryTeamH()
+	: mKeyframeInterval{}, mBudget{}, mUsage{}, mWidth{}, mHeight{}
+{
+}
+
+void HistoryTeamH::configure(size_t keyframeInterval, size_t budgetBytes)
+{
+	mKeyframeInterval = keyframeInterval;
+	mBudget = budgetBytes;
+	clear();
+}
+
+void HistoryTeamH::clear()
+{
+	mFrames.clear();
+	mPrevious.clear();
+	mPosition.reset();
+	mUsage = 0;
+}
+
+void HistoryTeamH::push(GOL::IterationType iteration, size_t aliveCount, GridTeamH const& grid)
+{
+	if (!enabled())
+		return;
+
+	if (grid.width() != mWidth || grid.height() != mHeight) {
+		clear();
+		mWidth = grid.width();
+		mHeight = grid.height();
+	}
+
+	// Générations suivantes d'une position restaurée : elles sont remplacées.
+	while (!mFrames.empty() && mFrames.back().iteration >= iteration) {
+		mUsage -= sizeof(Frame) + mFrames.back().data.size();
+		mFrames.pop_back();
+	}
+
+	// Nombre de différences depuis la dernière image clé.
+	size_t sinceKey{};
+	for (auto it{ mFrames.rbegin() }; it != mFrames.rend() && !it->key; ++it)
+		++sinceKey;
+
+	// La différence se calcule avec mPrevious, qui doit être la dernière
+	// génération conservée.
+	bool const key{ mFrames.empty() || sinceKey + 1 >= mKeyframeInterval ||
+		mPosition != mFrames.back().iteration };
+
+	pack(grid, mWords);
+	DeltaCodecTeamH::encodeXor(mWords, key ? std::vector<uint64_t>{} : mPrevious, mEncoded);
+
+	// Copie à la taille exacte : la mémoire comptée est celle réservée.
+	mFrames.push_back({ iteration, aliveCount, key, std::vector<uint8_t>(mEncoded.begin(), mEncoded.end()) });
+	mUsage += sizeof(Frame) + mFrames.back().data.size();
+
+	std::swap(mPrevious, mWords);
+	mPosition = iteration;
+	evict();
+}
+
+std::optional<HistoryTeamH::Restored> HistoryTeamH::restore(GOL::IterationType iteration, GridTeamH& grid)
+{
+	if (mFrames.empty() || grid.width() != mWidth || grid.height() != mHeight || mFrames.front().iteration > iteration)
+		return std::nullopt;
+
+	// La génération précédente est aussi reconstruite, dans le tableau
+	// intermédiaire : la grille est alors exactement comme après le calcul de
+	// la génération visée (le contour d'une bordure fixe en dépend).
+	auto const target{ indexOf(iteration) };
+	auto const previous{ target > 0 ? target - 1 : target };
+	auto first{ previous };
+	while (!mFrames[first].key)
+		--first;
+
+	for (auto i{ first }; i <= target; ++i) {
+		if (mFrames[i].key)
+			mWords.assign(DeltaCodecTeamH::wordCount(grid.size()), 0);
+		if (!DeltaCodecTeamH::decodeXorInto(mFrames[i].data.data(), mFrames[i].data.size(), mWords)) {
+			clear();
+			return std::nullopt;
+		}
+		if (i == previous && previous != target) {
+			unpack(mWords, grid);
+			grid.switchToIntermediate();
+		}
+	}
+	unpack(mWords, grid);
+
+	std::swap(mPrevious, mWords);
+	mPosition = mFrames[target].iteration;
+	return Restored{ mFrames[target].iteration, mFrames[target].aliveCount };
+}
+
+std::optional<GOL::IterationType> HistoryTeamH::oldest() const
+{
+	return mFrames.empty() ? std::nullopt : std::optional{ mFrames.front().iteration };
+}
+
+std::optional<GOL::IterationType> HistoryTeamH::newest() const
+{
+	return mFrames.empty() ? std::nullopt : std::optional{ mFrames.back().iteration };
+}
+
+std::optional<GOL::IterationType> HistoryTeamH::find(GOL::IterationType iteration) const
+{
+	if (mFrames.empty() || mFrames.front().iteration > iteration)
+		return std::nullopt;
+	return mFrames[indexOf(iteration)].iteration;
+}
+
+// Indice de la dernière génération conservée au plus `iteration` (il doit y
+// en avoir une).
+size_t HistoryTeamH::indexOf(GOL::IterationType iteration) const
+{
+	auto const it{ std::upper_bound(mFrames.begin(), mFrames.end(), iteration,
+		[](GOL::IterationType value, Frame const& frame) { return value < frame.iteration; }) };
+	return static_cast<size_t>(it - mFrames.begin()) - 1;
+}
+
+void HistoryTeamH::pack(GridTeamH const& grid, std::vector<uint64_t>& words)
+{
+	if (grid.layout() == GridTeamH::Layout::rowMajor)
+		DeltaCodecTeamH::pack(grid.data(), grid.size(), words);
+	else {
+		mStaging.resize(grid.size());
+		grid.copyTo(mStaging.data());
+		DeltaCodecTeamH::pack(mStaging.data(), grid.size(), words);
+	}
+}
+
+void HistoryTeamH::unpack(std::vector<uint64_t> const& words, GridTeamH& grid)
+{
+	if (grid.layout() == GridTeamH::Layout::rowMajor)
+		DeltaCodecTeamH::unpack(words, grid.data(), grid.size());
+	else {
+		mStaging.resize(grid.size());
+		DeltaCodecTeamH::unpack(words, mStaging.data(), mStaging.size());
+		grid.copyFrom(mStaging.data());
+	}
+}
+
+// Oublie les plus anciens groupes tant que le budget est dépassé. Le
+// premier élément est toujours une image clé.
+void HistoryTeamH::evict()
+{
+	while (mUsage > mBudget) {
+		auto const next{ std::find_if(mFrames.begin() + 1, mFrames.end(), [](Frame const& frame) { return frame.key; }) };
+		if (next == mFrames.end())
+			break;
+
+		for (auto it{ mFrames.begin() }; it != next; ++it)
+			mUsage -= sizeof(Frame) + it->data.size();
+		mFrames.erase(mFrames.begin(), next);
+	}
+}
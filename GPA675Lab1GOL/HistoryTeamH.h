@@ -0,0 +1,96 @@
+﻿#pragma once
+#ifndef HISTORYTEAMH_H
+#define HISTORYTEAMH_H
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include "GOL.h"
+#include "GridTeamH.h"
+
+// Fichier : HistoryTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/25
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe HistoryTeamH
+//
+// Historique borné des dernières générations, gardé en mémoire pour revenir
+// en arrière (GOLTeamH::stepBack, GOLTeamH::seek). Comme pour RecorderTeamH,
+// chaque génération est compactée à 1 bit par cellule et encodée par plages
+// (voir DeltaCodecTeamH) :
+// - une image clé toutes les `keyframeInterval` générations ajoutées ;
+// - entre deux, le XOR avec la génération ajoutée précédente.
+//
+// Reconstruire une génération décode au plus deux images clés et leurs
+// différences (la génération précédente est aussi reconstruite), au lieu de
+// tout recalculer depuis le début. Quand la mémoire utilisée dépasse le
+// budget, le plus ancien groupe (une image clé et ses différences) est
+// oublié ; le groupe le plus récent est toujours gardé.
+//
+// Les itérations ajoutées croissent mais peuvent sauter des valeurs (cycles
+// sautés, simulation répartie). Après restore(), les générations suivantes
+// restent disponibles jusqu'au prochain push(), qui les remplace.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class HistoryTeamH
+{
+public:
+	HistoryTeamH();
+
+	// keyframeInterval = 0 désactive l'historique.
+	void configure(size_t keyframeInterval, size_t budgetBytes);
+	bool enabled() const { return mKeyframeInterval > 0; }
+	size_t keyframeInterval() const { return mKeyframeInterval; }
+	size_t budget() const { return mBudget; }
+
+	void clear();
+
+	// Ajoute la génération `iteration` de la grille. Les générations
+	// conservées à partir de `iteration` sont d'abord retirées.
+	void push(GOL::IterationType iteration, size_t aliveCount, GridTeamH const& grid);
+
+	// Reconstruit la dernière génération conservée dont l'itération est au
+	// plus `iteration` dans `grid` (même taille). Retourne son itération et
+	// son nombre de cellules vivantes.
+	struct Restored {
+		GOL::IterationType iteration;
+		size_t aliveCount;
+	};
+	std::optional<Restored> restore(GOL::IterationType iteration, GridTeamH& grid);
+
+	bool empty() const { return mFrames.empty(); }
+	size_t frameCount() const { return mFrames.size(); }
+	size_t memoryUsage() const { return mUsage; }
+	std::optional<GOL::IterationType> oldest() const;
+	std::optional<GOL::IterationType> newest() const;
+	// Itération de la dernière génération conservée au plus `iteration`.
+	std::optional<GOL::IterationType> find(GOL::IterationType iteration) const;
+	// Itération de la dernière génération ajoutée ou restaurée.
+	std::optional<GOL::IterationType> position() const { return mPosition; }
+
+private:
+	struct Frame {
+		GOL::IterationType iteration;
+		size_t aliveCount;
+		bool key;
+		std::vector<uint8_t> data;
+	};
+
+	std::deque<Frame> mFrames;
+	std::vector<uint64_t> mPrevious, mWords;	// Génération à la position courante, tampon de travail
+	std::vector<uint8_t> mEncoded;
+	std::vector<GOL::State> mStaging;			// Copie rangée par rangée d'une grille tiled
+	std::optional<GOL::IterationType> mPosition;
+	size_t mKeyframeInterval, mBudget, mUsage, mWidth, mHeight;
+
+	size_t indexOf(GOL::IterationType iteration) const;
+	void pack(GridTeamH const& grid, std::vector<uint64_t>& words);
+	void unpack(std::vector<uint64_t> const& words, GridTeamH& grid);
+	void evict();
+};
+
+#endif // HISTORYTEAMH_H
@@ -0,0 +1,490 @@
+﻿#include "InfiniteGOLTeamH.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "BitKernelTeamH.h"
+#include "ParsingTeamH.h"
+#include "TraceTeamH.h"
+
+InfiniteGOLTeamH::InfiniteGOLTeamH()
+	: mParsedRule{ *ParsingTeamH::parseRule("B3/S23") }, mWidth{}, mHeight{}
+	, mAliveCount{}
+	, mDeadColor{}, mAliveColor{}, mEngine(mRandomDevice())
+{
+}
+
+//! \brief Accesseurs retournant des informations générales sur la 
+//! simulation en cours.
+//! 
+//! \details Contrairement à GOLTeamH, la largeur, la hauteur et le nombre
+//! de cellules sont ceux de la boîte englobante des cellules vivantes et non
+//! ceux de la fenêtre. La tendance est calculée sur les 
+//! TendencyTeamH::WINDOW_SIZE dernières itérations.
+GOL::Statistics InfiniteGOLTeamH::statistics() const
+{
+	auto const box{ boundingBox() };
+	size_t const boxWidth{ box ? box->width() : 0 }, boxHeight{ box ? box->height() : 0 };
+	size_t const cells{ boxWidth * boxHeight };
+	auto const relative = [cells](size_t count) {
+		return cells ? static_cast<float>(count) / static_cast<float>(cells) : 0.0f;
+		};
+
+	return GOL::Statistics{
+		.rule = mRule,
+		.borderManagement = mBorderManagement,
+		.width = boxWidth,
+		.height = boxHeight,
+		.totalCells = cells,
+		.iteration = mIteration,
+		.totalDeadAbs = cells - mAliveCount,
+		.totalAliveAbs = mAliveCount,
+		.totalDeadRel = relative(cells - mAliveCount),
+		.totalAliveRel = relative(mAliveCount),
+		.tendencyAbs = static_cast<int>(std::lround(mTendency.slope())),
+		.tendencyRel = cells ? static_cast<float>(mTendency.slope() / static_cast<double>(cells)) : 0.0f
+	};
+}
+
+//! \brief Accesseur retournant les statistiques de statistics() ainsi que
+//! les informations propres à l'univers infini.
+InfiniteGOLTeamH::ExtendedStatistics InfiniteGOLTeamH::extendedStatistics() const
+{
+	ExtendedStatistics stats{};
+	static_cast<Statistics&>(stats) = statistics();
+	stats.boundingBox = boundingBox();
+	stats.tileCount = mTiles.size();
+	stats.memoryBytes = (mTiles.size() + mFreeTiles.size()) * sizeof(Tile);
+	return stats;
+}
+
+//! \brief Accesseurs retournant les informations sur la réalisation 
+//! de l'implémentation.
+GOL::ImplementationInformation InfiniteGOLTeamH::information() const
+{
+	return ImplementationInformation{
+		.title{"Laboratoire 1 - univers infini"},
+		.authors{{{"Leclaire-Fournier"}, {"Timothée"}, {"timothee.leclaire-fournier.1@ens.etsmtl.ca"}},
+		{{"Euzenat"}, {"Martin"}, {"martin.euzenat.1@ens.etsmtl.ca"}}},
+		.answers{{"L'univers est une table de hachage de tuiles de 64 x 64 cellules compactées à 1 bit. \
+Les tuiles sont allouées lorsque l'activité les atteint et libérées lorsqu'elles meurent."},
+		{"Chaque rangée de tuile est un mot de 64 bits. Les 8 voisins sont additionnés en tranches de bits \
+et la règle est appliquée à 64 cellules à la fois (voir BitKernelTeamH.h)."},
+		{"Seule la fenêtre (width x height) est dessinée, à partir de la cellule (0, 0) de l'univers."},
+		{"La règle est encodée comme dans GOLTeamH (voir ParsingTeamH.h)."}},
+		.optionnalComments{"Les règles B0 sont refusées : elles rempliraient l'univers infini."}
+	};
+}
+
+//! \brief Mutateur modifiant la taille de la fenêtre.
+//! 
+//! \details L'univers est vidé, puis la fenêtre est remplie avec l'état
+//! donné. Si l'une des dimensions est 0, les deux sont mises à 0.
+void InfiniteGOLTeamH::resize(size_t width, size_t height, State defaultState)
+{
+	if (width == 0 || height == 0)
+		width = height = 0;
+
+	mWidth = width;
+	mHeight = height;
+	fill(defaultState);
+}
+
+//! \brief Mutateur modifiant la règle de la simulation.
+//! 
+//! \details Voir GOL::setRule. Les règles avec naissance à 0 voisin sont
+//! refusées, de même que les voisinages autres que Moore.
+bool InfiniteGOLTeamH::setRule(std::string const& rule)
+{
+	auto const parsed{ ParsingTeamH::parseRule(rule) };
+
+	if (!parsed || (*parsed & 1u) || ParsingTeamH::parseNeighborhood(rule) != NeighborhoodTeamH::MOORE)
+		return false;
+
+	mRule = rule;
+	mParsedRule = *parsed;
+	restart();
+	return true;
+}
+
+//! \brief Mutateur modifiant la stratégie de gestion de bord.
+//! 
+//! \details Le plan infini n'a pas de bordure : la stratégie est conservée
+//! pour les statistiques mais n'a aucun effet.
+void InfiniteGOLTeamH::setBorderManagement(BorderManagement borderManagement)
+{
+	mBorderManagement = borderManagement;
+	restart();
+}
+
+//! \brief Mutateur modifiant l'état d'une cellule de la fenêtre.
+void InfiniteGOLTeamH::setState(int x, int y, State state)
+{
+	setCell(x, y, state == State::alive);
+	restart();
+}
+
+//! \brief Mutateur remplissant de façon uniforme toutes les cellules de 
+//! la fenêtre. Les cellules hors de la fenêtre sont mortes.
+void InfiniteGOLTeamH::fill(State state)
+{
+	clear();
+
+	if (state == State::alive)
+		for (size_t y{}; y < mHeight; ++y)
+			for (size_t x{}; x < mWidth; ++x)
+				setCell(x, y, true);
+
+	restart();
+}
+
+//! \brief Mutateur remplissant la fenêtre en damier. Les cellules hors de
+//! la fenêtre sont mortes.
+void InfiniteGOLTeamH::fillAlternately(State firstCell)
+{
+	clear();
+
+	for (size_t y{}; y < mHeight; ++y)
+		for (size_t x{ (firstCell == State::alive) ? y % 2 : (y + 1) % 2 }; x < mWidth; x += 2)
+			setCell(x, y, true);
+
+	restart();
+}
+
+//! \brief Mutateur remplissant la fenêtre de façon aléatoire. Les cellules
+//! hors de la fenêtre sont mortes.
+void InfiniteGOLTeamH::randomize(double percentAlive)
+{
+	clear();
+
+	std::uniform_real_distribution<> distribution(0.0, 1.0);
+	for (size_t y{}; y < mHeight; ++y)
+		for (size_t x{}; x < mWidth; ++x)
+			if (distribution(mEngine) < percentAlive)
+				setCell(x, y, true);
+
+	restart();
+}
+
+//! \brief Mutateur remplissant l'univers par le patron passé en argument.
+//! 
+//! \details L'univers est vidé puis le patron est centré sur (centerX,
+//! centerY). Le patron n'est pas tronqué par la fenêtre.
+bool InfiniteGOLTeamH::setFromPattern(std::string const& pattern, int centerX, int centerY)
+{
+	GOLTEAMH_TRACE_SCOPE("setFromPattern");
+	auto const parsed{ ParsingTeamH::parsePattern(pattern) };
+
+	if (!parsed)
+		return false;
+
+	clear();
+
+	auto const left{ static_cast<int64_t>(centerX) - static_cast<int64_t>(parsed->width / 2) };
+	auto const top{ static_cast<int64_t>(centerY) - static_cast<int64_t>(parsed->height / 2) };
+
+	for (size_t y{}; y < parsed->height; ++y)
+		for (size_t x{}; x < parsed->width; ++x)
+			if (parsed->cells[y * parsed->width + x] != '0')
+				setCell(left + static_cast<int64_t>(x), top + static_cast<int64_t>(y), true);
+
+	restart();
+	return true;
+}
+
+//! \brief Surcharge centrant le patron dans la fenêtre.
+bool InfiniteGOLTeamH::setFromPattern(std::string const& pattern)
+{
+	return setFromPattern(pattern, static_cast<int>(mWidth / 2), static_cast<int>(mHeight / 2));
+}
+
+void InfiniteGOLTeamH::setSolidColor(State state, Color const& color)
+{
+	if (state == State::alive)
+		mAliveColor = color;
+	else
+		mDeadColor = color;
+}
+
+//! \brief Fonction effectuant une itération de la simulation.
+//! 
+//! \details Les tuiles candidates sont les tuiles existantes et leurs
+//! voisines touchées par une cellule vivante du bord (une cellule morte sans
+//! voisin vivant ne peut pas naître puisque B0 est refusé). Les tuiles
+//! calculées vides sont remises dans la réserve.
+void InfiniteGOLTeamH::processOneStep()
+{
+	GOLTEAMH_TRACE_SCOPE("InfiniteGOLTeamH::processOneStep");
+
+	mCandidates.clear();
+	for (auto const& [tileKey, tile] : mTiles) {
+		auto const tx{ tileX(tileKey) }, ty{ tileY(tileKey) };
+		auto const top{ tile->rows.front() }, bottom{ tile->rows.back() };
+		uint64_t sides{};
+		for (auto row : tile->rows)
+			sides |= row;
+
+		mCandidates.push_back(tileKey);
+		if (top)
+			mCandidates.push_back(key(tx, ty - 1));
+		if (bottom)
+			mCandidates.push_back(key(tx, ty + 1));
+		if (sides & 1u)
+			mCandidates.push_back(key(tx - 1, ty));
+		if (sides >> 63)
+			mCandidates.push_back(key(tx + 1, ty));
+		if (top & 1u)
+			mCandidates.push_back(key(tx - 1, ty - 1));
+		if (top >> 63)
+			mCandidates.push_back(key(tx + 1, ty - 1));
+		if (bottom & 1u)
+			mCandidates.push_back(key(tx - 1, ty + 1));
+		if (bottom >> 63)
+			mCandidates.push_back(key(tx + 1, ty + 1));
+	}
+
+	std::sort(mCandidates.begin(), mCandidates.end());
+	mCandidates.erase(std::unique(mCandidates.begin(), mCandidates.end()), mCandidates.end());
+
+	size_t aliveCount{};
+	auto next{ allocate() };
+	for (auto candidate : mCandidates) {
+		if (!computeTile(candidate, *next))
+			continue;
+
+		for (auto row : next->rows)
+			aliveCount += std::popcount(row);
+		mNextTiles.emplace(candidate, std::move(next));
+		next = allocate();
+	}
+	mFreeTiles.push_back(std::move(next));
+
+	// Les anciennes tuiles retournent dans la réserve.
+	for (auto& [tileKey, tile] : mTiles)
+		mFreeTiles.push_back(std::move(tile));
+	mTiles.clear();
+	std::swap(mTiles, mNextTiles);
+
+	// La réserve ne dépasse pas le nombre de tuiles vivantes : la mémoire
+	// suit l'activité.
+	if (mFreeTiles.size() > mTiles.size())
+		mFreeTiles.resize(mTiles.size());
+
+	mIteration = mIteration.value_or(0) + 1;
+	mAliveCount = aliveCount;
+	mTendency.push(aliveCount);
+}
+
+//! \brief Fonction dessinant la fenêtre sur l'image passée en paramètre.
+void InfiniteGOLTeamH::updateImage(uint32_t* buffer, size_t buffer_size) const
+{
+	if (buffer == nullptr)
+		return;
+
+	GOLTEAMH_TRACE_SCOPE("InfiniteGOLTeamH::updateImage");
+
+	auto const encode = [](Color const& color) {
+		return 0xFF000000u | static_cast<uint32_t>(color.red) << 16 | static_cast<uint32_t>(color.green) << 8 | color.blue;
+		};
+	uint32_t const colors[2]{ encode(mDeadColor), encode(mAliveColor) };
+
+	auto const pixels{ std::min(buffer_size, mWidth * mHeight) };
+	auto* ptrBuffer{ buffer };
+
+	for (size_t y{}; y < mHeight && static_cast<size_t>(ptrBuffer - buffer) < pixels; ++y) {
+		for (size_t x{}; x < mWidth; x += TILE_SIZE) {
+			// Une tuile à la fois : une seule recherche par groupe de 64 cellules.
+			auto const* tile{ find(static_cast<int64_t>(x / TILE_SIZE), static_cast<int64_t>(y / TILE_SIZE)) };
+			auto const row{ tile ? tile->rows[y % TILE_SIZE] : 0 };
+			auto const count{ std::min<size_t>(TILE_SIZE, mWidth - x) };
+
+			for (size_t i{}; i < count && static_cast<size_t>(ptrBuffer - buffer) < pixels; ++i)
+				*ptrBuffer++ = colors[(row >> i) & 1u];
+		}
+	}
+
+	std::fill(ptrBuffer, buffer + buffer_size, 0u);
+}
+
+//! \brief Accesseur d'une cellule de l'univers.
+bool InfiniteGOLTeamH::cell(int64_t x, int64_t y) const
+{
+	auto const* tile{ find(x >> 6, y >> 6) };
+	return tile && ((tile->rows[y & (TILE_SIZE - 1)] >> (x & (TILE_SIZE - 1))) & 1u);
+}
+
+//! \brief Mutateur d'une cellule de l'univers. Ne remet pas l'itération à 0.
+//! 
+//! \details La tuile est allouée au besoin et libérée si elle devient vide.
+void InfiniteGOLTeamH::setCell(int64_t x, int64_t y, bool alive)
+{
+	auto const tileKey{ key(x >> 6, y >> 6) };
+	auto const bit{ 1ull << (x & (TILE_SIZE - 1)) };
+	auto found{ mTiles.find(tileKey) };
+
+	if (found == mTiles.end()) {
+		if (!alive)
+			return;
+		found = mTiles.emplace(tileKey, allocate()).first;
+	}
+
+	auto& row{ found->second->rows[y & (TILE_SIZE - 1)] };
+	row = alive ? (row | bit) : (row & ~bit);
+
+	if (!alive && std::all_of(found->second->rows.begin(), found->second->rows.end(), [](uint64_t r) { return r == 0; })) {
+		mFreeTiles.push_back(std::move(found->second));
+		mTiles.erase(found);
+	}
+}
+
+//! \brief Boîte englobante exacte des cellules vivantes, ou rien si
+//! l'univers est vide.
+std::optional<InfiniteGOLTeamH::BoundingBox> InfiniteGOLTeamH::boundingBox() const
+{
+	if (mTiles.empty())
+		return std::nullopt;
+
+	BoundingBox box{
+		.left = std::numeric_limits<int64_t>::max(), .top = std::numeric_limits<int64_t>::max(),
+		.right = std::numeric_limits<int64_t>::min(), .bottom = std::numeric_limits<int64_t>::min()
+	};
+
+	for (auto const& [tileKey, tile] : mTiles) {
+		auto const originX{ tileX(tileKey) * TILE_SIZE }, originY{ tileY(tileKey) * TILE_SIZE };
+		uint64_t columns{};
+		int64_t first{ -1 }, last{ -1 };
+
+		for (int64_t y{}; y < TILE_SIZE; ++y) {
+			if (tile->rows[y] == 0)
+				continue;
+			columns |= tile->rows[y];
+			if (first < 0)
+				first = y;
+			last = y;
+		}
+
+		box.left = std::min(box.left, originX + std::countr_zero(columns));
+		box.right = std::max(box.right, originX + (TILE_SIZE - 1) - std::countl_zero(columns));
+		box.top = std::min(box.top, originY + first);
+		box.bottom = std::max(box.bottom, originY + last);
+	}
+
+	return box;
+}
+
+size_t InfiniteGOLTeamH::KeyHash::operator()(Key key) const
+{
+	// Finaliseur de splitmix64.
+	key ^= key >> 30;
+	key *= 0xBF58476D1CE4E5B9ull;
+	key ^= key >> 27;
+	key *= 0x94D049BB133111EBull;
+	return static_cast<size_t>(key ^ (key >> 31));
+}
+
+InfiniteGOLTeamH::Key InfiniteGOLTeamH::key(int64_t tileX, int64_t tileY)
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(tileX)) << 32) | static_cast<uint32_t>(tileY);
+}
+
+int64_t InfiniteGOLTeamH::tileX(Key key)
+{
+	return static_cast<int32_t>(key >> 32);
+}
+
+int64_t InfiniteGOLTeamH::tileY(Key key)
+{
+	return static_cast<int32_t>(key & 0xFFFFFFFFu);
+}
+
+const InfiniteGOLTeamH::Tile* InfiniteGOLTeamH::find(int64_t tileX, int64_t tileY) const
+{
+	auto const found{ mTiles.find(key(tileX, tileY)) };
+	return found == mTiles.end() ? nullptr : found->second.get();
+}
+
+// Tuile vide, prise dans la réserve si possible.
+std::unique_ptr<InfiniteGOLTeamH::Tile> InfiniteGOLTeamH::allocate()
+{
+	std::unique_ptr<Tile> tile;
+
+	if (mFreeTiles.empty())
+		tile = std::make_unique<Tile>();
+	else {
+		tile = std::move(mFreeTiles.back());
+		mFreeTiles.pop_back();
+	}
+
+	tile->rows.fill(0);
+	return tile;
+}
+
+void InfiniteGOLTeamH::clear()
+{
+	for (auto& [tileKey, tile] : mTiles)
+		mFreeTiles.push_back(std::move(tile));
+	mTiles.clear();
+}
+
+// Remet l'itération à 0 et recompte les cellules après une modification.
+void InfiniteGOLTeamH::restart()
+{
+	mIteration = 0;
+	countLifeStatusCells();
+}
+
+// Calcule la prochaine génération de la tuile `tileKey` dans `next`.
+// Retourne false si la tuile calculée est vide.
+bool InfiniteGOLTeamH::computeTile(Key tileKey, Tile& next) const
+{
+	auto const tx{ tileX(tileKey) }, ty{ tileY(tileKey) };
+
+	const Tile* neighbors[3][3];
+	for (int dy{ -1 }; dy <= 1; ++dy)
+		for (int dx{ -1 }; dx <= 1; ++dx)
+			neighbors[dy + 1][dx + 1] = find(tx + dx, ty + dy);
+
+	// Colonnes ouest, centre et est, avec une rangée de plus en haut et en bas.
+	uint64_t columns[3][TILE_SIZE + 2];
+	for (int column{}; column < 3; ++column) {
+		auto const rowOf = [&](int tileRow, int y) {
+			auto const* tile{ neighbors[tileRow][column] };
+			return tile ? tile->rows[y] : 0;
+			};
+
+		columns[column][0] = rowOf(0, TILE_SIZE - 1);
+		for (int y{}; y < TILE_SIZE; ++y)
+			columns[column][y + 1] = rowOf(1, y);
+		columns[column][TILE_SIZE + 1] = rowOf(2, 0);
+	}
+
+	auto const& west{ columns[0] };
+	auto const& center{ columns[1] };
+	auto const& east{ columns[2] };
+	uint64_t any{};
+
+	for (int y{}; y < TILE_SIZE; ++y) {
+		next.rows[y] = BitKernelTeamH::evolve(
+			center[y], center[y + 1], center[y + 2],
+			west[y], west[y + 1], west[y + 2],
+			east[y], east[y + 1], east[y + 2],
+			mParsedRule);
+		any |= next.rows[y];
+	}
+
+	return any != 0;
+}
+
+void InfiniteGOLTeamH::countLifeStatusCells()
+{
+	size_t aliveCount{};
+	for (auto const& [tileKey, tile] : mTiles)
+		for (auto row : tile->rows)
+			aliveCount += std::popcount(row);
+
+	mAliveCount = aliveCount;
+	mTendency.reset(aliveCount);
+}
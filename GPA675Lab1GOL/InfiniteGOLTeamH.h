@@ -0,0 +1,149 @@
+﻿#pragma once
+#ifndef INFINITEGOLTEAMH_H
+#define INFINITEGOLTEAMH_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <GOL.h>
+#include "TendencyTeamH.h"
+
+// Fichier : InfiniteGOLTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/15
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe InfiniteGOLTeamH
+//
+// Jeu de la vie sur un plan infini. L'univers est une table de hachage de
+// tuiles de 64 x 64 cellules compactées à 1 bit (une rangée = un mot de
+// 64 bits). Une tuile est allouée lorsque l'activité l'atteint et libérée
+// dès qu'elle ne contient plus de cellule vivante : la mémoire suit la zone
+// active plutôt qu'un rectangle fixe.
+//
+// À chaque itération, on ne calcule que les tuiles existantes et les
+// voisines touchées par une cellule vivante de leur bord.
+//
+// width() et height() décrivent la fenêtre affichée, dont le coin supérieur
+// gauche est la cellule (0, 0) de l'univers. state(), setState(), fill(),
+// fillAlternately(), randomize() et updateImage() travaillent dans cette
+// fenêtre. statistics() décrit plutôt la boîte englobante des cellules
+// vivantes (largeur, hauteur et nombre de cellules).
+//
+// Il n'y a pas de bordure : borderManagement est conservé mais sans effet.
+// Les règles avec naissance à 0 voisin (B0...) sont refusées puisqu'elles
+// rempliraient l'univers entier en une itération.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class InfiniteGOLTeamH : public GOL
+{
+public:
+	static constexpr int TILE_SIZE{ 64 };
+
+	// Boîte englobante des cellules vivantes (bornes incluses).
+	struct BoundingBox {
+		int64_t left, top, right, bottom;
+
+		uint64_t width() const { return static_cast<uint64_t>(right - left + 1); }
+		uint64_t height() const { return static_cast<uint64_t>(bottom - top + 1); }
+	};
+
+	// Statistiques de GOL complétées par les informations propres à l'univers.
+	struct ExtendedStatistics : Statistics {
+		std::optional<BoundingBox> boundingBox;		//!< Absente si aucune cellule vivante
+		std::optional<size_t> tileCount;			//!< Tuiles allouées
+		std::optional<size_t> memoryBytes;			//!< Mémoire des tuiles (incluant la réserve)
+	};
+
+	InfiniteGOLTeamH();
+	InfiniteGOLTeamH(InfiniteGOLTeamH const&) = delete;
+	InfiniteGOLTeamH(InfiniteGOLTeamH&&) = delete;
+	InfiniteGOLTeamH& operator =(InfiniteGOLTeamH const&) = delete;
+	InfiniteGOLTeamH& operator =(InfiniteGOLTeamH&&) = delete;
+
+	virtual ~InfiniteGOLTeamH() = default;
+
+	// inline puisque trivial.
+	size_t width() const override { return mWidth; }
+	size_t height() const override { return mHeight; }
+	size_t size() const override { return mWidth * mHeight; }
+	State state(int x, int y) const override { return cell(x, y) ? State::alive : State::dead; }
+	std::string rule() const override { return mRule.value_or(std::string()); }
+	BorderManagement borderManagement() const override { return mBorderManagement.value_or(GOL::BorderManagement::immutableAsIs); }
+	Color color(State state) const override { return state == GOL::State::alive ? mAliveColor : mDeadColor; }
+
+	Statistics statistics() const override;
+	ExtendedStatistics extendedStatistics() const;
+	ImplementationInformation information() const override;
+
+	void resize(size_t width, size_t height, State defaultState) override;
+	bool setRule(std::string const& rule) override;
+	void setBorderManagement(BorderManagement borderManagement) override;
+	void setState(int x, int y, State state) override;
+	void fill(State state) override;
+	void fillAlternately(State firstCell) override;
+	void randomize(double percentAlive) override;
+	bool setFromPattern(std::string const& pattern, int centerX, int centerY) override;
+	bool setFromPattern(std::string const& pattern) override;
+	void setSolidColor(State state, Color const& color) override;
+	void processOneStep() override;
+	void updateImage(uint32_t* buffer, size_t buffer_size) const override;
+
+	// Accès à l'univers complet (coordonnées hors de la fenêtre permises).
+	bool cell(int64_t x, int64_t y) const;
+	void setCell(int64_t x, int64_t y, bool alive);
+
+	std::optional<BoundingBox> boundingBox() const;
+	size_t tileCount() const { return mTiles.size(); }
+
+private:
+	using Key = uint64_t;
+
+	struct Tile {
+		std::array<uint64_t, TILE_SIZE> rows;	// Bit x de rows[y] = cellule (x, y)
+	};
+
+	struct KeyHash {
+		size_t operator()(Key key) const;
+	};
+
+	using TileMap = std::unordered_map<Key, std::unique_ptr<Tile>, KeyHash>;
+
+	std::optional<std::string> mRule;
+	std::optional<BorderManagement> mBorderManagement;
+	std::optional<IterationType> mIteration;
+	uint32_t mParsedRule;	// Voir ParsingTeamH
+
+	size_t mWidth, mHeight;
+	TileMap mTiles, mNextTiles;
+	std::vector<std::unique_ptr<Tile>> mFreeTiles;	// Réserve pour éviter les allocations
+	std::vector<Key> mCandidates;
+	size_t mAliveCount;
+	TendencyTeamH mTendency;
+
+	Color mDeadColor, mAliveColor;
+
+	std::random_device mRandomDevice;
+	std::mt19937 mEngine;
+
+	// Fonctions utilisées à l'interne.
+	static Key key(int64_t tileX, int64_t tileY);
+	static int64_t tileX(Key key);
+	static int64_t tileY(Key key);
+
+	const Tile* find(int64_t tileX, int64_t tileY) const;
+	std::unique_ptr<Tile> allocate();
+	void clear();
+	void restart();
+	bool computeTile(Key key, Tile& next) const;
+	void countLifeStatusCells();
+};
+
+#endif // INFINITEGOLTEAMH_H
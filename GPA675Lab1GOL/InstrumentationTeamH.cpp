@@ -0,0 +1,112 @@
+﻿#include "InstrumentationTeamH.h"
+
+#include <algorithm>
+#include <vector>
+
+InstrumentationTeamH::InstrumentationTeamH()
+	: mWindows{}, mCounterTotals{}, mEnabled{}, mCountersEnabled{}
+{
+}
+
+// Retourne false si l'instrumentation n'a pas été compilée.
+bool InstrumentationTeamH::setEnabled(bool enabled)
+{
+	mEnabled = compiledIn && enabled;
+	return mEnabled == enabled;
+}
+
+void InstrumentationTeamH::reset()
+{
+	mWindows = {};
+	mCounterTotals = {};
+}
+
+void InstrumentationTeamH::add(Phase phase, uint64_t nanoseconds)
+{
+	auto& window{ mWindows[static_cast<size_t>(phase)] };
+
+	// Moyenne glissante en O(1) : on retire la valeur qui sort de la fenêtre.
+	if (window.count == WINDOW_SIZE)
+		window.sum -= window.samples[window.next];
+	else
+		window.count++;
+
+	window.samples[window.next] = nanoseconds;
+	window.sum += nanoseconds;
+	window.next = (window.next + 1) % WINDOW_SIZE;
+}
+
+std::optional<InstrumentationTeamH::Timing> InstrumentationTeamH::timing(Phase phase) const
+{
+	auto const& window{ mWindows[static_cast<size_t>(phase)] };
+	if (window.count == 0)
+		return std::nullopt;
+
+	std::vector<uint64_t> sorted(window.samples.begin(), window.samples.begin() + window.count);
+	std::sort(sorted.begin(), sorted.end());
+
+	auto percentile = [&sorted](double p) {
+		return static_cast<double>(sorted[static_cast<size_t>(p * (sorted.size() - 1) + 0.5)]);
+		};
+
+	return Timing{
+		.averageNs = static_cast<double>(window.sum) / window.count,
+		.p50Ns = percentile(0.50),
+		.p95Ns = percentile(0.95),
+		.p99Ns = percentile(0.99),
+		.lastNs = static_cast<double>(window.samples[(window.next + WINDOW_SIZE - 1) % WINDOW_SIZE]),
+		.samples = window.count
+	};
+}
+
+// Retourne false si l'instrumentation n'a pas été compilée ou si aucun
+// compteur n'est disponible pour le fil appelant.
+bool InstrumentationTeamH::setCountersEnabled(bool enabled)
+{
+	mCounterTotals = {};
+	mCountersEnabled = compiledIn && enabled && threadCounters().available();
+	return mCountersEnabled == enabled;
+}
+
+void InstrumentationTeamH::addCounters(Phase phase, PerfCountersTeamH::Sample const& delta, size_t calls)
+{
+	auto& totals{ mCounterTotals[static_cast<size_t>(phase)] };
+	totals.sum += delta;
+	totals.calls += calls;
+}
+
+std::optional<InstrumentationTeamH::Counters> InstrumentationTeamH::counters(Phase phase, size_t cells) const
+{
+	using Counter = PerfCountersTeamH::Counter;
+
+	auto const& totals{ mCounterTotals[static_cast<size_t>(phase)] };
+	if (totals.calls == 0)
+		return std::nullopt;
+
+	auto const divisor{ static_cast<double>(totals.calls) * static_cast<double>(std::max<size_t>(cells, 1)) };
+	auto average = [&](Counter counter) -> std::optional<double> {
+		auto const value{ totals.sum[counter] };
+		return value ? std::optional<double>(static_cast<double>(*value) / divisor) : std::nullopt;
+		};
+
+	Counters result{
+		.cycles = average(Counter::cycles),
+		.instructions = average(Counter::instructions),
+		.cacheMisses = average(Counter::cacheMisses),
+		.branchMisses = average(Counter::branchMisses),
+		.instructionsPerCycle = std::nullopt,
+		.calls = totals.calls
+	};
+	if (totals.sum[Counter::cycles].value_or(0) > 0 && totals.sum[Counter::instructions])
+		result.instructionsPerCycle = static_cast<double>(*totals.sum[Counter::instructions]) / static_cast<double>(*totals.sum[Counter::cycles]);
+	return result;
+}
+
+// Un essai d'ouverture par fil : un fil sans compteurs n'en a jamais.
+PerfCountersTeamH& InstrumentationTeamH::threadCounters()
+{
+	thread_local PerfCountersTeamH counters;
+	thread_local bool opened{ counters.open() };
+	(void)opened;
+	return counters;
+}
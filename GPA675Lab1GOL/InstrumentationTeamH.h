@@ -0,0 +1,155 @@
+﻿#pragma once
+#ifndef INSTRUMENTATIONTEAMH_H
+#define INSTRUMENTATIONTEAMH_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "PerfCountersTeamH.h"
+
+// Fichier : InstrumentationTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/09
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe InstrumentationTeamH
+//
+// Chronomètres par phase de processOneStep et de updateImage. Chaque phase
+// conserve une fenêtre glissante des dernières durées : la moyenne est tenue
+// à jour en O(1), les centiles sont calculés à la demande.
+//
+// Les chronomètres ne sont compilés que si GOLTEAMH_INSTRUMENTATION est
+// défini (option CMake du même nom). Sinon, GOLTEAMH_TIME_PHASE ne génère
+// aucun code. Une fois compilés, ils s'activent à l'exécution avec
+// setEnabled().
+//
+// Les mêmes portées peuvent aussi lire les compteurs matériels du fil
+// (PerfCountersTeamH : cycles, instructions, défauts de cache, mauvaises
+// prédictions) avec setCountersEnabled(). Chaque fil ouvre ses propres
+// compteurs au premier usage (threadCounters) ; le travail fait par
+// d'autres fils pour une phase s'ajoute avec addCounters(phase, delta, 0).
+// Sans compteurs disponibles (conteneur, perf_event_paranoid, autre
+// plateforme), setCountersEnabled() retourne false et rien n'est mesuré.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class InstrumentationTeamH
+{
+public:
+	enum class Phase : uint8_t {
+		interior = 0,	//!< Noyau intérieur (processRows)
+		border,			//!< Évaluation de la bordure
+		swap,			//!< Échange des tableaux
+		statistics,		//!< Suivi après l'échange (tendance, cycles, historique, pyramide) ;
+						//!< les cellules vivantes sont comptées dans interior
+		render,			//!< updateImage
+		phaseCount
+	};
+
+	struct Timing {
+		double averageNs;	//!< Moyenne sur la fenêtre
+		double p50Ns;		//!< Médiane
+		double p95Ns;		//!< 95e centile
+		double p99Ns;		//!< 99e centile
+		double lastNs;		//!< Dernière mesure
+		size_t samples;		//!< Nombre de mesures dans la fenêtre
+	};
+
+	// Moyennes par appel de la phase depuis l'activation, divisées par le
+	// nombre de cellules demandé. Un compteur indisponible est absent.
+	struct Counters {
+		std::optional<double> cycles;
+		std::optional<double> instructions;
+		std::optional<double> cacheMisses;
+		std::optional<double> branchMisses;
+		std::optional<double> instructionsPerCycle;	//!< Non divisé par les cellules
+		size_t calls;
+	};
+
+	static constexpr size_t WINDOW_SIZE{ 128 };
+
+#ifdef GOLTEAMH_INSTRUMENTATION
+	static constexpr bool compiledIn{ true };
+#else
+	static constexpr bool compiledIn{ false };
+#endif
+
+	InstrumentationTeamH();
+
+	bool enabled() const { return mEnabled; }
+	bool setEnabled(bool enabled);
+	void reset();
+
+	void add(Phase phase, uint64_t nanoseconds);
+	std::optional<Timing> timing(Phase phase) const;
+
+	bool countersEnabled() const { return mCountersEnabled; }
+	bool setCountersEnabled(bool enabled);
+
+	// Ajoute `delta` aux compteurs de la phase ; `calls` = 0 pour le travail
+	// d'un autre fil pendant un appel déjà compté.
+	void addCounters(Phase phase, PerfCountersTeamH::Sample const& delta, size_t calls = 1);
+	std::optional<Counters> counters(Phase phase, size_t cells = 1) const;
+
+	// Compteurs du fil appelant, ouverts à son premier appel.
+	static PerfCountersTeamH& threadCounters();
+
+	// Mesure la durée de sa portée et l'ajoute à la phase donnée.
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer(InstrumentationTeamH& instrumentation, Phase phase)
+			: mInstrumentation{ instrumentation.enabled() ? &instrumentation : nullptr }, mPhase{ phase }
+		{
+			if (!mInstrumentation)
+				return;
+			if (mInstrumentation->countersEnabled())
+				mCounters = threadCounters().read();
+			mStart = std::chrono::steady_clock::now();
+		}
+
+		~ScopedTimer()
+		{
+			if (!mInstrumentation)
+				return;
+			mInstrumentation->add(mPhase, static_cast<uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart).count()));
+			if (mInstrumentation->countersEnabled())
+				mInstrumentation->addCounters(mPhase, threadCounters().read() - mCounters);
+		}
+
+	private:
+		InstrumentationTeamH* mInstrumentation;
+		Phase mPhase;
+		std::chrono::steady_clock::time_point mStart;
+		PerfCountersTeamH::Sample mCounters;
+	};
+
+private:
+	struct Window {
+		std::array<uint64_t, WINDOW_SIZE> samples;
+		size_t next, count;
+		uint64_t sum;
+	};
+
+	// Compteurs matériels cumulés depuis l'activation.
+	struct CounterTotals {
+		PerfCountersTeamH::Sample sum;
+		size_t calls;
+	};
+
+	std::array<Window, static_cast<size_t>(Phase::phaseCount)> mWindows;
+	std::array<CounterTotals, static_cast<size_t>(Phase::phaseCount)> mCounterTotals;
+	bool mEnabled, mCountersEnabled;
+};
+
+#ifdef GOLTEAMH_INSTRUMENTATION
+#define GOLTEAMH_TIME_PHASE(instrumentation, phase) \
+	InstrumentationTeamH::ScopedTimer phaseTimer{ (instrumentation), InstrumentationTeamH::Phase::phase }
+#else
+#define GOLTEAMH_TIME_PHASE(instrumentation, phase) ((void)0)
+#endif
+
+#endif // INSTRUMENTATIONTEAMH_H
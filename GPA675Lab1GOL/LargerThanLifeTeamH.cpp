@@ -0,0 +1,401 @@
+﻿#include "LargerThanLifeTeamH.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "TraceTeamH.h"
+
+LargerThanLifeTeamH::LargerThanLifeTeamH()
+	: mRadius{ 1 }, mIncludeCenter{}, mWidth{}, mHeight{}, mAliveCount{}
+	, mDeadColor{}, mAliveColor{}, mEngine(mRandomDevice())
+{
+	applyRule(*ParsingTeamH::parseRangeRule("B3/S23"));
+}
+
+//! \brief Accesseurs retournant des informations générales sur la
+//! simulation en cours.
+//!
+//! \details Voir GOLTeamH::statistics. La tendance est calculée sur les
+//! TendencyTeamH::WINDOW_SIZE dernières itérations.
+GOL::Statistics LargerThanLifeTeamH::statistics() const
+{
+	auto const cells{ size() };
+	auto const relative = [cells](size_t count) {
+		return cells ? static_cast<float>(count) / static_cast<float>(cells) : 0.0f;
+		};
+
+	return GOL::Statistics{
+		.rule = mRule,
+		.borderManagement = mBorderManagement,
+		.width = mWidth,
+		.height = mHeight,
+		.totalCells = cells,
+		.iteration = mIteration,
+		.totalDeadAbs = cells - mAliveCount,
+		.totalAliveAbs = mAliveCount,
+		.totalDeadRel = relative(cells - mAliveCount),
+		.totalAliveRel = relative(mAliveCount),
+		.tendencyAbs = static_cast<int>(std::lround(mTendency.slope())),
+		.tendencyRel = cells ? static_cast<float>(mTendency.slope() / static_cast<double>(cells)) : 0.0f
+	};
+}
+
+//! \brief Accesseurs retournant les informations sur la réalisation
+//! de l'implémentation.
+GOL::ImplementationInformation LargerThanLifeTeamH::information() const
+{
+	return ImplementationInformation{
+		.title{"Laboratoire 1 - Larger than Life"},
+		.authors{{{"Leclaire-Fournier"}, {"Timothée"}, {"timothee.leclaire-fournier.1@ens.etsmtl.ca"}},
+		{{"Euzenat"}, {"Martin"}, {"martin.euzenat.1@ens.etsmtl.ca"}}},
+		.answers{{"La grille est un tableau d'octets, une cellule par octet, sans bordure supplémentaire. \
+Le contour est la bande de R cellules dont le voisinage sort de la grille."},
+		{"Le nombre de voisins d'un voisinage de rayon R est obtenu par des sommes glissantes horizontales \
+puis verticales : deux additions et deux soustractions par cellule, peu importe R."},
+		{"Les couleurs sont encodées une fois par image ; l'état de la cellule sert d'indice."},
+		{"La règle est convertie en deux tables indexées par le nombre de voisins (naissance et survie)."}},
+		.optionnalComments{"Notation des règles : R5,C0,M1,S34..58,B34..45,NM (règle de Bosco) ou B###/S###."}
+	};
+}
+
+//! \brief Mutateur modifiant la taille de la grille de simulation.
+//!
+//! \details Le contenu de la grille est entièrement mis à l'état passé en
+//! argument, puis la bande du contour est appliquée.
+void LargerThanLifeTeamH::resize(size_t width, size_t height, State defaultState)
+{
+	if (width == 0 || height == 0)
+		width = height = 0;
+
+	mWidth = width;
+	mHeight = height;
+	mCells.assign(width * height, static_cast<uint8_t>(defaultState));
+	mNext.assign(width * height, 0);
+	buildMaps();
+	applyBorder();
+	restart();
+}
+
+//! \brief Mutateur modifiant la règle de la simulation.
+//!
+//! \details Accepte la notation de Golly (voir
+//! ParsingTeamH::parseRangeRule) et « B###/S### ». Un changement de rayon
+//! change aussi la largeur de la bande du contour.
+bool LargerThanLifeTeamH::setRule(std::string const& rule)
+{
+	auto const parsed{ ParsingTeamH::parseRangeRule(rule) };
+	if (!parsed)
+		return false;
+
+	mRule = rule;
+	applyRule(*parsed);
+	buildMaps();
+	applyBorder();
+	restart();
+	return true;
+}
+
+//! \brief Mutateur modifiant la stratégie de gestion de bord.
+//!
+//! \details Voir la description de la classe pour la bande du contour.
+void LargerThanLifeTeamH::setBorderManagement(BorderManagement borderManagement)
+{
+	mBorderManagement = borderManagement;
+	buildMaps();
+	applyBorder();
+	restart();
+}
+
+//! \brief Mutateur modifiant l'état d'une cellule de la grille (origine 0).
+void LargerThanLifeTeamH::setState(int x, int y, State state)
+{
+	mCells[static_cast<size_t>(y) * mWidth + static_cast<size_t>(x)] = static_cast<uint8_t>(state);
+	restart();
+}
+
+void LargerThanLifeTeamH::fill(State state)
+{
+	std::fill(mCells.begin(), mCells.end(), static_cast<uint8_t>(state));
+	applyBorder();
+	restart();
+}
+
+void LargerThanLifeTeamH::fillAlternately(State firstCell)
+{
+	auto const other{ firstCell == State::alive ? State::dead : State::alive };
+
+	for (size_t y{}; y < mHeight; ++y)
+		for (size_t x{}; x < mWidth; ++x)
+			mCells[y * mWidth + x] = static_cast<uint8_t>((x + y) % 2 ? other : firstCell);
+
+	applyBorder();
+	restart();
+}
+
+void LargerThanLifeTeamH::randomize(double percentAlive)
+{
+	std::uniform_real_distribution<> distribution(0.0, 1.0);
+	for (auto& cell : mCells)
+		cell = distribution(mEngine) < percentAlive;
+
+	applyBorder();
+	restart();
+}
+
+//! \brief Mutateur remplissant la grille par le patron passé en argument.
+//!
+//! \details La grille est vidée puis le patron est centré sur (centerX,
+//! centerY), comme dans GOLTeamH. Les cellules hors de la grille sont
+//! ignorées.
+bool LargerThanLifeTeamH::setFromPattern(std::string const& pattern, int centerX, int centerY)
+{
+	auto const parsed{ ParsingTeamH::parsePattern(pattern) };
+	if (!parsed)
+		return false;
+
+	std::fill(mCells.begin(), mCells.end(), uint8_t{});
+
+	auto const left{ static_cast<int64_t>(centerX) - static_cast<int64_t>((parsed->width + 1) / 2) };
+	auto const top{ static_cast<int64_t>(centerY) - static_cast<int64_t>((parsed->height + 1) / 2) };
+
+	for (size_t y{}; y < parsed->height; ++y) {
+		for (size_t x{}; x < parsed->width; ++x) {
+			auto const destX{ left + static_cast<int64_t>(x) }, destY{ top + static_cast<int64_t>(y) };
+			if (destX >= 0 && destY >= 0 && destX < static_cast<int64_t>(mWidth) && destY < static_cast<int64_t>(mHeight))
+				mCells[static_cast<size_t>(destY) * mWidth + static_cast<size_t>(destX)] = parsed->cells[y * parsed->width + x] != '0';
+		}
+	}
+
+	applyBorder();
+	restart();
+	return true;
+}
+
+//! \brief Surcharge centrant le patron dans la grille.
+bool LargerThanLifeTeamH::setFromPattern(std::string const& pattern)
+{
+	return setFromPattern(pattern, static_cast<int>(mWidth / 2), static_cast<int>(mHeight / 2));
+}
+
+void LargerThanLifeTeamH::setSolidColor(State state, Color const& color)
+{
+	if (state == State::alive)
+		mAliveColor = color;
+	else
+		mDeadColor = color;
+}
+
+//! \brief Fonction effectuant une itération de la simulation.
+//!
+//! \details Les rangées sont traitées de haut en bas. La somme verticale
+//! d'une colonne (mColumnSums) est celle des sommes horizontales des rangées
+//! y - R à y + R ; on passe à la rangée suivante en ajoutant la rangée
+//! y + R + 1 et en retirant la rangée y - R. Les rangées et colonnes hors de
+//! la grille sont lues à travers mRowMap et mColumnMap (warping ou mirror).
+void LargerThanLifeTeamH::processOneStep()
+{
+	GOLTEAMH_TRACE_SCOPE("LargerThanLifeTeamH::processOneStep");
+
+	auto const radius{ mRadius };
+	bool const all{ evolvesBorder() };
+
+	// Cellules qui évoluent : toutes, ou celles hors de la bande du contour.
+	auto const columnBegin{ all ? 0 : radius }, rowBegin{ all ? 0 : radius };
+	auto const columnEnd{ all ? mWidth : (mWidth > radius ? mWidth - radius : 0) };
+	auto const rowEnd{ all ? mHeight : (mHeight > radius ? mHeight - radius : 0) };
+
+	size_t aliveCount{};
+
+	if (columnBegin < columnEnd && rowBegin < rowEnd) {
+		auto const slots{ 2 * radius + 2 };
+		mRowSums.resize(slots * mWidth);
+		mColumnSums.assign(mWidth, 0);
+
+		// Rangée p (de rowBegin - R à rowEnd + R - 1) : sa rangée de la grille
+		// et l'emplacement de ses sommes horizontales.
+		auto const first{ static_cast<ptrdiff_t>(rowBegin) - static_cast<ptrdiff_t>(radius) };
+		auto gridRow = [&](ptrdiff_t p) { return mRowMap[static_cast<size_t>(p + static_cast<ptrdiff_t>(radius))]; };
+		auto sumsOf = [&](ptrdiff_t p) { return mRowSums.data() + static_cast<size_t>(p - first) % slots * mWidth; };
+
+		for (ptrdiff_t p{ first }; p <= first + static_cast<ptrdiff_t>(2 * radius); ++p) {
+			auto* sums{ sumsOf(p) };
+			horizontalSums(gridRow(p), sums, columnBegin, columnEnd);
+			for (size_t x{ columnBegin }; x < columnEnd; ++x)
+				mColumnSums[x] += sums[x];
+		}
+
+		for (size_t y{ rowBegin }; y < rowEnd; ++y) {
+			auto const* cells{ mCells.data() + y * mWidth };
+			auto* next{ mNext.data() + y * mWidth };
+
+			for (size_t x{ columnBegin }; x < columnEnd; ++x) {
+				auto const count{ mColumnSums[x] - (mIncludeCenter ? 0u : cells[x]) };
+				next[x] = cells[x] ? mSurvival[count] : mBirth[count];
+				aliveCount += next[x];
+			}
+
+			if (y + 1 < rowEnd) {
+				auto const entering{ static_cast<ptrdiff_t>(y + radius + 1) }, leaving{ static_cast<ptrdiff_t>(y) - static_cast<ptrdiff_t>(radius) };
+				auto* added{ sumsOf(entering) };
+				auto const* removed{ sumsOf(leaving) };
+
+				// L'emplacement de la rangée qui entre n'est pas celui de la
+				// rangée qui sort (2R + 2 emplacements).
+				horizontalSums(gridRow(entering), added, columnBegin, columnEnd);
+				for (size_t x{ columnBegin }; x < columnEnd; ++x)
+					mColumnSums[x] += static_cast<uint32_t>(added[x]) - removed[x];
+			}
+		}
+	}
+
+	// La bande du contour ne change pas : elle est recopiée.
+	if (!all) {
+		for (size_t y{}; y < mHeight; ++y) {
+			auto const* cells{ mCells.data() + y * mWidth };
+			auto* next{ mNext.data() + y * mWidth };
+			bool const band{ y < rowBegin || y >= rowEnd || columnBegin >= columnEnd };
+
+			auto copy = [&](size_t begin, size_t end) {
+				for (size_t x{ begin }; x < end; ++x) {
+					next[x] = cells[x];
+					aliveCount += cells[x];
+				}
+				};
+
+			if (band)
+				copy(0, mWidth);
+			else {
+				copy(0, columnBegin);
+				copy(columnEnd, mWidth);
+			}
+		}
+	}
+
+	mCells.swap(mNext);
+	mAliveCount = aliveCount;
+	mTendency.push(aliveCount);
+	mIteration = mIteration.value_or(0) + 1;
+}
+
+void LargerThanLifeTeamH::updateImage(uint32_t* buffer, size_t buffer_size) const
+{
+	if (buffer == nullptr)
+		return;
+
+	GOLTEAMH_TRACE_SCOPE("LargerThanLifeTeamH::updateImage");
+
+	auto const encode = [](Color const& color) {
+		return 0xFF000000u | static_cast<uint32_t>(color.red) << 16 | static_cast<uint32_t>(color.green) << 8 | color.blue;
+		};
+	uint32_t const colors[2]{ encode(mDeadColor), encode(mAliveColor) };
+
+	auto const pixels{ std::min(buffer_size, mCells.size()) };
+	for (size_t i{}; i < pixels; ++i)
+		buffer[i] = colors[mCells[i]];
+
+	std::fill(buffer + pixels, buffer + buffer_size, 0u);
+}
+
+bool LargerThanLifeTeamH::evolvesBorder() const
+{
+	auto const bm{ mBorderManagement.value_or(BorderManagement::immutableAsIs) };
+	return bm == BorderManagement::warping || bm == BorderManagement::mirror;
+}
+
+// Tables de naissance et de survie pour 0 à (2R + 1)^2 voisins.
+void LargerThanLifeTeamH::applyRule(ParsingTeamH::RangeRule const& rule)
+{
+	mRadius = rule.radius;
+	mIncludeCenter = rule.includeCenter;
+
+	auto const side{ 2 * mRadius + 1 };
+	auto const maxCount{ side * side };
+
+	auto table = [maxCount](std::vector<std::pair<unsigned, unsigned>> const& ranges) {
+		std::vector<uint8_t> values(maxCount + 1, 0);
+		for (auto [first, last] : ranges)
+			for (size_t n{ first }; n <= std::min<size_t>(last, maxCount); ++n)
+				values[n] = 1;
+		return values;
+		};
+
+	mBirth = table(rule.birth);
+	mSurvival = table(rule.survival);
+}
+
+// Correspondance des colonnes -R..W+R-1 et des rangées -R..H+R-1 vers la
+// grille. warping : côté opposé de la grille. mirror : réflexion autour de
+// la cellule du bord (-1 -> 1, W -> W - 2), répétée si R dépasse la grille.
+// Les autres stratégies ne lisent jamais hors de la grille.
+void LargerThanLifeTeamH::buildMaps()
+{
+	auto const bm{ mBorderManagement.value_or(BorderManagement::immutableAsIs) };
+
+	auto build = [this, bm](std::vector<uint32_t>& map, size_t size) {
+		auto const radius{ static_cast<ptrdiff_t>(mRadius) }, n{ static_cast<ptrdiff_t>(size) };
+		map.resize(size + 2 * mRadius);
+		if (size == 0)
+			return;
+
+		for (ptrdiff_t i{ -radius }; i < n + radius; ++i) {
+			ptrdiff_t value{};
+			if (bm == BorderManagement::mirror && n > 1) {
+				auto const period{ 2 * (n - 1) };
+				value = ((i % period) + period) % period;
+				if (value >= n)
+					value = period - value;
+			}
+			else if (bm == BorderManagement::warping || bm == BorderManagement::mirror)
+				value = ((i % n) + n) % n;
+			else
+				value = std::clamp<ptrdiff_t>(i, 0, n - 1);
+
+			map[static_cast<size_t>(i + radius)] = static_cast<uint32_t>(value);
+		}
+		};
+
+	build(mColumnMap, mWidth);
+	build(mRowMap, mHeight);
+}
+
+// foreverDead et foreverAlive : la bande du contour prend sa valeur.
+void LargerThanLifeTeamH::applyBorder()
+{
+	auto const bm{ mBorderManagement.value_or(BorderManagement::immutableAsIs) };
+	if (bm != BorderManagement::foreverDead && bm != BorderManagement::foreverAlive)
+		return;
+
+	uint8_t const value{ bm == BorderManagement::foreverAlive };
+	for (size_t y{}; y < mHeight; ++y)
+		for (size_t x{}; x < mWidth; ++x)
+			if (x < mRadius || y < mRadius || x + mRadius >= mWidth || y + mRadius >= mHeight)
+				mCells[y * mWidth + x] = value;
+}
+
+void LargerThanLifeTeamH::restart()
+{
+	mIteration = 0;
+	mAliveCount = static_cast<size_t>(std::count(mCells.begin(), mCells.end(), uint8_t{ 1 }));
+	mTendency.reset(mAliveCount);
+}
+
+// Sommes des cellules des colonnes x - R à x + R de la rangée `row`, pour x
+// de columnBegin à columnEnd - 1 : une fenêtre qui glisse d'une colonne.
+void LargerThanLifeTeamH::horizontalSums(size_t row, uint16_t* sums, size_t columnBegin, size_t columnEnd) const
+{
+	auto const* cells{ mCells.data() + row * mWidth };
+	auto const* map{ mColumnMap.data() };	// map[x + R] = colonne de x
+	auto const radius{ mRadius };
+
+	uint32_t sum{};
+	for (size_t i{ columnBegin }; i <= columnBegin + 2 * radius; ++i)
+		sum += cells[map[i]];
+	sums[columnBegin] = static_cast<uint16_t>(sum);
+
+	for (size_t x{ columnBegin + 1 }; x < columnEnd; ++x) {
+		sum += cells[map[x + 2 * radius]];
+		sum -= cells[map[x - 1]];
+		sums[x] = static_cast<uint16_t>(sum);
+	}
+}
@@ -0,0 +1,117 @@
+﻿#pragma once
+#ifndef LARGERTHANLIFETEAMH_H
+#define LARGERTHANLIFETEAMH_H
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <GOL.h>
+#include "ParsingTeamH.h"
+#include "TendencyTeamH.h"
+
+// Fichier : LargerThanLifeTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/19
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe LargerThanLifeTeamH
+//
+// Automate « Larger than Life » : voisinage de Moore de rayon R (jusqu'à
+// ParsingTeamH::MAX_RADIUS) et intervalles de naissance et de survie. La
+// règle suit la notation de Golly, par exemple la règle de Bosco :
+// « R5,C0,M1,S34..58,B34..45,NM ». Une règle « B###/S### » est aussi
+// acceptée (rayon 1).
+//
+// Le nombre de voisins vient de sommes glissantes séparables : pour chaque
+// rangée, la somme horizontale des 2R + 1 cellules centrées sur chaque
+// colonne, puis, par colonne, la somme de 2R + 1 de ces rangées. Chaque
+// somme avance d'une cellule par un ajout et un retrait : le coût par
+// cellule ne dépend pas de R (au lieu de (2R + 1)^2 lectures). Seules
+// 2R + 2 rangées de sommes horizontales sont conservées.
+//
+// Gestion de bord : le contour est la bande de R cellules dont le voisinage
+// sort de la grille (la bordure de GOLTeamH pour R = 1). En immutableAsIs,
+// foreverDead et foreverAlive, cette bande ne change jamais. En warping et
+// mirror, toutes les cellules évoluent ; les voisins hors de la grille sont
+// pris du côté opposé de la grille ou par réflexion autour du bord.
+//
+// Contrairement à GOLTeamH, les coordonnées commencent à 0.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class LargerThanLifeTeamH : public GOL
+{
+public:
+	LargerThanLifeTeamH();
+	LargerThanLifeTeamH(LargerThanLifeTeamH const&) = delete;
+	LargerThanLifeTeamH(LargerThanLifeTeamH&&) = delete;
+	LargerThanLifeTeamH& operator =(LargerThanLifeTeamH const&) = delete;
+	LargerThanLifeTeamH& operator =(LargerThanLifeTeamH&&) = delete;
+
+	virtual ~LargerThanLifeTeamH() = default;
+
+	// inline puisque trivial.
+	size_t width() const override { return mWidth; }
+	size_t height() const override { return mHeight; }
+	size_t size() const override { return mWidth * mHeight; }
+	State state(int x, int y) const override { return static_cast<State>(mCells[static_cast<size_t>(y) * mWidth + static_cast<size_t>(x)]); }
+	std::string rule() const override { return mRule.value_or(std::string()); }
+	BorderManagement borderManagement() const override { return mBorderManagement.value_or(GOL::BorderManagement::immutableAsIs); }
+	Color color(State state) const override { return state == GOL::State::alive ? mAliveColor : mDeadColor; }
+
+	Statistics statistics() const override;
+	ImplementationInformation information() const override;
+
+	void resize(size_t width, size_t height, State defaultState) override;
+	bool setRule(std::string const& rule) override;
+	void setBorderManagement(BorderManagement borderManagement) override;
+	void setState(int x, int y, State state) override;
+	void fill(State state) override;
+	void fillAlternately(State firstCell) override;
+	void randomize(double percentAlive) override;
+	bool setFromPattern(std::string const& pattern, int centerX, int centerY) override;
+	bool setFromPattern(std::string const& pattern) override;
+	void setSolidColor(State state, Color const& color) override;
+	void processOneStep() override;
+	void updateImage(uint32_t* buffer, size_t buffer_size) const override;
+
+	size_t radius() const { return mRadius; }
+
+private:
+	std::optional<std::string> mRule;
+	std::optional<BorderManagement> mBorderManagement;
+	std::optional<IterationType> mIteration;
+
+	size_t mRadius;
+	bool mIncludeCenter;
+	// Indexés par le nombre de voisins vivants : 1 si la cellule naît
+	// (mBirth) ou survit (mSurvival).
+	std::vector<uint8_t> mBirth, mSurvival;
+
+	size_t mWidth, mHeight, mAliveCount;
+	std::vector<uint8_t> mCells, mNext;
+
+	// Sommes glissantes (voir processOneStep).
+	std::vector<uint16_t> mRowSums;		// 2R + 2 rangées de sommes horizontales
+	std::vector<uint32_t> mColumnSums;	// Nombre de voisins de la rangée courante
+	std::vector<uint32_t> mColumnMap;	// Colonne -R..W+R-1 -> colonne de la grille
+	std::vector<uint32_t> mRowMap;		// Rangée -R..H+R-1 -> rangée de la grille
+
+	TendencyTeamH mTendency;
+	Color mDeadColor, mAliveColor;
+
+	std::random_device mRandomDevice;
+	std::mt19937 mEngine;
+
+	bool evolvesBorder() const;
+	void applyRule(ParsingTeamH::RangeRule const& rule);
+	void buildMaps();
+	void applyBorder();
+	void restart();
+	void horizontalSums(size_t row, uint16_t* sums, size_t columnBegin, size_t columnEnd) const;
+};
+
+#endif // LARGERTHANLIFETEAMH_H
@@ -0,0 +1,235 @@
+﻿#include "MappedFileTeamH.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	size_t pageSize()
+	{
+#if defined(_WIN32)
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return info.dwPageSize;
+#else
+		return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+	}
+}
+
+#if defined(_WIN32)
+
+MappedFileTeamH::MappedFileTeamH()
+	: mData{}, mSize{}, mFile{ INVALID_HANDLE_VALUE }, mMapping{}
+{
+}
+
+bool MappedFileTeamH::open(std::string const& path, size_t size)
+{
+	close();
+	if (size == 0)
+		return false;
+
+	mFile = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+		FILE_ATTRIBUTE_TEMPORARY, nullptr);
+	if (mFile == INVALID_HANDLE_VALUE)
+		return false;
+	mPath = path;
+
+	LARGE_INTEGER end;
+	end.QuadPart = static_cast<LONGLONG>(size);
+	mMapping = SetFilePointerEx(mFile, end, nullptr, FILE_BEGIN) && SetEndOfFile(mFile)
+		? CreateFileMappingA(mFile, nullptr, PAGE_READWRITE, static_cast<DWORD>(uint64_t{ size } >> 32),
+			static_cast<DWORD>(size & 0xFFFFFFFFu), nullptr)
+		: nullptr;
+	if (mMapping)
+		mData = static_cast<uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+
+	if (!mData) {
+		close();
+		return false;
+	}
+
+	mSize = size;
+	return true;
+}
+
+void MappedFileTeamH::close()
+{
+	if (mData)
+		UnmapViewOfFile(mData);
+	if (mMapping)
+		CloseHandle(mMapping);
+	if (mFile != INVALID_HANDLE_VALUE)
+		CloseHandle(mFile);
+	if (!mPath.empty())
+		DeleteFileA(mPath.c_str());
+
+	mData = nullptr;
+	mMapping = nullptr;
+	mFile = INVALID_HANDLE_VALUE;
+	mSize = 0;
+	mPath.clear();
+}
+
+void MappedFileTeamH::willNeed(size_t offset, size_t length) const
+{
+	size_t first, last;
+	if (!pages(offset, length, first, last))
+		return;
+
+	WIN32_MEMORY_RANGE_ENTRY entry{ mData + first, last - first };
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+}
+
+void MappedFileTeamH::flushAsync(size_t offset, size_t length) const
+{
+	size_t first, last;
+	if (pages(offset, length, first, last))
+		FlushViewOfFile(mData + first, last - first);
+}
+
+void MappedFileTeamH::release(size_t offset, size_t length) const
+{
+	// VirtualUnlock d'une plage non verrouillée la retire de l'ensemble de
+	// travail du processus.
+	size_t first, last;
+	if (pages(offset, length, first, last))
+		VirtualUnlock(mData + first, last - first);
+}
+
+void MappedFileTeamH::zero(size_t offset, size_t length)
+{
+	memset(mData + offset, 0, length);
+}
+
+#else
+
+MappedFileTeamH::MappedFileTeamH()
+	: mData{}, mSize{}, mFile{ -1 }
+{
+}
+
+bool MappedFileTeamH::open(std::string const& path, size_t size)
+{
+	close();
+	if (size == 0)
+		return false;
+
+	mFile = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (mFile < 0)
+		return false;
+	mPath = path;
+
+	if (ftruncate(mFile, static_cast<off_t>(size)) != 0) {
+		close();
+		return false;
+	}
+
+#ifdef __linux__
+	// On réserve l'espace disque maintenant : un disque plein ferait sinon
+	// échouer une écriture dans la projection (SIGBUS). Certains systèmes de
+	// fichiers ne le permettent pas ; le fichier reste alors creux.
+	if (fallocate(mFile, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) != 0 && errno == ENOSPC) {
+		close();
+		return false;
+	}
+#endif
+
+	auto* data{ mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, mFile, 0) };
+	if (data == MAP_FAILED) {
+		close();
+		return false;
+	}
+
+	mData = static_cast<uint8_t*>(data);
+	mSize = size;
+	return true;
+}
+
+void MappedFileTeamH::close()
+{
+	if (mData)
+		munmap(mData, mSize);
+	if (mFile >= 0)
+		::close(mFile);
+	if (!mPath.empty())
+		unlink(mPath.c_str());
+
+	mData = nullptr;
+	mFile = -1;
+	mSize = 0;
+	mPath.clear();
+}
+
+void MappedFileTeamH::willNeed(size_t offset, size_t length) const
+{
+	size_t first, last;
+	if (pages(offset, length, first, last))
+		madvise(mData + first, last - first, MADV_WILLNEED);
+}
+
+void MappedFileTeamH::flushAsync(size_t offset, size_t length) const
+{
+	size_t first, last;
+	if (!pages(offset, length, first, last))
+		return;
+
+#ifdef __linux__
+	// Démarre l'écriture des pages modifiées sans attendre la fin.
+	sync_file_range(mFile, static_cast<off_t>(first), static_cast<off_t>(last - first), SYNC_FILE_RANGE_WRITE);
+#else
+	msync(mData + first, last - first, MS_ASYNC);
+#endif
+}
+
+void MappedFileTeamH::release(size_t offset, size_t length) const
+{
+	// Projection partagée : les pages modifiées restent dans le cache du
+	// fichier, seule la projection du processus est retirée.
+	size_t first, last;
+	if (pages(offset, length, first, last))
+		madvise(mData + first, last - first, MADV_DONTNEED);
+}
+
+void MappedFileTeamH::zero(size_t offset, size_t length)
+{
+#ifdef __linux__
+	// Plage remise à zéro par le système de fichiers, sans l'écrire ; la
+	// projection voit le résultat par le cache du fichier.
+	if (fallocate(mFile, FALLOC_FL_ZERO_RANGE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset), static_cast<off_t>(length)) == 0)
+		return;
+#endif
+	memset(mData + offset, 0, length);
+}
+
+#endif
+
+MappedFileTeamH::~MappedFileTeamH()
+{
+	close();
+}
+
+bool MappedFileTeamH::pages(size_t offset, size_t length, size_t& first, size_t& last) const
+{
+	static size_t const page{ pageSize() };
+
+	if (!mData || offset >= mSize)
+		return false;
+
+	auto const end{ offset + length < mSize ? offset + length : mSize };
+	first = (offset + page - 1) / page * page;
+	// La dernière page partielle du fichier est comprise si la plage va
+	// jusqu'à la fin.
+	last = end == mSize ? (end + page - 1) / page * page : end / page * page;
+	return last > first;
+}
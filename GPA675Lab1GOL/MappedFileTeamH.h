@@ -0,0 +1,70 @@
+﻿#pragma once
+#ifndef MAPPEDFILETEAMH_H
+#define MAPPEDFILETEAMH_H
+
+#include <cstdint>
+#include <string>
+
+// Fichier : MappedFileTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/28
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe MappedFileTeamH
+//
+// Fichier temporaire projeté en mémoire (mmap sous Linux, MapViewOfFile
+// sous Windows), en lecture et écriture. Le fichier est créé vide (creux :
+// rempli de zéros sans occuper le disque) et supprimé par close().
+//
+// Le système charge et écrit les pages à la demande ; les trois indications
+// suivantes permettent de parcourir un fichier plus grand que la mémoire
+// par bandes :
+// - willNeed : lecture anticipée d'une plage, en arrière-plan ;
+// - flushAsync : démarre l'écriture d'une plage sans l'attendre ;
+// - release : retire une plage de la mémoire du processus (les données
+//   restent dans le fichier).
+// Les plages sont arrondies aux pages comprises dans la plage.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class MappedFileTeamH
+{
+public:
+	MappedFileTeamH();
+	MappedFileTeamH(MappedFileTeamH const&) = delete;
+	MappedFileTeamH& operator=(MappedFileTeamH const&) = delete;
+	~MappedFileTeamH();
+
+	// Crée (ou écrase) le fichier `path` de `size` octets nuls et le
+	// projette. Retourne false en cas d'échec (disque plein, espace
+	// d'adressage insuffisant...).
+	bool open(std::string const& path, size_t size);
+	void close();
+
+	bool isOpen() const { return mData != nullptr; }
+	uint8_t* data() { return mData; }
+	const uint8_t* data() const { return mData; }
+	size_t size() const { return mSize; }
+
+	void willNeed(size_t offset, size_t length) const;
+	void flushAsync(size_t offset, size_t length) const;
+	void release(size_t offset, size_t length) const;
+	// Remet la plage à zéro, en libérant l'espace disque si possible.
+	void zero(size_t offset, size_t length);
+
+private:
+	std::string mPath;
+	uint8_t* mData;
+	size_t mSize;
+#ifdef _WIN32
+	void* mFile;
+	void* mMapping;
+#else
+	int mFile;
+#endif
+
+	// Plage [first, last) des pages entières comprises dans la plage.
+	bool pages(size_t offset, size_t length, size_t& first, size_t& last) const;
+};
+
+#endif // MAPPEDFILETEAMH_H
@@ -0,0 +1,114 @@
+﻿#pragma once
+#ifndef NEIGHBORHOODTEAMH_H
+#define NEIGHBORHOODTEAMH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Fichier : NeighborhoodTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/20
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Politiques de voisinage NeighborhoodTeamH
+//
+// Un voisinage est un sous-ensemble des 8 voisins de Moore, décrit par un
+// masque de 8 bits. Les voisins sont numérotés rangée par rangée :
+//
+//     0 1 2
+//     3 . 4
+//     5 6 7
+//
+// - Moore : les 8 voisins (0xFF) ;
+// - von Neumann : les 4 voisins orthogonaux (0x5A) ;
+// - hexagonal : grille hexagonale inclinée, comme dans Golly ; le voisin en
+//   haut à droite et celui en bas à gauche sont exclus (0xDB).
+// Tout autre masque est un voisinage personnalisé.
+//
+// Policy<Mask> fixe le masque à la compilation : count() ne lit que les
+// voisins du masque, sans boucle ni test, et le noyau qui l'utilise est
+// compilé (et vectorisé) séparément pour ce masque. Les trois voisinages
+// nommés ont leur Policy ; un autre masque passe par Custom, qui lit les 8
+// voisins et les pondère par 0 ou 1 (toujours sans branche). Pour compiler
+// un noyau dédié à un masque fréquent, il suffit de l'ajouter à dispatch().
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+namespace NeighborhoodTeamH
+{
+	using Mask = uint8_t;
+
+	constexpr Mask MOORE{ 0xFF };
+	constexpr Mask VON_NEUMANN{ 0x5A };
+	constexpr Mask HEXAGONAL{ 0xDB };
+
+	// Déplacement de chaque voisin par rapport à la cellule.
+	constexpr int DX[8]{ -1, 0, 1, -1, 1, -1, 0, 1 };
+	constexpr int DY[8]{ -1, -1, -1, 0, 0, 1, 1, 1 };
+
+	constexpr bool contains(Mask mask, size_t neighbor) { return (mask >> neighbor) & 1; }
+
+	template <Mask M>
+	struct Policy
+	{
+		static constexpr Mask mask{ M };
+
+		// Nombre de voisins vivants de la cellule `column`. `above`, `middle`
+		// et `below` pointent sur la colonne 0 des trois rangées qui entourent
+		// la cellule ; la cellule elle-même est middle[column + 1].
+		static unsigned count(const uint8_t* above, const uint8_t* middle, const uint8_t* below, size_t column)
+		{
+			unsigned n{};
+			if constexpr (contains(M, 0)) n += above[column];
+			if constexpr (contains(M, 1)) n += above[column + 1];
+			if constexpr (contains(M, 2)) n += above[column + 2];
+			if constexpr (contains(M, 3)) n += middle[column];
+			if constexpr (contains(M, 4)) n += middle[column + 2];
+			if constexpr (contains(M, 5)) n += below[column];
+			if constexpr (contains(M, 6)) n += below[column + 1];
+			if constexpr (contains(M, 7)) n += below[column + 2];
+			return n;
+		}
+	};
+
+	using Moore = Policy<MOORE>;
+	using VonNeumann = Policy<VON_NEUMANN>;
+	using Hexagonal = Policy<HEXAGONAL>;
+
+	// Masque connu seulement à l'exécution.
+	struct Custom
+	{
+		uint8_t weights[8];
+
+		explicit Custom(Mask mask)
+		{
+			for (size_t neighbor{}; neighbor < 8; ++neighbor)
+				weights[neighbor] = contains(mask, neighbor);
+		}
+
+		unsigned count(const uint8_t* above, const uint8_t* middle, const uint8_t* below, size_t column) const
+		{
+			return weights[0] * above[column] + weights[1] * above[column + 1] + weights[2] * above[column + 2] +
+				weights[3] * middle[column] + weights[4] * middle[column + 2] +
+				weights[5] * below[column] + weights[6] * below[column + 1] + weights[7] * below[column + 2];
+		}
+	};
+
+	// Appelle function(policy) avec la politique du masque.
+	template <typename Function>
+	decltype(auto) dispatch(Mask mask, Function&& function)
+	{
+		switch (mask) {
+		case MOORE:
+			return function(Moore{});
+		case VON_NEUMANN:
+			return function(VonNeumann{});
+		case HEXAGONAL:
+			return function(Hexagonal{});
+		default:
+			return function(Custom{ mask });
+		}
+	}
+}
+
+#endif // NEIGHBORHOODTEAMH_H
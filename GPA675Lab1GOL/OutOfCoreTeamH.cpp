@@ -0,0 +1,450 @@
+﻿#include "OutOfCoreTeamH.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <filesystem>
+#include <system_error>
+
+#include "BitKernelTeamH.h"
+#include "ParsingTeamH.h"
+#include "TraceTeamH.h"
+
+OutOfCoreTeamH::OutOfCoreTeamH(std::string directory)
+	: mDirectory{ std::move(directory) }, mParsedRule{ *ParsingTeamH::parseRule("B3/S23") }
+	, mWidth{}, mHeight{}, mWordsPerRow{}, mAliveCount{}, mBandRows{}, mCurrent{}
+	, mDeadColor{}, mAliveColor{}, mEngine(mRandomDevice())
+{
+	if (mDirectory.empty()) {
+		std::error_code error;
+		mDirectory = std::filesystem::temp_directory_path(error).string();
+	}
+}
+
+//! \brief Accesseurs retournant des informations générales sur la
+//! simulation en cours.
+//!
+//! \details Voir GOLTeamH::statistics.
+GOL::Statistics OutOfCoreTeamH::statistics() const
+{
+	auto const cells{ size() };
+	auto const relative = [cells](size_t count) {
+		return cells ? static_cast<float>(count) / static_cast<float>(cells) : 0.0f;
+		};
+
+	return GOL::Statistics{
+		.rule = mRule,
+		.borderManagement = mBorderManagement,
+		.width = mWidth,
+		.height = mHeight,
+		.totalCells = cells,
+		.iteration = mIteration,
+		.totalDeadAbs = cells - mAliveCount,
+		.totalAliveAbs = mAliveCount,
+		.totalDeadRel = relative(cells - mAliveCount),
+		.totalAliveRel = relative(mAliveCount),
+		.tendencyAbs = static_cast<int>(std::lround(mTendency.slope())),
+		.tendencyRel = cells ? static_cast<float>(mTendency.slope() / static_cast<double>(cells)) : 0.0f
+	};
+}
+
+//! \brief Accesseurs retournant les informations sur la réalisation
+//! de l'implémentation.
+GOL::ImplementationInformation OutOfCoreTeamH::information() const
+{
+	return ImplementationInformation{
+		.title{"Laboratoire 1 - Grille hors mémoire"},
+		.authors{{{"Leclaire-Fournier"}, {"Timothée"}, {"timothee.leclaire-fournier.1@ens.etsmtl.ca"}},
+		{{"Euzenat"}, {"Martin"}, {"martin.euzenat.1@ens.etsmtl.ca"}}},
+		.answers{{"Deux fichiers projetés en mémoire, une cellule par bit, une rangée par suite de mots \
+de 64 bits. Seules quelques bandes de rangées sont en mémoire à la fois."},
+		{"Les voisins de 64 cellules sont additionnés en tranches de bits, bande par bande ; la bande \
+suivante est lue à l'avance et la bande calculée est écrite sans attendre."},
+		{"Les couleurs sont encodées une fois par image ; le bit de la cellule sert d'indice."},
+		{"La règle est appliquée aux plans du compte des voisins (voir BitKernelTeamH)."}},
+		.optionnalComments{"Fichiers dans " + mDirectory + " ; le débit du disque limite la vitesse."}
+	};
+}
+
+//! \brief Mutateur modifiant la taille de la grille de simulation.
+//!
+//! \details Recrée les deux fichiers. La grille est vide (0 x 0) si la
+//! taille est inférieure à 3 x 3 ou si les fichiers ne peuvent être créés.
+void OutOfCoreTeamH::resize(size_t width, size_t height, State defaultState)
+{
+	GOLTEAMH_TRACE_SCOPE("OutOfCoreTeamH::resize");
+
+	for (auto& file : mFiles)
+		file.close();
+	mWidth = mHeight = mWordsPerRow = mAliveCount = 0;
+	mCurrent = 0;
+
+	if (width >= 3 && height >= 3) {
+		auto const wordsPerRow{ (width + 63) / 64 };
+
+		// Noms propres à cette instance : plusieurs moteurs peuvent partager
+		// le répertoire.
+		auto const id{ std::to_string(mEngine()) };
+		bool opened{ true };
+		for (size_t i{}; i < mFiles.size() && opened; ++i) {
+			auto const path{ std::filesystem::path(mDirectory) / ("OutOfCoreTeamH-" + id + "-" + std::to_string(i) + ".bin") };
+			opened = mFiles[i].open(path.string(), wordsPerRow * sizeof(Word) * height);
+		}
+
+		if (opened) {
+			mWidth = width;
+			mHeight = height;
+			mWordsPerRow = wordsPerRow;
+		}
+		else {
+			for (auto& file : mFiles)
+				file.close();
+		}
+	}
+
+	// Les fichiers sont créés remplis de zéros.
+	if (mWidth && defaultState == State::alive)
+		fill(defaultState);
+	else {
+		applyBorder();
+		restart();
+	}
+}
+
+//! \brief Mutateur modifiant la règle de la simulation.
+//!
+//! \details « B###/S### », voisinage de Moore seulement.
+bool OutOfCoreTeamH::setRule(std::string const& rule)
+{
+	auto const parsed{ ParsingTeamH::parseRule(rule) };
+	if (!parsed || ParsingTeamH::parseNeighborhood(rule) != NeighborhoodTeamH::MOORE)
+		return false;
+
+	mRule = rule;
+	mParsedRule = *parsed;
+	restart();
+	return true;
+}
+
+void OutOfCoreTeamH::setBorderManagement(BorderManagement borderManagement)
+{
+	mBorderManagement = borderManagement;
+	applyBorder();
+	restart();
+}
+
+//! \brief Mutateur modifiant l'état d'une cellule de la grille (origine 0).
+void OutOfCoreTeamH::setState(int x, int y, State state)
+{
+	setBit(row(mCurrent, static_cast<size_t>(y)), static_cast<size_t>(x), state == State::alive);
+	restart();
+}
+
+//! \brief Mutateur remplissant la grille de l'état passé en argument.
+//!
+//! \details Une grille morte est remise à zéro par le système de fichiers,
+//! sans parcourir les rangées.
+void OutOfCoreTeamH::fill(State state)
+{
+	if (state == State::alive)
+		fillRows([this](size_t, Word* words) { std::fill_n(words, mWordsPerRow, ~Word{}); });
+	else if (isOpen()) {
+		mFiles[mCurrent].zero(0, mFiles[mCurrent].size());
+		mAliveCount = 0;
+	}
+
+	applyBorder();
+	restart();
+}
+
+void OutOfCoreTeamH::fillAlternately(State firstCell)
+{
+	// Bits pairs : colonnes paires.
+	constexpr Word EVEN{ 0x5555555555555555ull };
+	auto const first{ firstCell == State::alive ? EVEN : ~EVEN };
+
+	fillRows([this, first](size_t y, Word* words) { std::fill_n(words, mWordsPerRow, y % 2 ? ~first : first); });
+	applyBorder();
+	restart();
+}
+
+void OutOfCoreTeamH::randomize(double percentAlive)
+{
+	std::uniform_real_distribution<> distribution(0.0, 1.0);
+	fillRows([this, &distribution, percentAlive](size_t, Word* words) {
+		for (size_t k{}; k < mWordsPerRow; ++k) {
+			Word word{};
+			for (size_t i{}; i < 64; ++i)
+				word |= Word{ distribution(mEngine) < percentAlive } << i;
+			words[k] = word;
+		}
+		});
+
+	applyBorder();
+	restart();
+}
+
+//! \brief Mutateur remplissant la grille par le patron passé en argument.
+//!
+//! \details Comme LargerThanLifeTeamH::setFromPattern : la grille est vidée
+//! puis le patron est centré sur (centerX, centerY).
+bool OutOfCoreTeamH::setFromPattern(std::string const& pattern, int centerX, int centerY)
+{
+	auto const parsed{ ParsingTeamH::parsePattern(pattern) };
+	if (!parsed)
+		return false;
+
+	fill(State::dead);
+
+	auto const left{ static_cast<int64_t>(centerX) - static_cast<int64_t>((parsed->width + 1) / 2) };
+	auto const top{ static_cast<int64_t>(centerY) - static_cast<int64_t>((parsed->height + 1) / 2) };
+
+	for (size_t y{}; y < parsed->height; ++y) {
+		for (size_t x{}; x < parsed->width; ++x) {
+			auto const destX{ left + static_cast<int64_t>(x) }, destY{ top + static_cast<int64_t>(y) };
+			if (destX >= 0 && destY >= 0 && destX < static_cast<int64_t>(mWidth) && destY < static_cast<int64_t>(mHeight))
+				setBit(row(mCurrent, static_cast<size_t>(destY)), static_cast<size_t>(destX), parsed->cells[y * parsed->width + x] != '0');
+		}
+	}
+
+	applyBorder();
+	restart();
+	return true;
+}
+
+//! \brief Surcharge centrant le patron dans la grille.
+bool OutOfCoreTeamH::setFromPattern(std::string const& pattern)
+{
+	return setFromPattern(pattern, static_cast<int>(mWidth / 2), static_cast<int>(mHeight / 2));
+}
+
+void OutOfCoreTeamH::setSolidColor(State state, Color const& color)
+{
+	if (state == State::alive)
+		mAliveColor = color;
+	else
+		mDeadColor = color;
+}
+
+//! \brief Fonction effectuant une itération de la simulation.
+//!
+//! \details La grille est parcourue par bandes de bandRows() rangées. Pour
+//! chaque bande : lecture anticipée de la bande suivante de la génération
+//! courante, calcul des rangées (evolveRow), puis écriture différée de la
+//! bande calculée et retrait de la bande précédente. En immutableAsIs,
+//! foreverDead et foreverAlive, les rangées 0 et H - 1 sont recopiées.
+void OutOfCoreTeamH::processOneStep()
+{
+	if (!isOpen())
+		return;
+
+	GOLTEAMH_TRACE_SCOPE("OutOfCoreTeamH::processOneStep");
+
+	auto& current{ mFiles[mCurrent] };
+	auto& next{ mFiles[1 - mCurrent] };
+	bool const all{ evolvesBorder() };
+	auto const band{ bandRows() };
+
+	size_t aliveCount{};
+	for (size_t begin{}; begin < mHeight; begin += band) {
+		auto const end{ std::min(begin + band, mHeight) };
+		// La bande suivante et la rangée qui la suit (voisine du bas).
+		current.willNeed(end * rowBytes(), bytes(end, std::min(end + band + 1, mHeight)));
+
+		for (auto y{ begin }; y < end; ++y) {
+			auto* n{ row(1 - mCurrent, y) };
+			if (!all && (y == 0 || y + 1 == mHeight)) {
+				auto const* r{ row(mCurrent, y) };
+				std::copy_n(r, mWordsPerRow, n);
+				for (size_t k{}; k < mWordsPerRow; ++k)
+					aliveCount += static_cast<size_t>(std::popcount(r[k]));
+			}
+			else
+				aliveCount += evolveRow(y, n);
+		}
+
+		next.flushAsync(begin * rowBytes(), bytes(begin, end));
+		next.release(begin * rowBytes(), bytes(begin, end));
+		// La bande précédente n'est plus voisine d'aucune rangée à calculer
+		// (sauf la rangée 0 en warping et mirror, relue au besoin).
+		if (begin >= band)
+			current.release((begin - band) * rowBytes(), bytes(begin - band, begin));
+	}
+	current.release(0, current.size());
+
+	mCurrent = 1 - mCurrent;
+	mAliveCount = aliveCount;
+	mTendency.push(aliveCount);
+	mIteration = mIteration.value_or(0) + 1;
+}
+
+//! \brief Fonction dessinant la grille (une cellule par pixel, rangée par
+//! rangée).
+void OutOfCoreTeamH::updateImage(uint32_t* buffer, size_t buffer_size) const
+{
+	if (buffer == nullptr)
+		return;
+
+	GOLTEAMH_TRACE_SCOPE("OutOfCoreTeamH::updateImage");
+
+	auto const encode = [](Color const& color) {
+		return 0xFF000000u | static_cast<uint32_t>(color.red) << 16 | static_cast<uint32_t>(color.green) << 8 | color.blue;
+		};
+	uint32_t const colors[2]{ encode(mDeadColor), encode(mAliveColor) };
+
+	auto const pixels{ std::min(buffer_size, size()) };
+	for (size_t y{}; y * mWidth < pixels; ++y) {
+		auto const* r{ row(mCurrent, y) };
+		auto const count{ std::min(mWidth, pixels - y * mWidth) };
+		for (size_t x{}; x < count; ++x)
+			buffer[y * mWidth + x] = colors[bit(r, x)];
+	}
+
+	std::fill(buffer + pixels, buffer + buffer_size, 0u);
+}
+
+size_t OutOfCoreTeamH::bandRows() const
+{
+	if (mBandRows)
+		return mBandRows;
+
+	return rowBytes() ? std::max<size_t>(DEFAULT_BAND_BYTES / rowBytes(), 1) : 1;
+}
+
+void OutOfCoreTeamH::setBit(Word* row, size_t x, bool alive)
+{
+	auto& word{ row[x / 64] };
+	auto const mask{ Word{ 1 } << (x % 64) };
+	if (((word & mask) != 0) == alive)
+		return;
+
+	word ^= mask;
+	if (alive)
+		++mAliveCount;
+	else
+		--mAliveCount;
+}
+
+template <typename Function>
+void OutOfCoreTeamH::fillRows(Function function)
+{
+	if (!isOpen())
+		return;
+
+	auto& file{ mFiles[mCurrent] };
+	auto const band{ bandRows() };
+	auto const mask{ lastMask() };
+
+	mAliveCount = 0;
+	for (size_t begin{}; begin < mHeight; begin += band) {
+		auto const end{ std::min(begin + band, mHeight) };
+		for (auto y{ begin }; y < end; ++y) {
+			auto* words{ row(mCurrent, y) };
+			function(y, words);
+			words[mWordsPerRow - 1] &= mask;
+			for (size_t k{}; k < mWordsPerRow; ++k)
+				mAliveCount += static_cast<size_t>(std::popcount(words[k]));
+		}
+
+		file.flushAsync(begin * rowBytes(), bytes(begin, end));
+		file.release(begin * rowBytes(), bytes(begin, end));
+	}
+}
+
+// Les cellules hors de la grille voisines de la rangée sont des « fantômes »
+// : celle de gauche entre par le bit 63 du mot ouest du premier mot, celle de
+// droite par le premier bit de remplissage du dernier mot (ou par le bit 0 du
+// mot est si la largeur est un multiple de 64). Les bits de remplissage sont
+// nuls dans les fichiers.
+size_t OutOfCoreTeamH::evolveRow(size_t y, Word* next) const
+{
+	bool const all{ evolvesBorder() };
+	bool const mirror{ borderManagement() == BorderManagement::mirror };
+	auto const last{ mWordsPerRow - 1 };
+	auto const tail{ mWidth % 64 };
+	auto const rule{ mParsedRule };
+
+	auto const above{ y > 0 ? y - 1 : (mirror ? 1 : mHeight - 1) };
+	auto const below{ y + 1 < mHeight ? y + 1 : (mirror ? mHeight - 2 : 0) };
+	const Word* rows[3]{ row(mCurrent, above), row(mCurrent, y), row(mCurrent, below) };
+
+	// Cellules fantômes : colonne opposée en warping, colonne 1 (resp.
+	// W - 2) en mirror ; sans effet dans les autres modes (colonnes fixes).
+	Word westGhost[3], eastGhost[3];
+	for (size_t i{}; i < 3; ++i) {
+		westGhost[i] = all ? bit(rows[i], mirror ? 1 : mWidth - 1) : 0;
+		eastGhost[i] = all ? bit(rows[i], mirror ? mWidth - 2 : 0) : 0;
+	}
+
+	auto const word = [&](size_t i, size_t k) {
+		return k == last && tail ? rows[i][k] | (eastGhost[i] << tail) : rows[i][k];
+		};
+	auto const west = [&](size_t i, size_t k) { return k > 0 ? rows[i][k - 1] : westGhost[i] << 63; };
+	auto const east = [&](size_t i, size_t k) { return k < last ? word(i, k + 1) : (tail ? 0 : eastGhost[i]); };
+	auto const edge = [&](size_t k) {
+		return BitKernelTeamH::evolve(word(0, k), word(1, k), word(2, k),
+			west(0, k), west(1, k), west(2, k), east(0, k), east(1, k), east(2, k), rule);
+		};
+
+	auto const* a{ rows[0] };
+	auto const* r{ rows[1] };
+	auto const* b{ rows[2] };
+
+	next[0] = edge(0);
+	for (size_t k{ 1 }; k + 1 < mWordsPerRow; ++k)
+		next[k] = BitKernelTeamH::evolve(a[k], r[k], b[k], a[k - 1], r[k - 1], b[k - 1], a[k + 1], r[k + 1], b[k + 1], rule);
+	if (last > 0)
+		next[last] = edge(last);
+	next[last] &= lastMask();
+
+	if (!all) {
+		// Colonnes 0 et W - 1 : inchangées.
+		auto const lastBit{ Word{ 1 } << ((mWidth - 1) % 64) };
+		next[0] = (next[0] & ~Word{ 1 }) | (r[0] & Word{ 1 });
+		next[last] = (next[last] & ~lastBit) | (r[last] & lastBit);
+	}
+
+	size_t aliveCount{};
+	for (size_t k{}; k < mWordsPerRow; ++k)
+		aliveCount += static_cast<size_t>(std::popcount(next[k]));
+	return aliveCount;
+}
+
+bool OutOfCoreTeamH::evolvesBorder() const
+{
+	auto const bm{ borderManagement() };
+	return bm == BorderManagement::warping || bm == BorderManagement::mirror;
+}
+
+// foreverDead et foreverAlive : le contour prend sa valeur. Les rangées
+// intermédiaires ne sont touchées qu'à leurs premier et dernier mots.
+void OutOfCoreTeamH::applyBorder()
+{
+	auto const bm{ borderManagement() };
+	if (!isOpen() || (bm != BorderManagement::foreverDead && bm != BorderManagement::foreverAlive))
+		return;
+
+	bool const alive{ bm == BorderManagement::foreverAlive };
+	for (auto const y : { size_t{}, mHeight - 1 }) {
+		auto* words{ row(mCurrent, y) };
+		for (size_t k{}; k < mWordsPerRow; ++k)
+			mAliveCount -= static_cast<size_t>(std::popcount(words[k]));
+		std::fill_n(words, mWordsPerRow, alive ? ~Word{} : Word{});
+		words[mWordsPerRow - 1] &= lastMask();
+		for (size_t k{}; k < mWordsPerRow; ++k)
+			mAliveCount += static_cast<size_t>(std::popcount(words[k]));
+	}
+
+	for (size_t y{ 1 }; y + 1 < mHeight; ++y) {
+		setBit(row(mCurrent, y), 0, alive);
+		setBit(row(mCurrent, y), mWidth - 1, alive);
+	}
+}
+
+// Le compte des cellules vivantes est déjà à jour : relire la grille
+// coûterait un parcours complet des fichiers.
+void OutOfCoreTeamH::restart()
+{
+	mIteration = 0;
+	mTendency.reset(mAliveCount);
+}
@@ -0,0 +1,143 @@
+﻿#pragma once
+#ifndef OUTOFCORETEAMH_H
+#define OUTOFCORETEAMH_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+
+#include <GOL.h>
+#include "MappedFileTeamH.h"
+#include "TendencyTeamH.h"
+
+// Fichier : OutOfCoreTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/28
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe OutOfCoreTeamH
+//
+// Moteur pour les grilles plus grandes que la mémoire vive (200 000 x
+// 200 000 cellules = 5 Go par génération, même compactées). Les cellules
+// sont compactées à 1 bit (BitKernelTeamH) et les deux générations,
+// courante et suivante, sont deux fichiers projetés en mémoire
+// (MappedFileTeamH) dans le répertoire choisi.
+//
+// Une itération parcourt la grille par bandes de rangées, avec une fenêtre
+// glissante de trois bandes :
+// - la bande suivante est lue à l'avance pendant le calcul de la bande
+//   courante ;
+// - la bande calculée est envoyée au disque sans attendre (écriture
+//   différée) puis retirée de la mémoire du processus ;
+// - la bande précédente, qui n'est plus lue, est retirée aussi.
+// La mémoire utilisée reste de l'ordre de quelques bandes ; le débit du
+// disque devient la limite.
+//
+// Les deux fichiers sont créés par resize() et supprimés avec le moteur.
+// La grille doit mesurer au moins 3 x 3 ; si la taille est refusée ou si la
+// création des fichiers échoue (disque plein...), la grille est vide (0 x 0)
+// et isOpen() retourne false.
+//
+// Gestion de bord identique à FixedGridTeamH ; toutes les largeurs sont
+// permises. Les coordonnées commencent à 0. Le compte des cellules vivantes
+// est tenu à jour par chaque modification : rien ne relit toute la grille
+// sauf processOneStep.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class OutOfCoreTeamH : public GOL
+{
+public:
+	using Word = uint64_t;
+
+	// Taille visée d'une bande, en octets.
+	static constexpr size_t DEFAULT_BAND_BYTES{ 16 * 1024 * 1024 };
+
+	// Répertoire des fichiers : le répertoire temporaire si vide.
+	explicit OutOfCoreTeamH(std::string directory = {});
+	OutOfCoreTeamH(OutOfCoreTeamH const&) = delete;
+	OutOfCoreTeamH(OutOfCoreTeamH&&) = delete;
+	OutOfCoreTeamH& operator =(OutOfCoreTeamH const&) = delete;
+	OutOfCoreTeamH& operator =(OutOfCoreTeamH&&) = delete;
+
+	virtual ~OutOfCoreTeamH() = default;
+
+	// inline puisque trivial.
+	size_t width() const override { return mWidth; }
+	size_t height() const override { return mHeight; }
+	size_t size() const override { return mWidth * mHeight; }
+	State state(int x, int y) const override { return static_cast<State>(bit(row(mCurrent, static_cast<size_t>(y)), static_cast<size_t>(x))); }
+	std::string rule() const override { return mRule.value_or(std::string()); }
+	BorderManagement borderManagement() const override { return mBorderManagement.value_or(GOL::BorderManagement::immutableAsIs); }
+	Color color(State state) const override { return state == GOL::State::alive ? mAliveColor : mDeadColor; }
+
+	Statistics statistics() const override;
+	ImplementationInformation information() const override;
+
+	void resize(size_t width, size_t height, State defaultState) override;
+	bool setRule(std::string const& rule) override;
+	void setBorderManagement(BorderManagement borderManagement) override;
+	void setState(int x, int y, State state) override;
+	void fill(State state) override;
+	void fillAlternately(State firstCell) override;
+	void randomize(double percentAlive) override;
+	bool setFromPattern(std::string const& pattern, int centerX, int centerY) override;
+	bool setFromPattern(std::string const& pattern) override;
+	void setSolidColor(State state, Color const& color) override;
+	void processOneStep() override;
+	void updateImage(uint32_t* buffer, size_t buffer_size) const override;
+
+	bool isOpen() const { return mFiles[mCurrent].isOpen(); }
+	std::string const& directory() const { return mDirectory; }
+
+	// Nombre de rangées par bande. 0 (par défaut) : assez de rangées pour
+	// DEFAULT_BAND_BYTES.
+	void setBandRows(size_t rows) { mBandRows = rows; }
+	size_t bandRows() const;
+
+private:
+	std::string mDirectory;
+	std::optional<std::string> mRule;
+	std::optional<BorderManagement> mBorderManagement;
+	std::optional<IterationType> mIteration;
+
+	uint32_t mParsedRule;
+	size_t mWidth, mHeight, mWordsPerRow, mAliveCount;
+	size_t mBandRows;	// 0 : automatique
+
+	// Génération courante : mFiles[mCurrent].
+	std::array<MappedFileTeamH, 2> mFiles;
+	size_t mCurrent;
+
+	TendencyTeamH mTendency;
+	Color mDeadColor, mAliveColor;
+
+	std::random_device mRandomDevice;
+	std::mt19937 mEngine;
+
+	size_t rowBytes() const { return mWordsPerRow * sizeof(Word); }
+	Word* row(size_t file, size_t y) { return reinterpret_cast<Word*>(mFiles[file].data()) + y * mWordsPerRow; }
+	const Word* row(size_t file, size_t y) const { return reinterpret_cast<const Word*>(mFiles[file].data()) + y * mWordsPerRow; }
+	// Bits valides du dernier mot d'une rangée.
+	Word lastMask() const { return mWidth % 64 ? (Word{ 1 } << (mWidth % 64)) - 1 : ~Word{}; }
+
+	static Word bit(const Word* row, size_t x) { return (row[x / 64] >> (x % 64)) & 1; }
+	// Modifie un bit et ajuste le compte des cellules vivantes.
+	void setBit(Word* row, size_t x, bool alive);
+	// Écrit chaque rangée par function(y, words), bande par bande, et
+	// recompte les cellules vivantes.
+	template <typename Function>
+	void fillRows(Function function);
+	// Octets des rangées [begin, end).
+	size_t bytes(size_t begin, size_t end) const { return (end - begin) * rowBytes(); }
+
+	// Rangée y de la génération suivante ; retourne ses cellules vivantes.
+	size_t evolveRow(size_t y, Word* next) const;
+	bool evolvesBorder() const;
+	void applyBorder();
+	void restart();
+};
+
+#endif // OUTOFCORETEAMH_H
@@ -0,0 +1,169 @@
+﻿#include "ParsingTeamH.h"
+
+#include <cctype>
+#include <regex>
+#include <sstream>
+
+namespace
+{
+	unsigned char convertCharToNumber(const char c)
+	{
+		return (c - 48);
+	}
+}
+
+std::optional<uint32_t> ParsingTeamH::parseRule(std::string const& rule)
+{
+	static const std::regex regexp(R"(B(\d*)/S(\d*))", std::regex_constants::icase);
+	std::smatch m;
+
+	if (!std::regex_search(rule, m, regexp))
+		return std::nullopt;
+
+	uint32_t parsedRule{};
+	for (auto& i : m[1].str())
+		parsedRule |= 1u << convertCharToNumber(i);
+
+	for (auto& i : m[2].str())
+		parsedRule |= 1u << (convertCharToNumber(i) + SURVIVAL_SHIFT);
+
+	return parsedRule;
+}
+
+std::optional<NeighborhoodTeamH::Mask> ParsingTeamH::parseNeighborhood(std::string const& rule)
+{
+	static const std::regex regexp(R"(B\d*/S\d*([A-Z0-9]*))", std::regex_constants::icase);
+	std::smatch m;
+
+	if (!std::regex_search(rule, m, regexp))
+		return std::nullopt;
+
+	auto suffix{ m[1].str() };
+	for (auto& c : suffix)
+		c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+	if (suffix.empty())
+		return NeighborhoodTeamH::MOORE;
+	if (suffix == "V")
+		return NeighborhoodTeamH::VON_NEUMANN;
+	if (suffix == "H")
+		return NeighborhoodTeamH::HEXAGONAL;
+	if (suffix.size() == 3 && suffix[0] == 'N' && std::isxdigit(static_cast<unsigned char>(suffix[1])) &&
+		std::isxdigit(static_cast<unsigned char>(suffix[2])))
+		return static_cast<NeighborhoodTeamH::Mask>(std::stoul(suffix.substr(1), nullptr, 16));
+
+	return std::nullopt;
+}
+
+std::optional<ParsingTeamH::RangeRule> ParsingTeamH::parseRangeRule(std::string const& rule)
+{
+	RangeRule parsed{ .radius = 1, .includeCenter = false, .birth = {}, .survival = {} };
+
+	// Règle à rayon 1 : bit n -> intervalle [n, n].
+	if (rule.find('/') != std::string::npos) {
+		auto const bits{ parseRule(rule) };
+		if (!bits || parseNeighborhood(rule) != NeighborhoodTeamH::MOORE)
+			return std::nullopt;
+
+		for (unsigned n{}; n < SURVIVAL_SHIFT; ++n) {
+			if (*bits & (1u << n))
+				parsed.birth.push_back({ n, n });
+			if (*bits & (1u << (n + SURVIVAL_SHIFT)))
+				parsed.survival.push_back({ n, n });
+		}
+		return parsed;
+	}
+
+	// Valeur ou intervalle « a..b » / « a-b ».
+	static const std::regex range(R"((\d{1,8})(?:(?:\.\.|-)(\d{1,8}))?)");
+
+	std::stringstream stream(rule);
+	std::string field;
+	std::vector<std::pair<unsigned, unsigned>>* current{};
+	bool hasRadius{}, hasBirth{}, hasSurvival{};
+
+	while (std::getline(stream, field, ',')) {
+		if (field.empty())
+			return std::nullopt;
+
+		auto const letter{ static_cast<char>(std::toupper(static_cast<unsigned char>(field.front()))) };
+		auto value{ std::isdigit(static_cast<unsigned char>(field.front())) ? field : field.substr(1) };
+		std::smatch m;
+
+		switch (letter) {
+		case 'R':
+			if (!std::regex_match(value, m, range) || m[2].matched)
+				return std::nullopt;
+			parsed.radius = static_cast<unsigned>(std::stoul(m[1]));
+			hasRadius = true;
+			current = nullptr;
+			break;
+		case 'C':
+			// 0 et 2 désignent tous deux une règle à deux états.
+			if (value != "0" && value != "2")
+				return std::nullopt;
+			current = nullptr;
+			break;
+		case 'M':
+			if (value != "0" && value != "1")
+				return std::nullopt;
+			parsed.includeCenter = value == "1";
+			current = nullptr;
+			break;
+		case 'N':
+			if (value != "M" && value != "m")
+				return std::nullopt;
+			current = nullptr;
+			break;
+		case 'S':
+			current = &parsed.survival;
+			hasSurvival = true;
+			break;
+		case 'B':
+			current = &parsed.birth;
+			hasBirth = true;
+			break;
+		default:
+			// Une valeur seule continue la liste S ou B en cours.
+			if (!current || !std::isdigit(static_cast<unsigned char>(letter)))
+				return std::nullopt;
+			break;
+		}
+
+		if ((letter == 'S' || letter == 'B' || std::isdigit(static_cast<unsigned char>(letter))) && !value.empty()) {
+			if (!std::regex_match(value, m, range))
+				return std::nullopt;
+
+			auto const first{ static_cast<unsigned>(std::stoul(m[1])) };
+			auto const last{ m[2].matched ? static_cast<unsigned>(std::stoul(m[2])) : first };
+			if (first > last)
+				return std::nullopt;
+			current->push_back({ first, last });
+		}
+	}
+
+	if (!hasRadius || !hasBirth || !hasSurvival || parsed.radius == 0 || parsed.radius > MAX_RADIUS)
+		return std::nullopt;
+
+	return parsed;
+}
+
+std::optional<ParsingTeamH::Pattern> ParsingTeamH::parsePattern(std::string const& pattern)
+{
+	// \[ -> on match le caractère [
+	// (\d+) -> on match plusieurs caractères de 0-9
+	// std::regex_constants::icase -> min ou maj
+	static const std::regex regexp(R"(\[(\d+)x(\d+)\](\d+))", std::regex_constants::icase);
+	std::smatch m;
+
+	if (!std::regex_search(pattern, m, regexp))
+		return std::nullopt;
+
+	Pattern parsed{ .width = std::stoull(m[1]), .height = std::stoull(m[2]), .cells = m[3] };
+
+	// Un patron trop court ferait lire hors de la chaîne.
+	if (parsed.cells.size() < parsed.width * parsed.height)
+		return std::nullopt;
+
+	return parsed;
+}
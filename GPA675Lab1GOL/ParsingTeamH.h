@@ -0,0 +1,76 @@
+﻿#pragma once
+#ifndef PARSINGTEAMH_H
+#define PARSINGTEAMH_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "NeighborhoodTeamH.h"
+
+// Fichier : ParsingTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/15
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Fonctions ParsingTeamH
+//
+// Lecture des règles « B###/S### » et des patrons « [LxH]0101... »,
+// partagée par tous les moteurs.
+//
+// Une règle est encodée dans un uint32_t : les bits 0 à 15 sont ceux de la
+// réanimation (bit n = naissance avec n voisins) et les bits 16 à 31 ceux de
+// la survie. Voir GOLTeamH.h pour plus de détails.
+//
+// Les règles « Larger than Life » (voisinage de rayon R) suivent la notation
+// de Golly : « R5,C0,M1,S34..58,B34..45,NM » (règle de Bosco). Voir
+// parseRangeRule.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+namespace ParsingTeamH
+{
+	constexpr uint32_t SURVIVAL_SHIFT{ 16 };
+
+	// Patron lu : `cells` contient width * height caractères '0' ou '1'
+	// (rangée par rangée).
+	struct Pattern {
+		size_t width, height;
+		std::string cells;
+	};
+
+	// Retourne la règle encodée, ou rien si la chaîne est invalide. Une
+	// liste peut être vide (« B2/S », la règle Seeds).
+	std::optional<uint32_t> parseRule(std::string const& rule);
+
+	// Voisinage indiqué à la fin d'une règle « B###/S### » : rien (Moore),
+	// « V » (von Neumann), « H » (hexagonal) ou « N » suivi d'un masque
+	// hexadécimal de 2 chiffres (voir NeighborhoodTeamH), par exemple
+	// « B2/S34H » ou « B1/S1NA5 ». Rien si le suffixe est invalide.
+	std::optional<NeighborhoodTeamH::Mask> parseNeighborhood(std::string const& rule);
+
+	constexpr unsigned MAX_RADIUS{ 100 };
+
+	// Règle à voisinage de Moore de rayon `radius`. Les intervalles sont
+	// inclusifs et comptent les voisins vivants (la cellule elle-même si
+	// includeCenter).
+	struct RangeRule {
+		unsigned radius;
+		bool includeCenter;
+		std::vector<std::pair<unsigned, unsigned>> birth, survival;
+	};
+
+	// Accepte « Rr,Cc,Mm,Sa..b,Bc..d,NM » : les champs sont séparés par des
+	// virgules, dans n'importe quel ordre ; S et B acceptent plusieurs valeurs
+	// ou intervalles (« S2,3,5..7 », « B3-4 »). C doit valoir 0 ou 2 (deux
+	// états) et N doit être M (Moore). R vaut 1 et M vaut 0 par défaut. Une
+	// règle « B###/S### » donne l'équivalent de rayon 1 (voisinage de Moore
+	// seulement).
+	std::optional<RangeRule> parseRangeRule(std::string const& rule);
+
+	std::optional<Pattern> parsePattern(std::string const& pattern);
+}
+
+#endif // PARSINGTEAMH_H
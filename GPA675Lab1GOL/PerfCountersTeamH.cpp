@@ -0,0 +1,109 @@
+﻿#include "PerfCountersTeamH.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+PerfCountersTeamH::Sample PerfCountersTeamH::Sample::operator-(Sample const& other) const
+{
+	Sample result;
+	for (size_t i{}; i < values.size(); ++i)
+		if (values[i] && other.values[i])
+			result.values[i] = *values[i] - *other.values[i];
+	return result;
+}
+
+PerfCountersTeamH::Sample& PerfCountersTeamH::Sample::operator+=(Sample const& other)
+{
+	for (size_t i{}; i < values.size(); ++i)
+		if (other.values[i])
+			values[i] = values[i].value_or(0) + *other.values[i];
+	return *this;
+}
+
+PerfCountersTeamH::PerfCountersTeamH()
+{
+	mFds.fill(-1);
+}
+
+PerfCountersTeamH::~PerfCountersTeamH()
+{
+	close();
+}
+
+bool PerfCountersTeamH::open()
+{
+	close();
+
+#ifdef __linux__
+	constexpr std::array<uint64_t, static_cast<size_t>(Counter::count)> configs{
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_MISSES,
+	};
+
+	for (size_t i{}; i < configs.size(); ++i) {
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = configs[i];
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		// pid = 0, cpu = -1 : le fil appelant, peu importe le coeur.
+		mFds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+#endif
+
+	return available();
+}
+
+void PerfCountersTeamH::close()
+{
+#ifdef __linux__
+	for (auto& fd : mFds)
+		if (fd >= 0)
+			::close(fd);
+#endif
+	mFds.fill(-1);
+}
+
+bool PerfCountersTeamH::available() const
+{
+	for (int fd : mFds)
+		if (fd >= 0)
+			return true;
+	return false;
+}
+
+PerfCountersTeamH::Sample PerfCountersTeamH::read() const
+{
+	Sample sample;
+
+#ifdef __linux__
+	for (size_t i{}; i < mFds.size(); ++i) {
+		uint64_t value;
+		if (mFds[i] >= 0 && ::read(mFds[i], &value, sizeof(value)) == sizeof(value))
+			sample.values[i] = value;
+	}
+#endif
+
+	return sample;
+}
+
+const char* PerfCountersTeamH::name(Counter counter)
+{
+	switch (counter) {
+	case Counter::cycles: return "cycles";
+	case Counter::instructions: return "instructions";
+	case Counter::cacheMisses: return "cacheMisses";
+	case Counter::branchMisses: return "branchMisses";
+	default: return "";
+	}
+}
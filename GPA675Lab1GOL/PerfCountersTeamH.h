@@ -0,0 +1,66 @@
+﻿#pragma once
+#ifndef PERFCOUNTERSTEAMH_H
+#define PERFCOUNTERSTEAMH_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+// Fichier : PerfCountersTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/08
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe PerfCountersTeamH
+//
+// Lecture des compteurs matériels du fil courant (cycles, instructions,
+// défauts de cache, mauvaises prédictions de branchement) par
+// perf_event_open sous Linux.
+//
+// Chaque compteur est ouvert séparément : si l'un d'eux n'est pas supporté
+// (machine virtuelle, conteneur, perf_event_paranoid), sa valeur est
+// simplement absente. Sur les autres plateformes, rien n'est disponible.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class PerfCountersTeamH
+{
+public:
+	enum class Counter : uint8_t {
+		cycles = 0,
+		instructions,
+		cacheMisses,
+		branchMisses,
+		count
+	};
+
+	struct Sample {
+		std::array<std::optional<uint64_t>, static_cast<size_t>(Counter::count)> values;
+
+		std::optional<uint64_t> operator[](Counter counter) const { return values[static_cast<size_t>(counter)]; }
+		Sample operator-(Sample const& other) const;
+		Sample& operator+=(Sample const& other);
+	};
+
+	PerfCountersTeamH();
+	PerfCountersTeamH(PerfCountersTeamH const&) = delete;
+	PerfCountersTeamH& operator=(PerfCountersTeamH const&) = delete;
+	~PerfCountersTeamH();
+
+	// Ouvre les compteurs pour le fil appelant. Retourne true si au moins un
+	// compteur est disponible.
+	bool open();
+	void close();
+	bool available() const;
+
+	// Valeurs cumulatives depuis open(). Faire la différence entre deux
+	// lectures pour mesurer une section.
+	Sample read() const;
+
+	static const char* name(Counter counter);
+
+private:
+	std::array<int, static_cast<size_t>(Counter::count)> mFds;
+};
+
+#endif // PERFCOUNTERSTEAMH_H
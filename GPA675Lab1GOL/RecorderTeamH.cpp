@@ -0,0 +1,294 @@
+﻿#include "RecorderTeamH.h"
+#include "DeltaCodecTeamH.h"
+#include "TraceTeamH.h"
+
+#include <cstring>
+
+namespace
+{
+	constexpr char MAGIC[4]{ 'G', 'O', 'L', 'R' };
+	constexpr uint32_t VERSION{ 1 };
+
+	constexpr uint8_t ENTRY_KEY{ 0 };
+	constexpr uint8_t ENTRY_DELTA{ 1 };
+
+	template <typename T>
+	void writeRaw(std::ofstream& file, T value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	bool readRaw(std::ifstream& file, T& value)
+	{
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+}
+
+RecorderTeamH::RecorderTeamH()
+	: mCapacity{}, mKeyframeInterval{}, mWidth{}, mHeight{}, mStopRequested{}
+	, mRunning{}, mDropped{}, mRecorded{}
+{
+}
+
+RecorderTeamH::~RecorderTeamH()
+{
+	stop();
+}
+
+// Ouvre le fichier, écrit l'en-tête et démarre le fil d'écriture.
+bool RecorderTeamH::start(std::string const& path, size_t width, size_t height,
+	size_t keyframeInterval, size_t queueCapacity)
+{
+	stop();
+
+	mFile.open(path, std::ios::binary | std::ios::trunc);
+	if (!mFile)
+		return false;
+
+	mWidth = width;
+	mHeight = height;
+	mKeyframeInterval = keyframeInterval ? keyframeInterval : 1;
+	mCapacity = queueCapacity ? queueCapacity : 1;
+	mStopRequested = false;
+	mDropped = 0;
+	mRecorded = 0;
+
+	mFile.write(MAGIC, sizeof(MAGIC));
+	writeRaw(mFile, VERSION);
+	writeRaw(mFile, static_cast<uint64_t>(mWidth));
+	writeRaw(mFile, static_cast<uint64_t>(mHeight));
+	writeRaw(mFile, static_cast<uint32_t>(mKeyframeInterval));
+
+	// Tous les tampons sont alloués d'avance.
+	mFreeFrames.resize(mCapacity);
+	for (auto& frame : mFreeFrames)
+		frame.words.reserve(DeltaCodecTeamH::wordCount(mWidth * mHeight));
+
+	mRunning = true;
+	mWriter = std::thread(&RecorderTeamH::writerLoop, this);
+	return true;
+}
+
+// Vide la file, attend la fin du fil d'écriture et ferme le fichier.
+void RecorderTeamH::stop()
+{
+	if (!mRunning)
+		return;
+
+	{
+		std::lock_guard lock(mMutex);
+		mStopRequested = true;
+	}
+	mCondition.notify_one();
+
+	if (mWriter.joinable())
+		mWriter.join();
+
+	mFile.close();
+	mQueue.clear();
+	mFreeFrames.clear();
+	mRunning = false;
+}
+
+bool RecorderTeamH::record(GOL::IterationType iteration, GridTeamH const& grid)
+{
+	if (!mRunning || grid.width() != mWidth || grid.height() != mHeight)
+		return false;
+
+	Frame frame;
+	{
+		std::lock_guard lock(mMutex);
+		if (mFreeFrames.empty()) {
+			mDropped++;
+			return false;
+		}
+		frame = std::move(mFreeFrames.back());
+		mFreeFrames.pop_back();
+	}
+
+	// La compaction se fait hors du verrou, le fil d'écriture s'occupe du reste.
+	frame.iteration = iteration;
+	if (grid.layout() == GridTeamH::Layout::rowMajor)
+		DeltaCodecTeamH::pack(grid.data(), grid.size(), frame.words);
+	else {
+		mStaging.resize(grid.size());
+		grid.copyTo(mStaging.data());
+		DeltaCodecTeamH::pack(mStaging.data(), grid.size(), frame.words);
+	}
+
+	{
+		std::lock_guard lock(mMutex);
+		mQueue.push_back(std::move(frame));
+	}
+	mCondition.notify_one();
+	return true;
+}
+
+void RecorderTeamH::writerLoop()
+{
+	std::vector<uint64_t> previous;
+	std::vector<uint8_t> payload;
+	size_t sinceKey{};
+
+	TraceTeamH::setThreadName("recorder");
+
+	while (true) {
+		Frame frame;
+		{
+			std::unique_lock lock(mMutex);
+			mCondition.wait(lock, [this] { return mStopRequested || !mQueue.empty(); });
+
+			if (mQueue.empty())
+				break; // Arrêt demandé et plus rien à écrire.
+
+			frame = std::move(mQueue.front());
+			mQueue.pop_front();
+		}
+
+		GOLTEAMH_TRACE_SCOPE("RecorderTeamH::write");
+
+		bool const key{ sinceKey == 0 };
+		if (key)
+			previous.clear();
+
+		DeltaCodecTeamH::encodeXor(frame.words, previous, payload);
+
+		writeRaw(mFile, key ? ENTRY_KEY : ENTRY_DELTA);
+		writeRaw(mFile, static_cast<uint32_t>(frame.iteration));
+		writeRaw(mFile, static_cast<uint32_t>(payload.size()));
+		mFile.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+
+		sinceKey = (sinceKey + 1) % mKeyframeInterval;
+		mRecorded++;
+
+		// On garde la génération pour le prochain XOR et on recycle l'ancien tampon.
+		std::swap(previous, frame.words);
+		{
+			std::lock_guard lock(mMutex);
+			mFreeFrames.push_back(std::move(frame));
+		}
+	}
+
+	mFile.flush();
+}
+
+
+// Lit l'en-tête et construit l'index des entrées sans décoder les données.
+bool RecordingReaderTeamH::open(std::string const& path)
+{
+	mFile.close();
+	mFile.clear();
+	mIndex.clear();
+	mCurrent = static_cast<size_t>(-1);
+
+	mFile.open(path, std::ios::binary);
+	if (!mFile)
+		return false;
+
+	char magic[4];
+	uint32_t version, keyframeInterval;
+	uint64_t width, height;
+
+	if (!mFile.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+		!readRaw(mFile, version) || version != VERSION ||
+		!readRaw(mFile, width) || !readRaw(mFile, height) || !readRaw(mFile, keyframeInterval))
+		return false;
+
+	mWidth = width;
+	mHeight = height;
+	mWords.assign(DeltaCodecTeamH::wordCount(mWidth * mHeight), 0);
+
+	while (true) {
+		uint8_t type;
+		uint32_t iteration, size;
+		if (!readRaw(mFile, type) || !readRaw(mFile, iteration) || !readRaw(mFile, size))
+			break;
+
+		auto offset{ static_cast<std::streamoff>(mFile.tellg()) };
+		mFile.seekg(size, std::ios::cur);
+		if (!mFile)
+			break; // Entrée tronquée (enregistrement interrompu) : on l'ignore.
+
+		mIndex.push_back(Entry{ .key = type == ENTRY_KEY, .iteration = iteration, .size = size, .offset = offset });
+	}
+
+	// Le premier enregistrement doit être une image clé.
+	if (!mIndex.empty() && !mIndex.front().key)
+		mIndex.clear();
+
+	mFile.clear();
+	return true;
+}
+
+bool RecordingReaderTeamH::seek(size_t frame)
+{
+	if (frame >= mIndex.size())
+		return false;
+
+	if (frame == mCurrent)
+		return true;
+
+	// On repart de l'image clé précédente, sauf si on peut simplement avancer
+	// depuis la position courante.
+	size_t start{ frame };
+	while (!mIndex[start].key)
+		start--;
+
+	if (mCurrent != static_cast<size_t>(-1) && mCurrent >= start && mCurrent < frame)
+		start = mCurrent + 1;
+
+	for (size_t i{ start }; i <= frame; ++i) {
+		if (!apply(i)) {
+			mCurrent = static_cast<size_t>(-1);
+			return false;
+		}
+	}
+
+	mCurrent = frame;
+	return true;
+}
+
+bool RecordingReaderTeamH::apply(size_t frame)
+{
+	auto const& entry{ mIndex[frame] };
+
+	mPayload.resize(entry.size);
+	mFile.seekg(entry.offset);
+	if (!mFile.read(reinterpret_cast<char*>(mPayload.data()), entry.size)) {
+		mFile.clear();
+		return false;
+	}
+
+	if (entry.key)
+		std::fill(mWords.begin(), mWords.end(), 0);
+
+	return DeltaCodecTeamH::decodeXorInto(mPayload.data(), mPayload.size(), mWords);
+}
+
+GOL::IterationType RecordingReaderTeamH::iteration() const
+{
+	return mCurrent < mIndex.size() ? mIndex[mCurrent].iteration : 0;
+}
+
+GOL::State RecordingReaderTeamH::state(size_t column, size_t row) const
+{
+	size_t i{ row * mWidth + column };
+	return static_cast<GOL::State>((mWords[i / 64] >> (i % 64)) & 1);
+}
+
+bool RecordingReaderTeamH::copyTo(GridTeamH& grid) const
+{
+	if (mCurrent >= mIndex.size() || grid.width() != mWidth || grid.height() != mHeight)
+		return false;
+
+	if (grid.layout() == GridTeamH::Layout::rowMajor) {
+		DeltaCodecTeamH::unpack(mWords, grid.data(), grid.size());
+		return true;
+	}
+
+	std::vector<GOL::State> cells(grid.size());
+	DeltaCodecTeamH::unpack(mWords, cells.data(), cells.size());
+	grid.copyFrom(cells.data());
+	return true;
+}
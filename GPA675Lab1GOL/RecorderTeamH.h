@@ -0,0 +1,125 @@
+﻿#pragma once
+#ifndef RECORDERTEAMH_H
+#define RECORDERTEAMH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GOL.h"
+#include "GridTeamH.h"
+
+// Fichier : RecorderTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/05
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classes RecorderTeamH et RecordingReaderTeamH
+//
+// RecorderTeamH archive chaque génération dans un fichier compressé. Le fil
+// de simulation ne fait que compacter la grille (1 bit par cellule) et la
+// déposer dans une file bornée. Un fil d'écriture dédié calcule le XOR avec
+// la génération précédente, l'encode par plages et l'écrit sur disque. Une
+// image clé est écrite toutes les N générations.
+//
+// Si la file est pleine, la génération est abandonnée plutôt que de bloquer
+// la simulation (voir droppedFrames()).
+//
+// RecordingReaderTeamH relit un tel fichier et permet de se positionner sur
+// n'importe quelle génération enregistrée.
+//
+// Format du fichier :
+//   en-tête  : "GOLR" | version (u32) | largeur (u64) | hauteur (u64) | intervalle clé (u32)
+//   entrée   : type (u8, 0 = clé, 1 = delta) | itération (u32) | taille (u32) | données
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class RecorderTeamH
+{
+public:
+	RecorderTeamH();
+	RecorderTeamH(RecorderTeamH const&) = delete;
+	RecorderTeamH& operator=(RecorderTeamH const&) = delete;
+	~RecorderTeamH();
+
+	bool start(std::string const& path, size_t width, size_t height,
+		size_t keyframeInterval = 64, size_t queueCapacity = 16);
+	void stop();
+
+	bool isRecording() const { return mRunning; }
+	size_t droppedFrames() const { return mDropped; }
+	size_t recordedFrames() const { return mRecorded; }
+
+	// Appelée par le fil de simulation. Ne bloque jamais sur le disque.
+	// Retourne false si la génération a été abandonnée.
+	bool record(GOL::IterationType iteration, GridTeamH const& grid);
+
+private:
+	struct Frame {
+		GOL::IterationType iteration;
+		std::vector<uint64_t> words;
+	};
+
+	std::ofstream mFile;
+	std::thread mWriter;
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+
+	std::deque<Frame> mQueue;		// Générations en attente d'écriture
+	std::vector<Frame> mFreeFrames;	// Tampons recyclés pour éviter les allocations
+	std::vector<GOL::State> mStaging;	// Copie rangée par rangée d'une grille tiled
+	size_t mCapacity, mKeyframeInterval, mWidth, mHeight;
+	bool mStopRequested;
+
+	std::atomic<bool> mRunning;
+	std::atomic<size_t> mDropped, mRecorded;
+
+	void writerLoop();
+};
+
+
+class RecordingReaderTeamH
+{
+public:
+	RecordingReaderTeamH() = default;
+
+	bool open(std::string const& path);
+
+	size_t width() const { return mWidth; }
+	size_t height() const { return mHeight; }
+	size_t frameCount() const { return mIndex.size(); }
+
+	// Reconstruit la génération enregistrée d'indice `frame` (0 = première).
+	bool seek(size_t frame);
+
+	size_t frame() const { return mCurrent; }
+	GOL::IterationType iteration() const;
+	GOL::State state(size_t column, size_t row) const;
+
+	// Copie la génération courante dans une grille de même taille.
+	bool copyTo(GridTeamH& grid) const;
+
+private:
+	struct Entry {
+		bool key;
+		GOL::IterationType iteration;
+		uint32_t size;
+		std::streamoff offset;
+	};
+
+	mutable std::ifstream mFile;
+	std::vector<Entry> mIndex;
+	std::vector<uint64_t> mWords;
+	std::vector<uint8_t> mPayload;
+	size_t mWidth{}, mHeight{}, mCurrent{ static_cast<size_t>(-1) };
+
+	bool apply(size_t frame);
+};
+
+#endif // RECORDERTEAMH_H
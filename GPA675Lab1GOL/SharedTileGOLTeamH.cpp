@@ -0,0 +1,571 @@
+﻿#include "SharedTileGOLTeamH.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "BitKernelTeamH.h"
+#include "ParsingTeamH.h"
+#include "TraceTeamH.h"
+
+SharedTileGOLTeamH::Snapshot& SharedTileGOLTeamH::Snapshot::operator =(Snapshot&& other) noexcept
+{
+	if (this != &other) {
+		reset();
+		mStore = std::move(other.mStore);
+		mTiles = std::move(other.mTiles);
+		mWidth = other.mWidth;
+		mHeight = other.mHeight;
+		mAliveCount = other.mAliveCount;
+		mIteration = other.mIteration;
+	}
+	return *this;
+}
+
+SharedTileGOLTeamH::Snapshot::~Snapshot()
+{
+	reset();
+}
+
+void SharedTileGOLTeamH::Snapshot::reset()
+{
+	if (mStore)
+		for (auto id : mTiles)
+			mStore->release(id);
+
+	mStore.reset();
+	mTiles.clear();
+}
+
+SharedTileGOLTeamH::SharedTileGOLTeamH()
+	: mParsedRule{ *ParsingTeamH::parseRule("B3/S23") }
+	, mWidth{}, mHeight{}, mTilesX{}, mTilesY{}, mAliveCount{}
+	, mStore{ std::make_shared<TileStoreTeamH>() }
+	, mDeadColor{}, mAliveColor{}, mEngine(mRandomDevice())
+{
+}
+
+//! \brief Accesseurs retournant des informations générales sur la
+//! simulation en cours.
+//!
+//! \details Voir GOLTeamH::statistics.
+GOL::Statistics SharedTileGOLTeamH::statistics() const
+{
+	auto const cells{ size() };
+	auto const relative = [cells](size_t count) {
+		return cells ? static_cast<float>(count) / static_cast<float>(cells) : 0.0f;
+		};
+
+	return GOL::Statistics{
+		.rule = mRule,
+		.borderManagement = mBorderManagement,
+		.width = mWidth,
+		.height = mHeight,
+		.totalCells = cells,
+		.iteration = mIteration,
+		.totalDeadAbs = cells - mAliveCount,
+		.totalAliveAbs = mAliveCount,
+		.totalDeadRel = relative(cells - mAliveCount),
+		.totalAliveRel = relative(mAliveCount),
+		.tendencyAbs = static_cast<int>(std::lround(mTendency.slope())),
+		.tendencyRel = cells ? static_cast<float>(mTendency.slope() / static_cast<double>(cells)) : 0.0f
+	};
+}
+
+//! \brief Accesseurs retournant les informations sur la réalisation
+//! de l'implémentation.
+GOL::ImplementationInformation SharedTileGOLTeamH::information() const
+{
+	return ImplementationInformation{
+		.title{"Laboratoire 1 - Tuiles partagées"},
+		.authors{{{"Leclaire-Fournier"}, {"Timothée"}, {"timothee.leclaire-fournier.1@ens.etsmtl.ca"}},
+		{{"Euzenat"}, {"Martin"}, {"martin.euzenat.1@ens.etsmtl.ca"}}},
+		.answers{{"Un tableau d'identifiants de tuiles de 64 x 64 cellules compactées à 1 bit. Les tuiles \
+sont immuables et partagées par contenu : les tuiles vides ou identiques n'existent qu'une fois."},
+		{"Les tuiles dont le voisinage n'a pas changé sont conservées sans calcul ; les autres sont \
+calculées en tranches de bits et internées seulement si leur contenu change."},
+		{"Les couleurs sont encodées une fois par image ; le bit de la cellule sert d'indice."},
+		{"La règle est appliquée aux plans du compte des voisins (voir BitKernelTeamH)."}},
+		.optionnalComments{std::to_string(mStore->uniqueTiles()) + " tuiles distinctes pour "
+			+ std::to_string(mTiles.size()) + " tuiles."}
+	};
+}
+
+//! \brief Mutateur modifiant la taille de la grille de simulation.
+//!
+//! \details La grille reçoit une nouvelle réserve de tuiles : les
+//! générations figées de l'ancienne taille ne peuvent plus être remises.
+void SharedTileGOLTeamH::resize(size_t width, size_t height, State defaultState)
+{
+	if (width < 3 || height < 3)
+		width = height = 0;
+
+	mWidth = width;
+	mHeight = height;
+	mTilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	mTilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+	mAliveCount = 0;
+
+	mStore = std::make_shared<TileStoreTeamH>();
+	mTiles.assign(mTilesX * mTilesY, TileStoreTeamH::EMPTY);
+	mNextTiles.assign(mTiles.size(), TileStoreTeamH::EMPTY);
+	mChanged.assign(mTiles.size(), 1);
+	mNextChanged.assign(mTiles.size(), 1);
+
+	fill(defaultState);
+}
+
+//! \brief Mutateur modifiant la règle de la simulation.
+//!
+//! \details « B###/S### », voisinage de Moore seulement.
+bool SharedTileGOLTeamH::setRule(std::string const& rule)
+{
+	auto const parsed{ ParsingTeamH::parseRule(rule) };
+	if (!parsed || ParsingTeamH::parseNeighborhood(rule) != NeighborhoodTeamH::MOORE)
+		return false;
+
+	mRule = rule;
+	mParsedRule = *parsed;
+	restart();
+	return true;
+}
+
+void SharedTileGOLTeamH::setBorderManagement(BorderManagement borderManagement)
+{
+	mBorderManagement = borderManagement;
+	applyBorder();
+	restart();
+}
+
+//! \brief Mutateur modifiant l'état d'une cellule de la grille (origine 0).
+void SharedTileGOLTeamH::setState(int x, int y, State state)
+{
+	setCell(static_cast<size_t>(x), static_cast<size_t>(y), state == State::alive);
+	restart();
+}
+
+//! \brief Mutateur remplissant la grille de l'état passé en argument.
+//!
+//! \details Une grille vivante ne contient que quelques tuiles distinctes
+//! (pleines, et masquées au bord droit et au bas).
+void SharedTileGOLTeamH::fill(State state)
+{
+	if (state == State::alive)
+		fillTiles([](size_t, size_t, Tile& tile) { tile.fill(~Word{}); });
+	else {
+		for (auto& id : mTiles) {
+			mStore->release(id);
+			id = TileStoreTeamH::EMPTY;
+		}
+		mAliveCount = 0;
+	}
+
+	applyBorder();
+	restart();
+}
+
+void SharedTileGOLTeamH::fillAlternately(State firstCell)
+{
+	// Bits pairs : colonnes paires (une tuile commence à une colonne paire).
+	constexpr Word EVEN{ 0x5555555555555555ull };
+	auto const first{ firstCell == State::alive ? EVEN : ~EVEN };
+
+	fillTiles([first](size_t, size_t, Tile& tile) {
+		for (size_t y{}; y < TILE_SIZE; ++y)
+			tile[y] = y % 2 ? ~first : first;
+		});
+
+	applyBorder();
+	restart();
+}
+
+void SharedTileGOLTeamH::randomize(double percentAlive)
+{
+	std::uniform_real_distribution<> distribution(0.0, 1.0);
+	fillTiles([this, &distribution, percentAlive](size_t, size_t, Tile& tile) {
+		for (auto& word : tile) {
+			word = 0;
+			for (size_t i{}; i < 64; ++i)
+				word |= Word{ distribution(mEngine) < percentAlive } << i;
+		}
+		});
+
+	applyBorder();
+	restart();
+}
+
+//! \brief Mutateur remplissant la grille par le patron passé en argument.
+//!
+//! \details Comme LargerThanLifeTeamH::setFromPattern : la grille est vidée
+//! puis le patron est centré sur (centerX, centerY).
+bool SharedTileGOLTeamH::setFromPattern(std::string const& pattern, int centerX, int centerY)
+{
+	auto const parsed{ ParsingTeamH::parsePattern(pattern) };
+	if (!parsed)
+		return false;
+
+	fill(State::dead);
+
+	auto const left{ static_cast<int64_t>(centerX) - static_cast<int64_t>((parsed->width + 1) / 2) };
+	auto const top{ static_cast<int64_t>(centerY) - static_cast<int64_t>((parsed->height + 1) / 2) };
+
+	for (size_t y{}; y < parsed->height; ++y) {
+		for (size_t x{}; x < parsed->width; ++x) {
+			auto const destX{ left + static_cast<int64_t>(x) }, destY{ top + static_cast<int64_t>(y) };
+			if (parsed->cells[y * parsed->width + x] != '0' && destX >= 0 && destY >= 0
+				&& destX < static_cast<int64_t>(mWidth) && destY < static_cast<int64_t>(mHeight))
+				setCell(static_cast<size_t>(destX), static_cast<size_t>(destY), true);
+		}
+	}
+
+	applyBorder();
+	restart();
+	return true;
+}
+
+//! \brief Surcharge centrant le patron dans la grille.
+bool SharedTileGOLTeamH::setFromPattern(std::string const& pattern)
+{
+	return setFromPattern(pattern, static_cast<int>(mWidth / 2), static_cast<int>(mHeight / 2));
+}
+
+void SharedTileGOLTeamH::setSolidColor(State state, Color const& color)
+{
+	if (state == State::alive)
+		mAliveColor = color;
+	else
+		mDeadColor = color;
+}
+
+//! \brief Fonction effectuant une itération de la simulation.
+//!
+//! \details Les tuiles dont le voisinage n'a pas changé gardent leur
+//! identifiant ; les autres sont calculées (computeTile) puis comparées à
+//! l'ancienne tuile avant d'être internées. Le résultat d'une tuile
+//! intérieure est réutilisé pour les voisinages identiques.
+void SharedTileGOLTeamH::processOneStep()
+{
+	GOLTEAMH_TRACE_SCOPE("SharedTileGOLTeamH::processOneStep");
+
+	bool const birthOnZero{ (mParsedRule & 1u) != 0 };
+	size_t aliveCount{};
+	mResults.clear();
+
+	for (size_t tileY{}; tileY < mTilesY; ++tileY) {
+		for (size_t tileX{}; tileX < mTilesX; ++tileX) {
+			auto const index{ tileY * mTilesX + tileX };
+			auto const id{ mTiles[index] };
+			auto& next{ mNextTiles[index] };
+			bool referenced{};	// intern() a ajouté la référence de la grille suivante
+
+			if (!neighborhoodChanged(tileX, tileY) || (!birthOnZero && neighborhoodEmpty(tileX, tileY)))
+				next = id;
+			else {
+				// Les tuiles intérieures ne dépendent que de leur voisinage.
+				bool const inner{ tileX > 0 && tileY > 0 && tileX + 1 < mTilesX && tileY + 1 < mTilesY };
+				Neighborhood neighborhood{};
+				if (inner) {
+					for (size_t i{}; i < 9; ++i)
+						neighborhood[i] = tileAt(tileX + i % 3 - 1, tileY + i / 3 - 1);
+				}
+
+				auto const found{ inner ? mResults.find(neighborhood) : mResults.end() };
+				if (found != mResults.end())
+					next = found->second;
+				else {
+					auto const tile{ computeTile(tileX, tileY) };
+					referenced = tile != mStore->tile(id);
+					next = referenced ? mStore->intern(tile) : id;
+					if (inner)
+						mResults.emplace(neighborhood, next);
+				}
+			}
+
+			if (!referenced)
+				mStore->retain(next);
+			mNextChanged[index] = next != id;
+			aliveCount += mStore->aliveCount(next);
+		}
+	}
+
+	for (auto id : mTiles)
+		mStore->release(id);
+	mTiles.swap(mNextTiles);
+	mChanged.swap(mNextChanged);
+
+	mAliveCount = aliveCount;
+	mTendency.push(aliveCount);
+	mIteration = mIteration.value_or(0) + 1;
+}
+
+void SharedTileGOLTeamH::updateImage(uint32_t* buffer, size_t buffer_size) const
+{
+	if (buffer == nullptr)
+		return;
+
+	GOLTEAMH_TRACE_SCOPE("SharedTileGOLTeamH::updateImage");
+
+	auto const encode = [](Color const& color) {
+		return 0xFF000000u | static_cast<uint32_t>(color.red) << 16 | static_cast<uint32_t>(color.green) << 8 | color.blue;
+		};
+	uint32_t const colors[2]{ encode(mDeadColor), encode(mAliveColor) };
+
+	auto const pixels{ std::min(buffer_size, size()) };
+	for (size_t y{}; y * mWidth < pixels; ++y) {
+		auto const count{ std::min(mWidth, pixels - y * mWidth) };
+		for (size_t x{}; x < count; ++x)
+			buffer[y * mWidth + x] = colors[cell(x, y)];
+	}
+
+	std::fill(buffer + pixels, buffer + buffer_size, 0u);
+}
+
+//! \brief Retourne la génération courante, sans copier les tuiles.
+SharedTileGOLTeamH::Snapshot SharedTileGOLTeamH::snapshot() const
+{
+	Snapshot snapshot;
+	snapshot.mStore = mStore;
+	snapshot.mTiles = mTiles;
+	snapshot.mWidth = mWidth;
+	snapshot.mHeight = mHeight;
+	snapshot.mAliveCount = mAliveCount;
+	snapshot.mIteration = mIteration.value_or(0);
+
+	for (auto id : mTiles)
+		mStore->retain(id);
+	return snapshot;
+}
+
+void SharedTileGOLTeamH::restore(Snapshot const& snapshot)
+{
+	if (snapshot.mStore != mStore || snapshot.mWidth != mWidth || snapshot.mHeight != mHeight)
+		return;
+
+	for (auto id : snapshot.mTiles)
+		mStore->retain(id);
+	for (auto id : mTiles)
+		mStore->release(id);
+	mTiles = snapshot.mTiles;
+	mAliveCount = snapshot.mAliveCount;
+
+	restart();
+	mIteration = snapshot.mIteration;
+}
+
+size_t SharedTileGOLTeamH::memoryBytes() const
+{
+	return (mTiles.capacity() + mNextTiles.capacity()) * sizeof(Id)
+		+ mChanged.capacity() + mNextChanged.capacity() + mStore->memoryBytes();
+}
+
+size_t SharedTileGOLTeamH::NeighborhoodHash::operator()(Neighborhood const& neighborhood) const
+{
+	uint64_t h{ 0xCBF29CE484222325ull };
+	for (auto id : neighborhood)
+		h = (h ^ id) * 0x100000001B3ull;
+	return static_cast<size_t>(h ^ (h >> 32));
+}
+
+bool SharedTileGOLTeamH::cell(size_t x, size_t y) const
+{
+	return (mStore->tile(tileAt(x / TILE_SIZE, y / TILE_SIZE))[y % TILE_SIZE] >> (x % TILE_SIZE)) & 1;
+}
+
+SharedTileGOLTeamH::Tile SharedTileGOLTeamH::mask(size_t tileX, size_t tileY) const
+{
+	auto const columns{ std::min(TILE_SIZE, mWidth - tileX * TILE_SIZE) };
+	auto const rows{ std::min(TILE_SIZE, mHeight - tileY * TILE_SIZE) };
+	auto const word{ columns == TILE_SIZE ? ~Word{} : (Word{ 1 } << columns) - 1 };
+
+	Tile tile{};
+	std::fill_n(tile.begin(), rows, word);
+	return tile;
+}
+
+void SharedTileGOLTeamH::replace(size_t tileX, size_t tileY, Tile tile)
+{
+	auto const valid{ mask(tileX, tileY) };
+	for (size_t y{}; y < TILE_SIZE; ++y)
+		tile[y] &= valid[y];
+
+	auto& id{ tileAt(tileX, tileY) };
+	auto const next{ mStore->intern(tile) };
+	mAliveCount = mAliveCount - mStore->aliveCount(id) + mStore->aliveCount(next);
+	mStore->release(id);
+	id = next;
+}
+
+void SharedTileGOLTeamH::setCell(size_t x, size_t y, bool alive)
+{
+	auto const tileX{ x / TILE_SIZE }, tileY{ y / TILE_SIZE };
+	auto tile{ mStore->tile(tileAt(tileX, tileY)) };
+	auto& word{ tile[y % TILE_SIZE] };
+	auto const bit{ Word{ 1 } << (x % TILE_SIZE) };
+	if (((word & bit) != 0) == alive)
+		return;
+
+	word ^= bit;
+	replace(tileX, tileY, tile);
+}
+
+template <typename Function>
+void SharedTileGOLTeamH::fillTiles(Function function)
+{
+	for (size_t tileY{}; tileY < mTilesY; ++tileY) {
+		for (size_t tileX{}; tileX < mTilesX; ++tileX) {
+			Tile tile;
+			function(tileX, tileY, tile);
+			replace(tileX, tileY, tile);
+		}
+	}
+}
+
+SharedTileGOLTeamH::Word SharedTileGOLTeamH::rowWord(size_t tileX, size_t y) const
+{
+	auto word{ mStore->tile(tileAt(tileX, y / TILE_SIZE))[y % TILE_SIZE] };
+	if (tileX + 1 == mTilesX && mWidth % TILE_SIZE)
+		word |= eastGhost(y) << (mWidth % TILE_SIZE);
+	return word;
+}
+
+// Colonne opposée en warping, colonne 1 (resp. W - 2) en mirror ; sans
+// effet dans les autres modes (colonnes fixes).
+SharedTileGOLTeamH::Word SharedTileGOLTeamH::westGhost(size_t y) const
+{
+	auto const bm{ borderManagement() };
+	if (bm == BorderManagement::warping)
+		return cell(mWidth - 1, y);
+	return bm == BorderManagement::mirror ? cell(1, y) : 0;
+}
+
+SharedTileGOLTeamH::Word SharedTileGOLTeamH::eastGhost(size_t y) const
+{
+	auto const bm{ borderManagement() };
+	if (bm == BorderManagement::warping)
+		return cell(0, y);
+	return bm == BorderManagement::mirror ? cell(mWidth - 2, y) : 0;
+}
+
+// Génération suivante d'une tuile. Les rangées -1 à 64 de la tuile sont
+// rassemblées avec leurs bits voisins à gauche et à droite (tuiles voisines
+// ou cellules fantômes) ; les rangées hors de la grille suivent la gestion
+// de bord. En immutableAsIs, foreverDead et foreverAlive, les rangées 0 et
+// H - 1 et les colonnes 0 et W - 1 sont recopiées.
+SharedTileGOLTeamH::Tile SharedTileGOLTeamH::computeTile(size_t tileX, size_t tileY) const
+{
+	bool const all{ evolvesBorder() };
+	bool const mirror{ borderManagement() == BorderManagement::mirror };
+	bool const lastColumn{ tileX + 1 == mTilesX };
+	auto const tail{ mWidth % TILE_SIZE };
+
+	Word rows[TILE_SIZE + 2], west[TILE_SIZE + 2], east[TILE_SIZE + 2];
+	for (size_t i{}; i < TILE_SIZE + 2; ++i) {
+		// Rangée globale y = tileY * 64 + i - 1, ramenée dans la grille.
+		auto const below{ tileY * TILE_SIZE + i };	// y + 1
+		if (below > mHeight + 1 || (!all && (below == 0 || below == mHeight + 1))) {
+			rows[i] = west[i] = east[i] = 0;
+			continue;
+		}
+
+		auto const y{ below == 0 ? (mirror ? 1 : mHeight - 1)
+			: below == mHeight + 1 ? (mirror ? mHeight - 2 : 0) : below - 1 };
+		rows[i] = rowWord(tileX, y);
+		west[i] = tileX > 0 ? rowWord(tileX - 1, y) : westGhost(y) << 63;
+		east[i] = !lastColumn ? rowWord(tileX + 1, y) : (tail ? 0 : eastGhost(y));
+	}
+
+	auto const& current{ mStore->tile(tileAt(tileX, tileY)) };
+	auto const valid{ mask(tileX, tileY) };
+	Tile tile;
+	for (size_t r{}; r < TILE_SIZE; ++r) {
+		tile[r] = BitKernelTeamH::evolve(rows[r], rows[r + 1], rows[r + 2],
+			west[r], west[r + 1], west[r + 2], east[r], east[r + 1], east[r + 2], mParsedRule) & valid[r];
+
+		if (!all && valid[r]) {
+			auto const y{ tileY * TILE_SIZE + r };
+			if (y == 0 || y + 1 == mHeight)
+				tile[r] = current[r];
+			else {
+				// Colonnes 0 et W - 1 : inchangées.
+				auto fixed{ tileX == 0 ? Word{ 1 } : Word{} };
+				if (lastColumn)
+					fixed |= Word{ 1 } << ((mWidth - 1) % TILE_SIZE);
+				tile[r] = (tile[r] & ~fixed) | (current[r] & fixed);
+			}
+		}
+	}
+	return tile;
+}
+
+// Les tuiles du contour voient, en warping et mirror, des cellules de
+// l'autre côté de la grille : elles sont toujours calculées.
+bool SharedTileGOLTeamH::neighborhoodChanged(size_t tileX, size_t tileY) const
+{
+	if (evolvesBorder() && (tileX == 0 || tileY == 0 || tileX + 1 == mTilesX || tileY + 1 == mTilesY))
+		return true;
+
+	for (auto y{ tileY > 0 ? tileY - 1 : 0 }; y <= std::min(tileY + 1, mTilesY - 1); ++y)
+		for (auto x{ tileX > 0 ? tileX - 1 : 0 }; x <= std::min(tileX + 1, mTilesX - 1); ++x)
+			if (mChanged[y * mTilesX + x])
+				return true;
+	return false;
+}
+
+bool SharedTileGOLTeamH::neighborhoodEmpty(size_t tileX, size_t tileY) const
+{
+	if (evolvesBorder() && (tileX == 0 || tileY == 0 || tileX + 1 == mTilesX || tileY + 1 == mTilesY))
+		return false;
+
+	for (auto y{ tileY > 0 ? tileY - 1 : 0 }; y <= std::min(tileY + 1, mTilesY - 1); ++y)
+		for (auto x{ tileX > 0 ? tileX - 1 : 0 }; x <= std::min(tileX + 1, mTilesX - 1); ++x)
+			if (tileAt(x, y) != TileStoreTeamH::EMPTY)
+				return false;
+	return true;
+}
+
+bool SharedTileGOLTeamH::evolvesBorder() const
+{
+	auto const bm{ borderManagement() };
+	return bm == BorderManagement::warping || bm == BorderManagement::mirror;
+}
+
+// foreverDead et foreverAlive : le contour prend sa valeur. Seules les
+// tuiles du contour sont remplacées.
+void SharedTileGOLTeamH::applyBorder()
+{
+	auto const bm{ borderManagement() };
+	if (bm != BorderManagement::foreverDead && bm != BorderManagement::foreverAlive)
+		return;
+
+	bool const alive{ bm == BorderManagement::foreverAlive };
+	for (size_t tileY{}; tileY < mTilesY; ++tileY) {
+		for (size_t tileX{}; tileX < mTilesX; ++tileX) {
+			if (tileX != 0 && tileY != 0 && tileX + 1 != mTilesX && tileY + 1 != mTilesY)
+				continue;
+
+			auto tile{ mStore->tile(tileAt(tileX, tileY)) };
+			for (size_t r{}; r < TILE_SIZE; ++r) {
+				auto const y{ tileY * TILE_SIZE + r };
+				Word border{};
+				if (y == 0 || y + 1 == mHeight)
+					border = ~Word{};
+				else {
+					if (tileX == 0)
+						border |= Word{ 1 };
+					if (tileX + 1 == mTilesX)
+						border |= Word{ 1 } << ((mWidth - 1) % TILE_SIZE);
+				}
+				tile[r] = alive ? tile[r] | border : tile[r] & ~border;
+			}
+			replace(tileX, tileY, tile);
+		}
+	}
+}
+
+// Le compte des cellules vivantes est tenu à jour par replace(). Tous les
+// voisinages sont considérés changés.
+void SharedTileGOLTeamH::restart()
+{
+	mIteration = 0;
+	mTendency.reset(mAliveCount);
+	std::fill(mChanged.begin(), mChanged.end(), uint8_t{ 1 });
+}
@@ -0,0 +1,183 @@
+﻿#pragma once
+#ifndef SHAREDTILEGOLTEAMH_H
+#define SHAREDTILEGOLTEAMH_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <GOL.h>
+#include "TendencyTeamH.h"
+#include "TileStoreTeamH.h"
+
+// Fichier : SharedTileGOLTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/03/01
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe SharedTileGOLTeamH
+//
+// Moteur pour les grandes grilles creuses ou répétitives. La grille est un
+// tableau d'identifiants de tuiles de 64 x 64 cellules d'une
+// TileStoreTeamH : les tuiles vides et les tuiles identiques sont une
+// seule tuile en mémoire. Une grille de 100 000 x 100 000 cellules vide
+// occupe environ 10 Mo d'identifiants au lieu de 10 Go d'octets.
+//
+// Une itération calcule chaque tuile à partir de ses 8 voisines, sauf :
+// - si la tuile et ses voisines n'ont pas changé à l'itération précédente :
+//   la tuile est conservée telle quelle ;
+// - si la tuile et ses voisines sont vides (règles sans B0) : la tuile
+//   reste vide.
+// Une tuile calculée identique à l'ancienne garde son identifiant ; une
+// nouvelle tuile n'est internée que si son contenu change. Pendant une
+// itération, le résultat de chaque voisinage de 3 x 3 tuiles intérieures
+// est mémorisé : un motif répété n'est calculé qu'une fois.
+//
+// snapshot() copie seulement les identifiants (4 octets par tuile) : les
+// tuiles sont immuables et partagées avec la grille.
+//
+// Gestion de bord identique à FixedGridTeamH ; toutes les tailles à partir
+// de 3 x 3 sont permises (la grille est vide, 0 x 0, en deçà). Les
+// coordonnées commencent à 0.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class SharedTileGOLTeamH : public GOL
+{
+public:
+	using Word = uint64_t;
+	using Id = TileStoreTeamH::Id;
+	using Tile = TileStoreTeamH::Tile;
+	static constexpr size_t TILE_SIZE{ TileStoreTeamH::TILE_SIZE };
+
+	// Génération figée : conserve une référence sur chacune de ses tuiles
+	// jusqu'à sa destruction.
+	class Snapshot
+	{
+	public:
+		Snapshot() = default;
+		Snapshot(Snapshot const&) = delete;
+		Snapshot(Snapshot&&) = default;
+		Snapshot& operator =(Snapshot const&) = delete;
+		Snapshot& operator =(Snapshot&& other) noexcept;
+		~Snapshot();
+
+		bool empty() const { return !mStore; }
+		IterationType iteration() const { return mIteration; }
+
+	private:
+		friend class SharedTileGOLTeamH;
+
+		std::shared_ptr<TileStoreTeamH> mStore;
+		std::vector<Id> mTiles;
+		size_t mWidth{}, mHeight{}, mAliveCount{};
+		IterationType mIteration{};
+
+		void reset();
+	};
+
+	SharedTileGOLTeamH();
+	SharedTileGOLTeamH(SharedTileGOLTeamH const&) = delete;
+	SharedTileGOLTeamH(SharedTileGOLTeamH&&) = delete;
+	SharedTileGOLTeamH& operator =(SharedTileGOLTeamH const&) = delete;
+	SharedTileGOLTeamH& operator =(SharedTileGOLTeamH&&) = delete;
+
+	virtual ~SharedTileGOLTeamH() = default;
+
+	// inline puisque trivial.
+	size_t width() const override { return mWidth; }
+	size_t height() const override { return mHeight; }
+	size_t size() const override { return mWidth * mHeight; }
+	State state(int x, int y) const override { return static_cast<State>(cell(static_cast<size_t>(x), static_cast<size_t>(y))); }
+	std::string rule() const override { return mRule.value_or(std::string()); }
+	BorderManagement borderManagement() const override { return mBorderManagement.value_or(GOL::BorderManagement::immutableAsIs); }
+	Color color(State state) const override { return state == GOL::State::alive ? mAliveColor : mDeadColor; }
+
+	Statistics statistics() const override;
+	ImplementationInformation information() const override;
+
+	void resize(size_t width, size_t height, State defaultState) override;
+	bool setRule(std::string const& rule) override;
+	void setBorderManagement(BorderManagement borderManagement) override;
+	void setState(int x, int y, State state) override;
+	void fill(State state) override;
+	void fillAlternately(State firstCell) override;
+	void randomize(double percentAlive) override;
+	bool setFromPattern(std::string const& pattern, int centerX, int centerY) override;
+	bool setFromPattern(std::string const& pattern) override;
+	void setSolidColor(State state, Color const& color) override;
+	void processOneStep() override;
+	void updateImage(uint32_t* buffer, size_t buffer_size) const override;
+
+	Snapshot snapshot() const;
+	// Remet la grille, le compte et l'itération de la génération figée. Sans
+	// effet si elle vient d'un autre moteur.
+	void restore(Snapshot const& snapshot);
+
+	TileStoreTeamH const& store() const { return *mStore; }
+	size_t tilesX() const { return mTilesX; }
+	size_t tilesY() const { return mTilesY; }
+	// Mémoire de la grille : identifiants et tuiles distinctes.
+	size_t memoryBytes() const;
+
+private:
+	// Identifiants des 3 x 3 tuiles d'un voisinage, rangée par rangée.
+	using Neighborhood = std::array<Id, 9>;
+
+	struct NeighborhoodHash {
+		size_t operator()(Neighborhood const& neighborhood) const;
+	};
+
+	std::optional<std::string> mRule;
+	std::optional<BorderManagement> mBorderManagement;
+	std::optional<IterationType> mIteration;
+	uint32_t mParsedRule;
+
+	size_t mWidth, mHeight, mTilesX, mTilesY, mAliveCount;
+	std::shared_ptr<TileStoreTeamH> mStore;
+	std::vector<Id> mTiles, mNextTiles;
+	// Tuiles changées à la dernière itération (1 = changée ou inconnue).
+	std::vector<uint8_t> mChanged, mNextChanged;
+	// Voisinage -> tuile suivante, pour l'itération en cours.
+	std::unordered_map<Neighborhood, Id, NeighborhoodHash> mResults;
+
+	TendencyTeamH mTendency;
+	Color mDeadColor, mAliveColor;
+
+	std::random_device mRandomDevice;
+	std::mt19937 mEngine;
+
+	Id& tileAt(size_t tileX, size_t tileY) { return mTiles[tileY * mTilesX + tileX]; }
+	Id tileAt(size_t tileX, size_t tileY) const { return mTiles[tileY * mTilesX + tileX]; }
+	bool cell(size_t x, size_t y) const;
+	// Cellules valides de la tuile (zéro hors de la grille).
+	Tile mask(size_t tileX, size_t tileY) const;
+	// Remplace la tuile par `tile` (masquée) et ajuste le compte.
+	void replace(size_t tileX, size_t tileY, Tile tile);
+	void setCell(size_t x, size_t y, bool alive);
+	// Remplit chaque tuile par function(tileX, tileY, tile).
+	template <typename Function>
+	void fillTiles(Function function);
+
+	// Rangée y (globale, dans la grille) de la colonne de tuiles tileX, avec
+	// la cellule fantôme de droite dans le remplissage de la dernière tuile.
+	Word rowWord(size_t tileX, size_t y) const;
+	// Cellules fantômes à gauche de la colonne 0 et à droite de la colonne
+	// W - 1 de la rangée y.
+	Word westGhost(size_t y) const;
+	Word eastGhost(size_t y) const;
+	Tile computeTile(size_t tileX, size_t tileY) const;
+	bool neighborhoodChanged(size_t tileX, size_t tileY) const;
+	bool neighborhoodEmpty(size_t tileX, size_t tileY) const;
+
+	bool evolvesBorder() const;
+	void applyBorder();
+	void restart();
+};
+
+#endif // SHAREDTILEGOLTEAMH_H
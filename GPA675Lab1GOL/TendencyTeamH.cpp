@@ -0,0 +1,108 @@
+﻿#include "TendencyTeamH.h"
+
+#include <algorithm>
+#include <cmath>
+
+TendencyTeamH::TendencyTeamH()
+	: mWindow{}, mNext{}, mCount{}, mSum{}, mWeightedSum{}, mSumSquares{}
+{
+}
+
+void TendencyTeamH::reset(size_t aliveCount)
+{
+	mNext = 0;
+	mCount = 0;
+	mSum = 0;
+	mWeightedSum = 0;
+	mSumSquares = 0.0;
+	push(aliveCount);
+}
+
+void TendencyTeamH::push(size_t aliveCount)
+{
+	auto const value{ static_cast<int64_t>(aliveCount) };
+
+	if (mCount == WINDOW_SIZE) {
+		// Le plus ancien sort : les indices des autres diminuent de 1.
+		auto const oldest{ static_cast<int64_t>(mWindow[mNext]) };
+		mSum -= oldest;
+		mWeightedSum -= mSum;
+		mSumSquares -= static_cast<double>(oldest) * static_cast<double>(oldest);
+	}
+	else
+		mCount++;
+
+	mWindow[mNext] = aliveCount;
+	mNext = (mNext + 1) % WINDOW_SIZE;
+
+	mSum += value;
+	mWeightedSum += static_cast<int64_t>(mCount - 1) * value;
+	mSumSquares += static_cast<double>(value) * static_cast<double>(value);
+
+	// Resynchronisation de Q à chaque tour complet du tampon.
+	if (mNext == 0) {
+		mSumSquares = 0.0;
+		for (size_t i{}; i < mCount; ++i)
+			mSumSquares += static_cast<double>(mWindow[i]) * static_cast<double>(mWindow[i]);
+	}
+}
+
+void TendencyTeamH::repeat(size_t period, size_t generations)
+{
+	if (period == 0 || period > mCount)
+		return;
+
+	// Seuls les WINDOW_SIZE derniers comptes restent ; on garde la même phase
+	// du cycle que si toutes les générations avaient été ajoutées.
+	if (generations > WINDOW_SIZE)
+		generations = WINDOW_SIZE + (generations - WINDOW_SIZE) % period;
+
+	for (size_t i{}; i < generations; ++i)
+		push(mWindow[(mNext + WINDOW_SIZE - period) % WINDOW_SIZE]);
+}
+
+double TendencyTeamH::slope() const
+{
+	if (mCount < 2)
+		return 0.0;
+
+	// Pente des moindres carrés avec x = 0..n-1 :
+	// (n·T - Sx·S) / (n·Sxx - Sx²), où Sx = n(n-1)/2 et n·Sxx - Sx² = n²(n²-1)/12.
+	auto const n{ static_cast<double>(mCount) };
+	auto const sumIndex{ n * (n - 1.0) / 2.0 };
+	auto const denominator{ n * n * (n * n - 1.0) / 12.0 };
+	return (n * static_cast<double>(mWeightedSum) - sumIndex * static_cast<double>(mSum)) / denominator;
+}
+
+double TendencyTeamH::residualVariance() const
+{
+	if (mCount < 3)
+		return 0.0;
+
+	// SSE = Σ(x - moyenne)² - pente²·Σ(i - moyenne_i)²
+	auto const n{ static_cast<double>(mCount) };
+	auto const mean{ static_cast<double>(mSum) / n };
+	auto const spread{ mSumSquares - mean * static_cast<double>(mSum) };
+	auto const indexSpread{ n * (n * n - 1.0) / 12.0 };
+	auto const currentSlope{ slope() };
+	return std::max(0.0, spread - currentSlope * currentSlope * indexSpread) / (n - 2.0);
+}
+
+char TendencyTeamH::stability() const
+{
+	if (mCount < 3)
+		return '-';
+
+	// Écart-type résiduel relatif à la population moyenne. Le plancher de 1
+	// évite qu'une population presque nulle paraisse très instable.
+	auto const mean{ std::max(1.0, static_cast<double>(mSum) / static_cast<double>(mCount)) };
+	auto const relative{ std::sqrt(residualVariance()) / mean };
+
+	if (relative < 0.01)
+		return '-';
+	if (relative < 0.05)
+		return '~';
+	if (relative < 0.15)
+		return 'w';
+	return 'W';
+}
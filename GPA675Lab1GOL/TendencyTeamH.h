@@ -0,0 +1,59 @@
+﻿#pragma once
+#ifndef TENDENCYTEAMH_H
+#define TENDENCYTEAMH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Fichier : TendencyTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/14
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe TendencyTeamH
+//
+// Tendance du nombre de cellules vivantes sur les WINDOW_SIZE dernières
+// générations (GOL::statistics demande plus de 10 itérations).
+//
+// Les comptes sont conservés dans un tampon circulaire accompagné des sommes
+// S = Σx, T = Σi·x (i = 0 pour le plus ancien) et Q = Σx². Chaque ajout met
+// ces sommes à jour en O(1) ; la pente (régression linéaire) et la variance
+// résiduelle autour de la droite s'en déduisent directement.
+//
+// Q est un double : il est recalculé à partir du tampon à chaque tour complet
+// pour éviter l'accumulation d'erreurs d'arrondi.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class TendencyTeamH
+{
+public:
+	static constexpr size_t WINDOW_SIZE{ 16 };
+
+	TendencyTeamH();
+
+	// Vide la fenêtre et y place un premier compte.
+	void reset(size_t aliveCount);
+	void push(size_t aliveCount);
+	// Ajoute `generations` comptes d'un cycle de période `period` (chaque
+	// compte répète celui d'il y a `period` générations).
+	void repeat(size_t period, size_t generations);
+
+	size_t samples() const { return mCount; }
+
+	// Variation moyenne par génération (positive si la population croît).
+	double slope() const;
+	// Variance des comptes autour de la droite de tendance.
+	double residualVariance() const;
+	// '-' stable, '~' légèrement instable, 'w' instable, 'W' très instable.
+	char stability() const;
+
+private:
+	std::array<size_t, WINDOW_SIZE> mWindow;
+	size_t mNext, mCount;
+	int64_t mSum, mWeightedSum;
+	double mSumSquares;
+};
+
+#endif // TENDENCYTEAMH_H
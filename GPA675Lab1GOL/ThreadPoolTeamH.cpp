@@ -0,0 +1,122 @@
+﻿#include "ThreadPoolTeamH.h"
+
+#include <algorithm>
+#include <string>
+
+#include "TraceTeamH.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+ThreadPoolTeamH::ThreadPoolTeamH(size_t threadCount, bool pinned)
+	: mTask{}, mGeneration{}, mPending{}, mStopping{}, mPinned{ pinned }
+{
+	for (size_t i{}; i < threadCount; ++i) {
+		mThreads.emplace_back(&ThreadPoolTeamH::workerLoop, this, i);
+		if (pinned)
+			mPinned = pin(mThreads.back(), i) && mPinned;
+	}
+}
+
+ThreadPoolTeamH::~ThreadPoolTeamH()
+{
+	{
+		std::lock_guard lock(mMutex);
+		mStopping = true;
+	}
+	mStart.notify_all();
+
+	for (auto& thread : mThreads)
+		thread.join();
+}
+
+void ThreadPoolTeamH::run(Task const& task)
+{
+	std::unique_lock lock(mMutex);
+	mTask = &task;
+	mPending = mThreads.size();
+	mGeneration++;
+	mStart.notify_all();
+
+	mDone.wait(lock, [this] { return mPending == 0; });
+	mTask = nullptr;
+}
+
+std::pair<size_t, size_t> ThreadPoolTeamH::partition(size_t index, size_t count, size_t begin, size_t end)
+{
+	auto const total{ end > begin ? end - begin : 0 };
+	auto const base{ total / count }, extra{ total % count };
+	auto const first{ begin + index * base + std::min(index, extra) };
+	return { first, first + base + (index < extra ? 1 : 0) };
+}
+
+void ThreadPoolTeamH::workerLoop(size_t index)
+{
+	// Ne garde que le nom : le tampon de trace n'est créé qu'au premier
+	// événement et libéré à la fin du fil, même si le pool est reconstruit.
+	TraceTeamH::setThreadName("worker " + std::to_string(index));
+	uint64_t seen{};
+
+	for (;;) {
+		const Task* task;
+		{
+			std::unique_lock lock(mMutex);
+			mStart.wait(lock, [&] { return mStopping || mGeneration != seen; });
+			if (mStopping)
+				return;
+			seen = mGeneration;
+			task = mTask;
+		}
+
+		(*task)(index);
+
+		{
+			std::lock_guard lock(mMutex);
+			if (--mPending == 0)
+				mDone.notify_one();
+		}
+	}
+}
+
+// Épingle le fil `index` au index-ième coeur permis (en boucle).
+bool ThreadPoolTeamH::pin(std::thread& thread, size_t index)
+{
+#if defined(__linux__)
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+		return false;
+
+	std::vector<int> cores;
+	for (int cpu{}; cpu < CPU_SETSIZE; ++cpu)
+		if (CPU_ISSET(cpu, &allowed))
+			cores.push_back(cpu);
+	if (cores.empty())
+		return false;
+
+	cpu_set_t target;
+	CPU_ZERO(&target);
+	CPU_SET(cores[index % cores.size()], &target);
+	return pthread_setaffinity_np(thread.native_handle(), sizeof(target), &target) == 0;
+#elif defined(_WIN32)
+	DWORD_PTR processMask{}, systemMask{};
+	if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) || processMask == 0)
+		return false;
+
+	std::vector<DWORD_PTR> cores;
+	for (size_t bit{}; bit < sizeof(DWORD_PTR) * 8; ++bit)
+		if (processMask & (DWORD_PTR{ 1 } << bit))
+			cores.push_back(DWORD_PTR{ 1 } << bit);
+
+	return SetThreadAffinityMask(thread.native_handle(), cores[index % cores.size()]) != 0;
+#else
+	(void)thread;
+	(void)index;
+	return false;
+#endif
+}
@@ -0,0 +1,66 @@
+﻿#pragma once
+#ifndef THREADPOOLTEAMH_H
+#define THREADPOOLTEAMH_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fichier : ThreadPoolTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/17
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe ThreadPoolTeamH
+//
+// Fils d'exécution permanents pour le calcul parallèle d'une génération.
+// run() confie la même tâche à chaque fil (avec son indice) et attend
+// qu'ils aient tous terminé.
+//
+// Les rangées sont réparties statiquement (partition) : le fil i traite
+// toujours la même bande. Si les fils sont épinglés à un coeur, la bande
+// reste sur le même coeur d'une génération à l'autre, ce qui permet à
+// GridTeamH de placer ses pages sur le bon noeud NUMA (premier accès).
+//
+// L'épinglage utilise les coeurs permis au processus, dans l'ordre
+// (Linux et Windows) ; ailleurs, il est simplement ignoré.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class ThreadPoolTeamH
+{
+public:
+	using Task = std::function<void(size_t worker)>;
+
+	ThreadPoolTeamH(size_t threadCount, bool pinned);
+	ThreadPoolTeamH(ThreadPoolTeamH const&) = delete;
+	ThreadPoolTeamH& operator=(ThreadPoolTeamH const&) = delete;
+	~ThreadPoolTeamH();
+
+	size_t threadCount() const { return mThreads.size(); }
+	// Vrai si tous les fils ont pu être épinglés.
+	bool pinned() const { return mPinned; }
+
+	void run(Task const& task);
+
+	// Bande [first, second) de l'indice `index` parmi `count` dans [begin, end).
+	static std::pair<size_t, size_t> partition(size_t index, size_t count, size_t begin, size_t end);
+
+private:
+	std::vector<std::thread> mThreads;
+	std::mutex mMutex;
+	std::condition_variable mStart, mDone;
+	const Task* mTask;
+	uint64_t mGeneration;
+	size_t mPending;
+	bool mStopping, mPinned;
+
+	void workerLoop(size_t index);
+	static bool pin(std::thread& thread, size_t index);
+};
+
+#endif // THREADPOOLTEAMH_H
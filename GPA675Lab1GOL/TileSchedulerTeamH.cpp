@@ -0,0 +1,181 @@
+﻿#include "TileSchedulerTeamH.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "ThreadPoolTeamH.h"
+#include "TraceTeamH.h"
+
+TileSchedulerTeamH::TileSchedulerTeamH()
+	: mWidth{}, mHeight{}, mTilesX{}, mTilesY{}, mQueueCount{}
+{
+}
+
+void TileSchedulerTeamH::invalidate()
+{
+	mNextIteration.reset();
+}
+
+size_t TileSchedulerTeamH::stolenTiles() const
+{
+	size_t stolen{};
+	for (size_t i{}; i < mQueueCount; ++i)
+		stolen += mQueues[i].stolen;
+	return stolen;
+}
+
+// Une tuile inactive n'est pas recalculée. C'est correct : si ni elle ni ses
+// voisines n'ont changé entre les générations n - 1 et n, sa génération
+// n + 1 est égale à sa génération n, qui est aussi sa génération n - 1. Or
+// le tableau intermédiaire contient justement la génération n - 1. Son
+// résultat (compte et empreinte) est celui déjà conservé.
+TileSchedulerTeamH::Totals TileSchedulerTeamH::run(ThreadPoolTeamH& pool, size_t width, size_t height,
+	uint64_t iteration, Kernel const& kernel)
+{
+	resize(width, height);
+
+	auto const workers{ pool.threadCount() };
+	if (mQueueCount != workers) {
+		mQueues = std::make_unique<Queue[]>(workers);
+		mQueueCount = workers;
+	}
+	for (size_t i{}; i < mQueueCount; ++i)
+		mQueues[i].stolen = 0;
+
+	selectActive(mNextIteration == iteration);
+	distribute(workers);
+
+	pool.run([this, &kernel](size_t worker) {
+		GOLTEAMH_TRACE_SCOPE("processTiles");
+		while (auto tile{ pop(worker) })
+			execute(*tile, kernel);
+		});
+
+	mNextIteration = iteration + 1;
+
+	Totals totals{};
+	for (auto const& result : mResults) {
+		totals.aliveCount += result.aliveCount;
+		totals.hash += result.hash;
+	}
+	return totals;
+}
+
+void TileSchedulerTeamH::resize(size_t width, size_t height)
+{
+	if (width == mWidth && height == mHeight)
+		return;
+
+	mWidth = width;
+	mHeight = height;
+	mTilesX = width < 3 ? 0 : (width - 2 + TILE_SIZE - 1) / TILE_SIZE;
+	mTilesY = height < 3 ? 0 : (height - 2 + TILE_SIZE - 1) / TILE_SIZE;
+
+	// Estimation initiale : environ 1 ns par cellule.
+	mResults.assign(tileCount(), TileResult{});
+	mChanged.assign(tileCount(), 0);
+	mWeights.assign(tileCount(), static_cast<double>(TILE_SIZE * TILE_SIZE));
+	mActive.clear();
+	invalidate();
+}
+
+// Tuiles à recalculer : toutes si la génération précédente n'est pas
+// connue, sinon celles de la périphérie (la bordure peut changer à chaque
+// génération) et celles dont le voisinage 3 x 3 a changé.
+void TileSchedulerTeamH::selectActive(bool valid)
+{
+	mActive.clear();
+
+	for (size_t ty{}; ty < mTilesY; ++ty) {
+		for (size_t tx{}; tx < mTilesX; ++tx) {
+			bool active{ !valid || tx == 0 || ty == 0 || tx + 1 == mTilesX || ty + 1 == mTilesY };
+
+			for (size_t y{ ty - 1 }; !active && y != ty + 2; ++y)
+				for (size_t x{ tx - 1 }; !active && x != tx + 2; ++x)
+					active = mChanged[y * mTilesX + x] != 0;
+
+			if (active)
+				mActive.push_back(static_cast<uint32_t>(ty * mTilesX + tx));
+		}
+	}
+
+	// Les tuiles sautées ne changent pas à cette génération ; les autres
+	// seront mises à jour par execute().
+	std::fill(mChanged.begin(), mChanged.end(), uint8_t{});
+}
+
+// Répartition initiale, des tuiles les plus lourdes aux plus légères : chez
+// le fil propriétaire de la bande de la tuile tant que sa charge ne dépasse
+// pas sa part de 25 %, sinon chez le fil le moins chargé.
+void TileSchedulerTeamH::distribute(size_t workers)
+{
+	std::sort(mActive.begin(), mActive.end(),
+		[this](uint32_t a, uint32_t b) { return mWeights[a] > mWeights[b]; });
+
+	std::vector<size_t> bandEnds(workers);
+	for (size_t w{}; w < workers; ++w)
+		bandEnds[w] = ThreadPoolTeamH::partition(w, workers, 1, mHeight - 1).second;
+
+	double total{};
+	for (auto tile : mActive)
+		total += mWeights[tile];
+	auto const limit{ total / workers * 1.25 };
+
+	std::vector<double> loads(workers);
+	for (auto tile : mActive) {
+		auto const row{ 1 + tile / mTilesX * TILE_SIZE };
+		auto worker{ static_cast<size_t>(std::upper_bound(bandEnds.begin(), bandEnds.end(), row) - bandEnds.begin()) };
+		worker = std::min(worker, workers - 1);
+
+		if (loads[worker] > 0.0 && loads[worker] + mWeights[tile] > limit)
+			worker = static_cast<size_t>(std::min_element(loads.begin(), loads.end()) - loads.begin());
+
+		loads[worker] += mWeights[tile];
+		mQueues[worker].tiles.push_back(tile);
+	}
+}
+
+// Prochaine tuile du fil `worker` : l'avant de sa file, sinon l'arrière de
+// la file d'un autre fil.
+std::optional<uint32_t> TileSchedulerTeamH::pop(size_t worker)
+{
+	{
+		auto& own{ mQueues[worker] };
+		std::lock_guard lock(own.mutex);
+		if (!own.tiles.empty()) {
+			auto const tile{ own.tiles.front() };
+			own.tiles.pop_front();
+			return tile;
+		}
+	}
+
+	for (size_t k{ 1 }; k < mQueueCount; ++k) {
+		auto& victim{ mQueues[(worker + k) % mQueueCount] };
+		std::lock_guard lock(victim.mutex);
+		if (!victim.tiles.empty()) {
+			auto const tile{ victim.tiles.back() };
+			victim.tiles.pop_back();
+			mQueues[worker].stolen++;
+			return tile;
+		}
+	}
+
+	return std::nullopt;
+}
+
+void TileSchedulerTeamH::execute(uint32_t tile, Kernel const& kernel)
+{
+	using Clock = std::chrono::steady_clock;
+
+	auto const rowBegin{ 1 + tile / mTilesX * TILE_SIZE };
+	auto const columnBegin{ 1 + tile % mTilesX * TILE_SIZE };
+	auto const rowEnd{ std::min(rowBegin + TILE_SIZE, mHeight - 1) };
+	auto const columnEnd{ std::min(columnBegin + TILE_SIZE, mWidth - 1) };
+
+	auto const start{ Clock::now() };
+	mResults[tile] = kernel(rowBegin, rowEnd, columnBegin, columnEnd);
+	std::chrono::duration<double, std::nano> const elapsed{ Clock::now() - start };
+
+	mChanged[tile] = mResults[tile].changed;
+	mWeights[tile] = 0.75 * mWeights[tile] + 0.25 * elapsed.count();
+}
@@ -0,0 +1,103 @@
+﻿#pragma once
+#ifndef TILESCHEDULERTEAMH_H
+#define TILESCHEDULERTEAMH_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+class ThreadPoolTeamH;
+
+// Fichier : TileSchedulerTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/18
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe TileSchedulerTeamH
+//
+// Ordonnanceur par tuiles avec vol de travail pour le noyau intérieur.
+//
+// L'intérieur de la grille est découpé en tuiles de TILE_SIZE x TILE_SIZE
+// cellules. Une tuile n'est recalculée que si elle touche la bordure ou si
+// elle-même ou une de ses 8 voisines a changé à la génération précédente :
+// sinon, le tableau intermédiaire contient déjà son prochain état (voir
+// run). Le travail suit donc l'activité et peut être très inégal.
+//
+// Chaque fil a sa file de tuiles. Une tuile va d'abord au fil dont la bande
+// statique (ThreadPoolTeamH::partition) la contient, pour garder le
+// placement NUMA, sauf si cette file est déjà trop chargée. Le poids d'une
+// tuile est son coût mesuré récemment. Le propriétaire prend les tuiles
+// lourdes à l'avant de sa file ; un fil inoccupé vole une tuile à
+// l'arrière de celle d'un autre. ThreadPoolTeamH::run sert de barrière
+// entre les générations.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class TileSchedulerTeamH
+{
+public:
+	static constexpr size_t TILE_SIZE{ 64 };
+
+	// Résultat du noyau pour une tuile.
+	struct TileResult {
+		size_t aliveCount;
+		uint64_t hash;
+		bool changed;	// Au moins une cellule a changé d'état
+	};
+
+	// Calcule les rangées [rowBegin, rowEnd) et les colonnes
+	// [columnBegin, columnEnd) (coordonnées de la grille, bordure incluse).
+	using Kernel = std::function<TileResult(size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd)>;
+
+	struct Totals {
+		size_t aliveCount;
+		uint64_t hash;
+	};
+
+	TileSchedulerTeamH();
+	TileSchedulerTeamH(TileSchedulerTeamH const&) = delete;
+	TileSchedulerTeamH& operator=(TileSchedulerTeamH const&) = delete;
+
+	// Toutes les tuiles seront recalculées à la prochaine génération.
+	void invalidate();
+
+	// Calcule la génération `iteration` + 1 de l'intérieur d'une grille de
+	// `width` x `height` (bordure incluse). Les tuiles inactives ne sont
+	// sautées que si la génération précédente (`iteration`) a aussi été
+	// calculée ici.
+	Totals run(ThreadPoolTeamH& pool, size_t width, size_t height, uint64_t iteration, Kernel const& kernel);
+
+	size_t tileCount() const { return mTilesX * mTilesY; }
+	size_t activeTiles() const { return mActive.size(); }
+	size_t stolenTiles() const;
+
+private:
+	// File d'un fil, alignée pour éviter le faux partage.
+	struct alignas(64) Queue {
+		std::mutex mutex;
+		std::deque<uint32_t> tiles;
+		size_t stolen{};
+	};
+
+	size_t mWidth, mHeight, mTilesX, mTilesY;
+	std::optional<uint64_t> mNextIteration;
+
+	std::vector<TileResult> mResults;	// Dernier résultat de chaque tuile
+	std::vector<uint8_t> mChanged;		// Tuiles changées à la dernière génération
+	std::vector<double> mWeights;		// Coût récent (ns)
+	std::vector<uint32_t> mActive;
+	std::unique_ptr<Queue[]> mQueues;
+	size_t mQueueCount;
+
+	void resize(size_t width, size_t height);
+	void selectActive(bool valid);
+	void distribute(size_t workers);
+	std::optional<uint32_t> pop(size_t worker);
+	void execute(uint32_t tile, Kernel const& kernel);
+};
+
+#endif // TILESCHEDULERTEAMH_H
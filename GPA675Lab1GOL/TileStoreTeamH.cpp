@@ -0,0 +1,93 @@
+﻿#include "TileStoreTeamH.h"
+
+#include <bit>
+
+TileStoreTeamH::TileStoreTeamH()
+{
+	clear();
+}
+
+//! \brief Retourne l'identifiant de la tuile de ce contenu.
+//!
+//! \details La tuile est recherchée par son empreinte puis comparée mot à
+//! mot ; elle n'est copiée dans la réserve que si elle est nouvelle.
+TileStoreTeamH::Id TileStoreTeamH::intern(Tile const& tile)
+{
+	auto const key{ hash(tile) };
+	auto const [first, last] { mIndex.equal_range(key) };
+	for (auto it{ first }; it != last; ++it) {
+		if (mEntries[it->second].tile == tile) {
+			retain(it->second);
+			return it->second;
+		}
+	}
+
+	// Nouvelle tuile (la tuile vide est toujours trouvée ci-dessus).
+	uint32_t aliveCount{};
+	for (auto word : tile)
+		aliveCount += static_cast<uint32_t>(std::popcount(word));
+
+	Id id;
+	if (mFree.empty()) {
+		id = static_cast<Id>(mEntries.size());
+		mEntries.push_back(Entry{ tile, key, 1, aliveCount });
+	}
+	else {
+		id = mFree.back();
+		mFree.pop_back();
+		mEntries[id] = Entry{ tile, key, 1, aliveCount };
+	}
+
+	mIndex.emplace(key, id);
+	return id;
+}
+
+void TileStoreTeamH::retain(Id id)
+{
+	if (id != EMPTY)
+		++mEntries[id].references;
+}
+
+void TileStoreTeamH::release(Id id)
+{
+	if (id == EMPTY || --mEntries[id].references > 0)
+		return;
+
+	auto const [first, last] { mIndex.equal_range(mEntries[id].hash) };
+	for (auto it{ first }; it != last; ++it) {
+		if (it->second == id) {
+			mIndex.erase(it);
+			break;
+		}
+	}
+	mFree.push_back(id);
+}
+
+void TileStoreTeamH::clear()
+{
+	mEntries.assign(1, Entry{ Tile{}, hash(Tile{}), 0, 0 });
+	mFree.clear();
+	mIndex.clear();
+	mIndex.emplace(mEntries[EMPTY].hash, EMPTY);
+}
+
+size_t TileStoreTeamH::memoryBytes() const
+{
+	return mEntries.capacity() * sizeof(Entry) + mFree.capacity() * sizeof(Id)
+		+ mIndex.size() * (sizeof(uint64_t) + sizeof(Id) + 2 * sizeof(void*))
+		+ mIndex.bucket_count() * sizeof(void*);
+}
+
+// Mélange de type FNV-1a par mot, suivi d'un brassage final (splitmix64).
+uint64_t TileStoreTeamH::hash(Tile const& tile)
+{
+	uint64_t h{ 0xCBF29CE484222325ull };
+	for (auto word : tile)
+		h = (h ^ word) * 0x100000001B3ull;
+
+	h ^= h >> 30;
+	h *= 0xBF58476D1CE4E5B9ull;
+	h ^= h >> 27;
+	h *= 0x94D049BB133111EBull;
+	return h ^ (h >> 31);
+}
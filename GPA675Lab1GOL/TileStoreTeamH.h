@@ -0,0 +1,76 @@
+﻿#pragma once
+#ifndef TILESTORETEAMH_H
+#define TILESTORETEAMH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Fichier : TileStoreTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/03/01
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe TileStoreTeamH
+//
+// Réserve de tuiles immuables de 64 x 64 cellules compactées à 1 bit (une
+// rangée = un mot), partagées par contenu (« hash consing ») : intern()
+// retourne l'identifiant de la tuile identique déjà présente, s'il y en a
+// une, plutôt que d'en créer une copie. Une grille vide ou répétitive
+// (canons alignés, papier peint) n'occupe que ses quelques tuiles
+// distinctes.
+//
+// Les tuiles sont comptées par référence : chaque intern() et retain()
+// ajoute une référence, release() en retire une et libère la tuile à la
+// dernière. La tuile vide (EMPTY) existe toujours et n'est pas comptée.
+// Le contenu d'une tuile ne change jamais : pour modifier une cellule, on
+// interne la tuile modifiée et on libère l'ancienne.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class TileStoreTeamH
+{
+public:
+	static constexpr size_t TILE_SIZE{ 64 };
+
+	using Id = uint32_t;
+	using Tile = std::array<uint64_t, TILE_SIZE>;	// Bit x de tile[y] = cellule (x, y)
+
+	static constexpr Id EMPTY{ 0 };
+
+	TileStoreTeamH();
+
+	// Identifiant de la tuile de ce contenu, avec une référence de plus.
+	Id intern(Tile const& tile);
+	void retain(Id id);
+	void release(Id id);
+	// Libère toutes les tuiles sauf EMPTY ; les identifiants existants
+	// deviennent invalides.
+	void clear();
+
+	Tile const& tile(Id id) const { return mEntries[id].tile; }
+	// Cellules vivantes de la tuile.
+	size_t aliveCount(Id id) const { return mEntries[id].aliveCount; }
+	// Tuiles distinctes en usage (EMPTY comprise).
+	size_t uniqueTiles() const { return mEntries.size() - mFree.size(); }
+	// Mémoire occupée par les tuiles et l'index (approximative).
+	size_t memoryBytes() const;
+
+private:
+	struct Entry {
+		Tile tile;
+		uint64_t hash;
+		uint32_t references;
+		uint32_t aliveCount;
+	};
+
+	std::vector<Entry> mEntries;
+	std::vector<Id> mFree;
+	std::unordered_multimap<uint64_t, Id> mIndex;	// Empreinte -> tuiles
+
+	static uint64_t hash(Tile const& tile);
+};
+
+#endif // TILESTORETEAMH_H
@@ -0,0 +1,231 @@
+﻿#include "TraceTeamH.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> TraceTeamH::sEnabled{ false };
+
+namespace
+{
+	struct Event {
+		uint64_t timestampNs;
+		const char* name;
+		char phase;	// 'B' ou 'E'
+	};
+
+	// Tampon circulaire d'un fil. Un seul écrivain (le fil propriétaire) :
+	// la position d'écriture est publiée avec une sémantique « release ».
+	struct ThreadBuffer {
+		uint32_t tid;
+		std::string name;
+		std::array<Event, TraceTeamH::BUFFER_CAPACITY> events;
+		std::atomic<uint64_t> head{};
+		std::atomic<uint64_t> tail{};	// Début après clear()
+	};
+
+	// Événements d'un fil terminé, copiés hors de son tampon circulaire.
+	struct RetiredThread {
+		uint32_t tid;
+		std::string name;
+		std::vector<Event> events;
+	};
+
+	// Registre des tampons des fils vivants et des événements des fils
+	// terminés, gardés pour dump().
+	struct Registry {
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+		std::deque<RetiredThread> retired;
+		size_t retiredEvents{};
+		uint32_t nextTid{ 1 };
+		std::chrono::steady_clock::time_point origin{ std::chrono::steady_clock::now() };
+	};
+
+	Registry& registry()
+	{
+		static Registry instance;
+		return instance;
+	}
+
+	// État propre à un fil : son nom, même si la trace est désactivée, et son
+	// tampon, créé au premier événement. À la fin du fil, les événements
+	// sont copiés dans le registre et le tampon est libéré.
+	struct LocalThread {
+		std::string name;
+		ThreadBuffer* buffer{};
+
+		~LocalThread();
+	};
+
+	thread_local LocalThread local;
+
+	std::pair<uint64_t, uint64_t> liveRange(ThreadBuffer const& buffer)
+	{
+		auto const head{ buffer.head.load(std::memory_order_acquire) };
+		auto const start{ std::max<uint64_t>(buffer.tail.load(std::memory_order_relaxed),
+			head > TraceTeamH::BUFFER_CAPACITY ? head - TraceTeamH::BUFFER_CAPACITY : 0) };
+		return { start, head };
+	}
+
+	LocalThread::~LocalThread()
+	{
+		if (!buffer)
+			return;
+
+		auto& reg{ registry() };
+		std::lock_guard lock(reg.mutex);
+
+		auto const [start, head] { liveRange(*buffer) };
+		if (head > start) {
+			RetiredThread retired{ .tid = buffer->tid, .name = buffer->name, .events = {} };
+			retired.events.reserve(head - start);
+			for (auto i{ start }; i < head; ++i)
+				retired.events.push_back(buffer->events[i % TraceTeamH::BUFFER_CAPACITY]);
+			reg.retiredEvents += retired.events.size();
+			reg.retired.push_back(std::move(retired));
+
+			// Les fils terminés les plus anciens sont oubliés au-delà d'un
+			// tampon d'événements.
+			while (reg.retiredEvents > TraceTeamH::BUFFER_CAPACITY && reg.retired.size() > 1) {
+				reg.retiredEvents -= reg.retired.front().events.size();
+				reg.retired.pop_front();
+			}
+		}
+
+		std::erase_if(reg.buffers, [this](auto const& owned) { return owned.get() == buffer; });
+		buffer = nullptr;
+	}
+
+	ThreadBuffer& localBuffer()
+	{
+		if (!local.buffer) {
+			auto created{ std::make_unique<ThreadBuffer>() };
+			auto& reg{ registry() };
+			std::lock_guard lock(reg.mutex);
+			created->tid = reg.nextTid++;
+			created->name = local.name.empty() ? "thread " + std::to_string(created->tid) : local.name;
+			local.buffer = created.get();
+			reg.buffers.push_back(std::move(created));
+		}
+		return *local.buffer;
+	}
+
+	void writeEscaped(std::ofstream& file, std::string const& text)
+	{
+		for (char c : text) {
+			if (c == '"' || c == '\\')
+				file << '\\';
+			if (static_cast<unsigned char>(c) >= 0x20)
+				file << c;
+		}
+	}
+
+	void writeEvent(std::ofstream& file, Event const& event, uint32_t tid)
+	{
+		file << "{\"name\":\"";
+		writeEscaped(file, event.name);
+		file << "\",\"ph\":\"" << event.phase << "\",\"ts\":" << event.timestampNs / 1000 << '.'
+			<< (event.timestampNs % 1000) / 100 << (event.timestampNs % 100) / 10 << event.timestampNs % 10
+			<< ",\"pid\":1,\"tid\":" << tid << '}';
+	}
+}
+
+void TraceTeamH::begin(const char* name)
+{
+	record(name, 'B');
+}
+
+void TraceTeamH::end(const char* name)
+{
+	record(name, 'E');
+}
+
+void TraceTeamH::record(const char* name, char phase)
+{
+	auto& buffer{ localBuffer() };
+	auto const now{ std::chrono::steady_clock::now() - registry().origin };
+	auto const head{ buffer.head.load(std::memory_order_relaxed) };
+
+	buffer.events[head % BUFFER_CAPACITY] = Event{
+		.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()),
+		.name = name,
+		.phase = phase
+	};
+	buffer.head.store(head + 1, std::memory_order_release);
+}
+
+//! \brief Nomme le fil appelant dans la trace.
+//!
+//! \details Ne crée pas de tampon : le nom est repris au premier événement
+//! enregistré par ce fil. Un fil qui ne trace rien ne coûte donc que son nom.
+void TraceTeamH::setThreadName(std::string const& name)
+{
+	local.name = name;
+	if (local.buffer) {
+		std::lock_guard lock(registry().mutex);
+		local.buffer->name = name;
+	}
+}
+
+void TraceTeamH::clear()
+{
+	auto& reg{ registry() };
+	std::lock_guard lock(reg.mutex);
+	// On ne touche pas à head : l'écrivain pourrait être actif.
+	for (auto& buffer : reg.buffers)
+		buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+	reg.retired.clear();
+	reg.retiredEvents = 0;
+}
+
+bool TraceTeamH::dump(std::string const& path)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	auto& reg{ registry() };
+	std::lock_guard lock(reg.mutex);
+
+	file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first{ true };
+	auto separate = [&] {
+		if (!first)
+			file << ",\n";
+		first = false;
+		};
+
+	auto writeThreadName = [&](uint32_t tid, std::string const& name) {
+		separate();
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+			<< ",\"args\":{\"name\":\"";
+		writeEscaped(file, name);
+		file << "\"}}";
+		};
+
+	for (auto const& retired : reg.retired) {
+		writeThreadName(retired.tid, retired.name);
+		for (auto const& event : retired.events) {
+			separate();
+			writeEvent(file, event, retired.tid);
+		}
+	}
+
+	for (auto& buffer : reg.buffers) {
+		writeThreadName(buffer->tid, buffer->name);
+		auto const [start, head] { liveRange(*buffer) };
+		for (auto i{ start }; i < head; ++i) {
+			separate();
+			writeEvent(file, buffer->events[i % BUFFER_CAPACITY], buffer->tid);
+		}
+	}
+
+	file << "]}\n";
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,80 @@
+﻿#pragma once
+#ifndef TRACETEAMH_H
+#define TRACETEAMH_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Fichier : TraceTeamH.h
+// GPA675 – Laboratoire 1
+// Création :
+// - Timothée Leclaire-Fournier et Martin Euzenat
+// - 2024/02/12
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Classe TraceTeamH
+//
+// Enregistreur d'événements début/fin pour visualiser la ligne du temps de
+// la simulation et du rendu (Perfetto, chrome://tracing).
+//
+// Chaque fil écrit dans son propre tampon circulaire, sans verrou : seul
+// l'enregistrement d'un nouveau fil (une fois) prend un mutex. Le tampon
+// n'est créé qu'au premier événement du fil ; à la fin du fil, ses
+// événements sont copiés (au plus BUFFER_CAPACITY pour l'ensemble des fils
+// terminés) et il est libéré. Les noms d'événements doivent être des
+// chaînes statiques (littéraux) puisqu'on ne conserve que le pointeur.
+//
+// dump() écrit le contenu des tampons au format « Chrome Trace Event » (JSON).
+// Les événements écrasés par le tampon circulaire sont perdus ; un fil qui
+// écrit pendant dump() peut rendre ses tout derniers événements incohérents.
+// - - - - - - - - - - - - - - - - - - - - - - -
+
+class TraceTeamH
+{
+public:
+	static constexpr size_t BUFFER_CAPACITY{ 1 << 16 };	// Événements par fil
+
+	static void setEnabled(bool enabled) { sEnabled.store(enabled, std::memory_order_relaxed); }
+	static bool enabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+	static void begin(const char* name);
+	static void end(const char* name);
+
+	// Nom affiché pour le fil appelant (ex. "simulation", "UI"). N'alloue
+	// pas de tampon : peut être appelé même si la trace est désactivée.
+	static void setThreadName(std::string const& name);
+
+	static bool dump(std::string const& path);
+	static void clear();
+
+	// Événement début/fin couvrant sa portée.
+	class Scope
+	{
+	public:
+		explicit Scope(const char* name)
+			: mName{ enabled() ? name : nullptr }
+		{
+			if (mName)
+				begin(mName);
+		}
+		~Scope()
+		{
+			if (mName)
+				end(mName);
+		}
+		Scope(Scope const&) = delete;
+		Scope& operator=(Scope const&) = delete;
+
+	private:
+		const char* mName;
+	};
+
+private:
+	static std::atomic<bool> sEnabled;
+
+	static void record(const char* name, char phase);
+};
+
+#define GOLTEAMH_TRACE_SCOPE(name) TraceTeamH::Scope traceScope{ name }
+
+#endif // TRACETEAMH_H
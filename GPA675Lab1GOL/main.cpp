@@ -1,16 +1,40 @@
 #include <QtWidgets/QApplication>
 
+#include <cstdlib>
+#include <memory>
+
 #include "GOLApp.h"
+#include "FramePacerTeamH.h"
 #include "GOLTeamH.h"
+#include "InfiniteGOLTeamH.h"
+#include "LargerThanLifeTeamH.h"
+#include "SharedTileGOLTeamH.h"
 
 
 int main(int argc, char* argv[])
 {
     QApplication application(argc, argv);
     
+    // GOLTEAMH_TRACE=fichier.json : trace de la simulation et du rendu,
+    // ecrite a la fermeture (a ouvrir dans Perfetto).
+    const char* tracePath{ std::getenv("GOLTEAMH_TRACE") };
+    if (tracePath) {
+        TraceTeamH::setThreadName("UI");
+        TraceTeamH::setEnabled(true);
+    }
+
     GOLApp window;
     window.addEngine(new GOLTeamH());
+    window.addEngine(new InfiniteGOLTeamH());
+    window.addEngine(new LargerThanLifeTeamH());
+    window.addEngine(new FramePacerTeamH(std::make_unique<GOLTeamH>()));
+    window.addEngine(new SharedTileGOLTeamH());
 
     window.show();
-    return application.exec();
+    int result{ application.exec() };
+
+    if (tracePath)
+        TraceTeamH::dump(tracePath);
+
+    return result;
 }